@@ -17,9 +17,30 @@
 #   define USE_SSE 1
 #endif
 
+#if defined(__AVX__)
+#   define USE_AVX 1
+#endif
+
 #define USE_IEEE_754 1
 #define USE_ROUNDING_CONTROL 0
 
+/* Opt-in: stores the bounds of mt::BBox3<float> in two SSE registers instead of three intervals. */
+#if !defined(USE_SSE_BBOX3)
+#   define USE_SSE_BBOX3 0
+#endif
+
+/* Opt-in: packs mt::Interval<float> as (-lower, upper) in an SSE register, so that its bounds round
+   outward under mt::ScopedRoundUp. */
+#if !defined(USE_SSE_INTERVAL)
+#   define USE_SSE_INTERVAL 0
+#endif
+
+/* Opt-in: the float rotation routines in moto/Trigonometric.hpp use the polynomial approximations
+   of moto/PacketMath.hpp instead of the C library. */
+#if !defined(USE_FAST_MATH)
+#   define USE_FAST_MATH 0
+#endif
+
 #if defined(_MSC_VER)
 #   pragma warning(disable: 4800) 
 #endif 
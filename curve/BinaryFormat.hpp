@@ -0,0 +1,139 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_BINARYFORMAT_HPP
+#define CV_BINARYFORMAT_HPP
+
+#include <guts/Serialization.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace cv
+{
+    // Binary files start with the header and syntax written by guts::serialize. Arrays are stored 
+    // raw and aligned to CV_FILE_ALIGNMENT bytes relative to the start of the header, so that they 
+    // can be accessed in place from a memory-mapped file, or from any buffer in which the header 
+    // is aligned to CV_FILE_ALIGNMENT bytes. 
+    //
+    // Element counts read from a file are not trusted: readArray fails on a count that exceeds the 
+    // bytes left in the stream, rather than allocating for it.
+
+#define CV_FILE_ALIGNMENT 16
+
+    template <typename Type> size_t headerSize();
+    template <typename Type> bool checkHeader(const char*& data, const char* end);
+
+    size_t paddingSize(size_t offset);
+    bool writePadding(std::ostream& os, size_t offset);
+    bool skipPadding(std::istream& is, size_t offset);
+
+    std::streamoff remainingSize(std::istream& is);
+    template <typename Type> bool readArray(std::istream& is, std::vector<Type>& elements, uint32_t count);
+
+
+
+    template <typename Type>
+    size_t headerSize()
+    {
+        guts::SyntaxStream ss;
+        Type::syntax(ss);
+        return sizeof(guts::Serialization<Type>::sHeader) + sizeof(uint32_t) + ss.size();
+    }
+
+    template <typename Type>
+    bool checkHeader(const char*& data, const char* end)
+    {
+        guts::SyntaxStream ss;
+        Type::syntax(ss);
+
+        if (size_t(end - data) < headerSize<Type>() ||
+            std::memcmp(data, guts::Serialization<Type>::sHeader, sizeof(guts::Serialization<Type>::sHeader)) != 0)
+        {
+            return false;
+        }
+        data += sizeof(guts::Serialization<Type>::sHeader);
+
+        uint32_t size;
+        std::memcpy(&size, data, sizeof(uint32_t));
+        data += sizeof(uint32_t);
+
+        if (size != ss.size() || (size != 0 && std::memcmp(data, &ss[0], size) != 0))
+        {
+            return false;
+        }
+        data += size;
+        return true;
+    }
+
+    inline
+    size_t paddingSize(size_t offset)
+    {
+        return (CV_FILE_ALIGNMENT - offset % CV_FILE_ALIGNMENT) % CV_FILE_ALIGNMENT;
+    }
+
+    inline
+    bool writePadding(std::ostream& os, size_t offset)
+    {
+        static const char zeros[CV_FILE_ALIGNMENT] = {};
+        return !os.write(zeros, paddingSize(offset)).fail();
+    }
+
+    inline
+    bool skipPadding(std::istream& is, size_t offset)
+    {
+        char padding[CV_FILE_ALIGNMENT];
+        return !is.read(padding, paddingSize(offset)).fail();
+    }
+
+    // Returns the number of bytes from the read position to the end of the stream, or -1 if the 
+    // stream cannot seek.
+    inline
+    std::streamoff remainingSize(std::istream& is)
+    {
+        std::streampos pos = is.tellg();
+        if (pos == std::streampos(-1))
+        {
+            return -1;
+        }
+        std::streampos end = is.seekg(0, std::ios::end).tellg();
+        is.clear();
+        is.seekg(pos);
+        return end != std::streampos(-1) && !is.fail() ? std::streamoff(end - pos) : -1;
+    }
+
+    // Streams that cannot seek are read in chunks, so that a corrupt count runs into the end of the 
+    // stream before the array grows much beyond the bytes that were actually there.
+    template <typename Type>
+    bool readArray(std::istream& is, std::vector<Type>& elements, uint32_t count)
+    {
+        std::streamoff remaining = remainingSize(is);
+        if (remaining >= 0 && std::streamoff(count) > remaining / std::streamoff(sizeof(Type)))
+        {
+            return false;
+        }
+
+        const size_t CHUNK = 65536 / sizeof(Type) + 1;
+        elements.resize(0);
+        for (size_t i = 0; i != count; )
+        {
+            size_t n = std::min(size_t(count) - i, CHUNK);
+            elements.resize(i + n);
+            if (is.read(reinterpret_cast<char*>(&elements[i]), n * sizeof(Type)).fail())
+            {
+                return false;
+            }
+            i += n;
+        }
+        return true;
+    }
+}
+
+
+#endif
@@ -0,0 +1,210 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "CurveFitter.hpp"
+#include "CubicBezierSplineCurve.hpp"
+
+
+namespace cv
+{
+    namespace
+    {
+        const int MAX_ITERATIONS = 4;
+
+        Vector3 direction(const Vector3& v)
+        {
+            Scalar len2 = lengthSquared(v);
+            return len2 > Scalar() ? v * mt::rsqrt(len2) : Vector3(Zero());
+        }
+
+        Vector3 evalBezier(const Vector3* b, Scalar t)
+        {
+            Scalar s = Scalar(1) - t;
+            return b[0] * (s * s * s) + b[1] * (Scalar(3) * s * s * t) + b[2] * (Scalar(3) * s * t * t) + b[3] * (t * t * t);
+        }
+
+        Vector3 evalDerivative(const Vector3* b, Scalar t)
+        {
+            Scalar s = Scalar(1) - t;
+            return (b[1] - b[0]) * (Scalar(3) * s * s) + (b[2] - b[1]) * (Scalar(6) * s * t) + (b[3] - b[2]) * (Scalar(3) * t * t);
+        }
+
+        Vector3 evalSecondDerivative(const Vector3* b, Scalar t)
+        {
+            Scalar s = Scalar(1) - t;
+            return (b[2] - b[1] * Scalar(2) + b[0]) * (Scalar(6) * s) + (b[3] - b[2] * Scalar(2) + b[1]) * (Scalar(6) * t);
+        }
+    }
+
+    size_t CurveFitter::fit(CubicBezierSplineCurve& curve, const Vector3* points, size_t count)
+    {
+        ASSERT(count >= 2);
+
+        curve.clear();
+        curve.addPoint(points[0]);
+
+        mPoints = points;
+        mParams.resize(count);
+
+        Vector3 tangent1 = direction(points[1] - points[0]);
+        Vector3 tangent2 = direction(points[count - 2] - points[count - 1]);
+        fitRange(curve, 0, count - 1, tangent1, tangent2);
+
+        mPoints = 0;
+        return (curve.pointCount() - 1) / 3;
+    }
+
+    void CurveFitter::fitRange(CubicBezierSplineCurve& curve, size_t first, size_t last, const Vector3& tangent1, const Vector3& tangent2)
+    {
+        ASSERT(first < last);
+
+        Vector3 bezier[4];
+        size_t split = first;
+
+        if (last - first == 1)
+        {
+            Scalar dist = distance(mPoints[first], mPoints[last]) / Scalar(3);
+            bezier[1] = mPoints[first] + tangent1 * dist;
+            bezier[2] = mPoints[last] + tangent2 * dist;
+        }
+        else
+        {
+            parameterize(first, last);
+            generate(bezier, first, last, tangent1, tangent2);
+            Scalar error = maxError(bezier, first, last, split);
+
+            // Reparameterization only pays off if the fit is close already.
+            if (error > mTolerance && error <= mTolerance * Scalar(16))
+            {
+                for (int i = 0; i != MAX_ITERATIONS && error > mTolerance; ++i)
+                {
+                    reparameterize(bezier, first, last);
+                    generate(bezier, first, last, tangent1, tangent2);
+                    error = maxError(bezier, first, last, split);
+                }
+            }
+
+            if (error > mTolerance)
+            {
+                Vector3 center = direction(mPoints[split - 1] - mPoints[split + 1]);
+                fitRange(curve, first, split, tangent1, center);
+                fitRange(curve, split, last, -center, tangent2);
+                return;
+            }
+        }
+
+        curve.addPoint(bezier[1]);
+        curve.addPoint(bezier[2]);
+        curve.addPoint(mPoints[last]);
+    }
+
+    void CurveFitter::parameterize(size_t first, size_t last)
+    {
+        mParams[first] = Scalar();
+        for (size_t i = first + 1; i <= last; ++i)
+        {
+            mParams[i] = mParams[i - 1] + distance(mPoints[i], mPoints[i - 1]);
+        }
+
+        Scalar total = mParams[last];
+        for (size_t i = first + 1; i <= last; ++i)
+        {
+            mParams[i] = total > Scalar() ? mParams[i] / total : Scalar(i - first) / Scalar(last - first);
+        }
+    }
+
+    void CurveFitter::reparameterize(const Vector3* bezier, size_t first, size_t last)
+    {
+        // One Newton-Raphson step towards the closest point on the segment 
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            Scalar t = mParams[i];
+            Vector3 d = evalBezier(bezier, t) - mPoints[i];
+            Vector3 d1 = evalDerivative(bezier, t);
+            Vector3 d2 = evalSecondDerivative(bezier, t);
+            Scalar denom = dot(d1, d1) + dot(d, d2);
+            if (denom > Scalar())
+            {
+                mParams[i] = mt::clamp(t - dot(d, d1) / denom, Scalar(), Scalar(1));
+            }
+        }
+    }
+
+    void CurveFitter::generate(Vector3* bezier, size_t first, size_t last, const Vector3& tangent1, const Vector3& tangent2) const
+    {
+        const Vector3& p0 = mPoints[first];
+        const Vector3& p3 = mPoints[last];
+
+        // Least-squares solution for the distances of the inner control points along the end tangents
+        Scalar c00 = Scalar(), c01 = Scalar(), c11 = Scalar();
+        Scalar x0 = Scalar(), x1 = Scalar();
+
+        for (size_t i = first; i <= last; ++i)
+        {
+            Scalar t = mParams[i];
+            Scalar s = Scalar(1) - t;
+            Scalar b0 = s * s * s;
+            Scalar b1 = Scalar(3) * s * s * t;
+            Scalar b2 = Scalar(3) * s * t * t;
+            Scalar b3 = t * t * t;
+
+            Vector3 a1 = tangent1 * b1;
+            Vector3 a2 = tangent2 * b2;
+            Vector3 r = mPoints[i] - (p0 * (b0 + b1) + p3 * (b2 + b3));
+
+            c00 += dot(a1, a1);
+            c01 += dot(a1, a2);
+            c11 += dot(a2, a2);
+            x0 += dot(a1, r);
+            x1 += dot(a2, r);
+        }
+
+        Scalar chord = distance(p0, p3);
+        Scalar epsilon = chord * Scalar(1e-6);
+        Scalar det = c00 * c11 - c01 * c01;
+
+        Scalar alpha1 = chord / Scalar(3);
+        Scalar alpha2 = alpha1;
+
+        if (mt::abs(det) > ScalarTraits::epsilon() * c00 * c11)
+        {
+            Scalar a1 = (x0 * c11 - x1 * c01) / det;
+            Scalar a2 = (c00 * x1 - c01 * x0) / det;
+
+            // Negative or vanishing distances flip or collapse the tangents, so fall back to the heuristic.
+            if (a1 > epsilon && a2 > epsilon)
+            {
+                alpha1 = a1;
+                alpha2 = a2;
+            }
+        }
+
+        bezier[0] = p0;
+        bezier[1] = p0 + tangent1 * alpha1;
+        bezier[2] = p3 + tangent2 * alpha2;
+        bezier[3] = p3;
+    }
+
+    Scalar CurveFitter::maxError(const Vector3* bezier, size_t first, size_t last, size_t& split) const
+    {
+        Scalar result = Scalar();
+        split = (first + last) / 2;
+
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            Scalar dist2 = distanceSquared(evalBezier(bezier, mParams[i]), mPoints[i]);
+            if (result < dist2)
+            {
+                result = dist2;
+                split = i;
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,53 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_CURVEFITTER_HPP
+#define CV_CURVEFITTER_HPP
+
+#include "Types.hpp"
+
+#include <vector>
+
+namespace cv
+{
+    class CubicBezierSplineCurve;
+
+    // Fits a cubic Bezier spline through a dense sequence of points, such that no point is 
+    // further than the tolerance from the spline. Each segment is a least-squares fit with 
+    // tangent-continuous joints. Segments that exceed the tolerance are split at the point 
+    // with the largest error.
+
+    class CurveFitter
+    {
+    public:
+        CurveFitter(Scalar tolerance = Scalar(1))
+        {
+            setTolerance(tolerance);
+        }
+
+        Scalar tolerance() const { return sqrt(mTolerance); }
+        void setTolerance(Scalar tolerance) { mTolerance = tolerance * tolerance; }
+
+        // Replaces the control points of the curve. Returns the number of segments. 
+        size_t fit(CubicBezierSplineCurve& curve, const Vector3* points, size_t count);
+
+    private:
+        void fitRange(CubicBezierSplineCurve& curve, size_t first, size_t last, const Vector3& tangent1, const Vector3& tangent2);
+        void parameterize(size_t first, size_t last);
+        void reparameterize(const Vector3* bezier, size_t first, size_t last);
+        void generate(Vector3* bezier, size_t first, size_t last, const Vector3& tangent1, const Vector3& tangent2) const;
+        Scalar maxError(const Vector3* bezier, size_t first, size_t last, size_t& split) const;
+
+        Scalar mTolerance;
+        const Vector3* mPoints;
+        std::vector<Scalar> mParams;
+    };
+}
+
+
+#endif
@@ -0,0 +1,46 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_DUALQUATERNIONBSPLINECURVE_HPP
+#define CV_DUALQUATERNIONBSPLINECURVE_HPP
+
+#include "Types.hpp"
+
+#include <vector>
+
+namespace cv
+{
+    // Cumulative uniform cubic B-spline on unit dual quaternions, for interpolating rigid motions. 
+    // This is the dual-number counterpart of QuaternionBSplineCurve: it uses the logUnit and exp 
+    // of DualVector4.hpp, so the rotational part follows the quaternion B-spline and the translation 
+    // is blended along with it. The curve is C2 continuous. The array form of eval evaluates a packet 
+    // of parameters at a time.
+
+    class DualQuaternionBSplineCurve
+    {
+    public:
+        void addKey(const DualQuaternion& key);
+        void clear();
+
+        size_t keyCount() const { return mKeys.size(); }
+
+        const DualQuaternion& key(size_t index) const { return mKeys[index]; }
+
+        DualQuaternion eval(Scalar param) const;
+        void eval(const Scalar* params, DualQuaternion* result, size_t count) const;
+
+    private:
+        Scalar segment(Scalar param, int& index) const;
+
+        std::vector<DualQuaternion> mKeys;
+        std::vector<DualVector3> mLogs;
+    };
+}
+
+
+#endif
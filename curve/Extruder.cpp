@@ -8,6 +8,7 @@
 
 #include "Extruder.hpp"
 #include "Curve.hpp"
+#include "BinaryFormat.hpp"
 
 
 
@@ -98,6 +99,47 @@ namespace cv
         mSamples.push_back(sample);
     }
 
+    void Extruder::decimate(const Extruder& source)
+    {
+        ASSERT(this != &source);
+
+        mSamples.resize(0);
+        if (source.mSamples.empty())
+        {
+            return;
+        }
+
+        const std::vector<Sample>& samples = source.mSamples;
+        size_t anchor = 0;
+        mSamples.push_back(samples[anchor]);
+
+        for (size_t i = 2; i < samples.size(); ++i)
+        {
+            Vector3 from = xyz(column(samples[anchor].xform, 3));
+            Vector3 to = xyz(column(samples[i].xform, 3));
+            Scalar dist2 = lengthSquared(to - from);
+
+            // Check whether the samples in between are within tolerance of the chord from anchor to i.
+            for (size_t j = anchor + 1; j != i; ++j)
+            {
+                Vector3 mid = xyz(column(samples[j].xform, 3));
+                Vector3 l = from - mid;
+                Vector3 r = to - mid;
+                if (lengthSquared(cross(l, r)) > dist2 * mTolerance || dot(l, r) > Scalar()) 
+                {
+                    anchor = i - 1;
+                    mSamples.push_back(samples[anchor]);
+                    break;
+                }
+            }
+        }
+
+        if (samples.size() > 1)
+        {
+            mSamples.push_back(samples.back());
+        }
+    }
+
     bool Extruder::hasLoop() const
     {
         ASSERT(!mSamples.empty());
@@ -134,4 +176,56 @@ namespace cv
 
         return false;
     }
+
+    void Extruder::syntax(guts::SyntaxStream& ss)
+    {
+        guts::addStruct(ss, 2);
+        guts::addPrimType(ss, guts::TypeTraits<Scalar>::ID);
+        guts::addArray(ss);
+        guts::addStruct(ss, 2);
+        guts::addPrimType(ss, guts::TypeTraits<Matrix4x4>::ID);
+        guts::addPrimType(ss, guts::TypeTraits<Scalar>::ID);
+    }
+
+    // The tolerance is stored as passed to setTolerance, not squared. Samples are stored with the layout 
+    // of Sample, so that TessellationView can use them in place, but with the padding zeroed rather 
+    // than copied from memory.
+    bool Extruder::serialize(std::ostream& os) const
+    {
+        Scalar tol = tolerance();
+        uint32_t count = uint32_t(mSamples.size());
+        if (!guts::write(os, tol) || !guts::write(os, count) ||
+            !writePadding(os, headerSize<Extruder>() + sizeof(Scalar) + sizeof(uint32_t)))
+        {
+            return false;
+        }
+
+        char record[sizeof(Sample)] = {};
+        for (uint32_t i = 0; i != count; ++i)
+        {
+            const Sample& sample = mSamples[i];
+            ASSERT(reinterpret_cast<const char*>(&sample.arcLength) - reinterpret_cast<const char*>(&sample) == sizeof(Matrix4x4));
+            std::memcpy(record, &sample.xform, sizeof(Matrix4x4));
+            std::memcpy(record + sizeof(Matrix4x4), &sample.arcLength, sizeof(Scalar));
+            if (os.write(record, sizeof(Sample)).fail())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Extruder::deserialize(std::istream& is)
+    {
+        Scalar tol;
+        uint32_t count;
+        if (!guts::read(is, tol) || !guts::read(is, count) ||
+            !skipPadding(is, headerSize<Extruder>() + sizeof(Scalar) + sizeof(uint32_t)))
+        {
+            return false;
+        }
+
+        setTolerance(tol);
+        return readArray(is, mSamples, count);
+    }
 }
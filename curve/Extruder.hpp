@@ -11,7 +11,10 @@
 
 #include "Types.hpp"
 
+#include <guts/Syntax.hpp>
+
 #include <vector>
+#include <iosfwd>
 
 namespace cv
 {
@@ -36,6 +39,9 @@ namespace cv
 
         Scalar tesselate(const Curve& curve);
 
+        // Keeps the subset of the samples of a finer tessellation that is needed to stay within tolerance.
+        void decimate(const Extruder& source);
+
         size_t sampleCount() const { return mSamples.size(); }
 
         const Sample& sample(size_t index) const { return mSamples[index]; } 
@@ -43,6 +49,10 @@ namespace cv
         bool hasLoop() const;
         bool fixLoop();
 
+        static void syntax(guts::SyntaxStream& ss);
+        bool serialize(std::ostream& os) const;
+        bool deserialize(std::istream& is);
+
     private:
         void auxTesselate(const Curve& curve, const DualVector3& from, Scalar fromParam, const DualVector3& to, Scalar toParam, Scalar dist2, Scalar& arcLength);
 
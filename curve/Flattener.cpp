@@ -0,0 +1,106 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "Flattener.hpp"
+
+
+namespace cv
+{
+    namespace
+    {
+        // A curve with second derivative bounded by dd deviates at most dd * h^2 / 8 from 
+        // the chord over a parameter interval of width h.
+        int segmentCount(Scalar dd, Scalar tolerance)
+        {
+            ASSERT(tolerance > Scalar());
+            return mt::max(int(ceil(sqrt(dd / (Scalar(8) * tolerance)))), 1);
+        }
+    }
+
+    int Flattener::quadraticSegmentCount(const Vector2& p0, const Vector2& p1, const Vector2& p2, Scalar tolerance)
+    {
+        return segmentCount(Scalar(2) * length(p0 - p1 * Scalar(2) + p2), tolerance);
+    }
+
+    int Flattener::cubicSegmentCount(const Vector2& p0, const Vector2& p1, const Vector2& p2, const Vector2& p3, Scalar tolerance)
+    {
+        // The second derivative is linear in t, so its norm is maximal at one of the end points.
+        Scalar dd0 = lengthSquared(p0 - p1 * Scalar(2) + p2);
+        Scalar dd1 = lengthSquared(p1 - p2 * Scalar(2) + p3);
+        return segmentCount(Scalar(6) * sqrt(mt::max(dd0, dd1)), tolerance);
+    }
+
+    void Flattener::moveTo(const Vector2& point)
+    {
+        mContourOffsets.push_back(mPoints.size());
+        mPoints.push_back(point);
+    }
+
+    size_t Flattener::contourPointCount(size_t index) const
+    {
+        ASSERT(index < mContourOffsets.size());
+        size_t end = index + 1 != mContourOffsets.size() ? mContourOffsets[index + 1] : mPoints.size();
+        return end - mContourOffsets[index];
+    }
+
+    void Flattener::lineTo(const Vector2& point)
+    {
+        ASSERT(!mPoints.empty());
+        mPoints.push_back(point);
+    }
+
+    void Flattener::quadraticTo(const Vector2& control, const Vector2& point)
+    {
+        ASSERT(!mPoints.empty());
+
+        Vector2 p0 = mPoints.back();
+        int n = quadraticSegmentCount(p0, control, point, mTolerance);
+
+        // Power basis: p0 + b * t + a * t^2
+        Vector2 a = p0 - control * Scalar(2) + point;
+        Vector2 b = (control - p0) * Scalar(2);
+        Scalar h = Scalar(1) / Scalar(n);
+
+        size_t offset = mPoints.size();
+        mPoints.resize(offset + n);
+        Vector2* RESTRICT out = &mPoints[offset];
+
+        // Every point is evaluated independently from the others, so that the loop can be vectorized.
+        for (int i = 0; i != n - 1; ++i)
+        {
+            Scalar t = Scalar(i + 1) * h;
+            out[i] = p0 + (b + a * t) * t;
+        }
+        out[n - 1] = point;
+    }
+
+    void Flattener::cubicTo(const Vector2& control1, const Vector2& control2, const Vector2& point)
+    {
+        ASSERT(!mPoints.empty());
+
+        Vector2 p0 = mPoints.back();
+        int n = cubicSegmentCount(p0, control1, control2, point, mTolerance);
+
+        // Power basis: p0 + c * t + b * t^2 + a * t^3
+        Vector2 a = point - p0 + (control1 - control2) * Scalar(3);
+        Vector2 b = (p0 - control1 * Scalar(2) + control2) * Scalar(3);
+        Vector2 c = (control1 - p0) * Scalar(3);
+        Scalar h = Scalar(1) / Scalar(n);
+
+        size_t offset = mPoints.size();
+        mPoints.resize(offset + n);
+        Vector2* RESTRICT out = &mPoints[offset];
+
+        for (int i = 0; i != n - 1; ++i)
+        {
+            Scalar t = Scalar(i + 1) * h;
+            out[i] = p0 + (c + (b + a * t) * t) * t;
+        }
+        out[n - 1] = point;
+    }
+}
@@ -0,0 +1,63 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_FLATTENER_HPP
+#define CV_FLATTENER_HPP
+
+#include "Types.hpp"
+
+#include <vector>
+
+namespace cv
+{
+    // Flattens 2D quadratic and cubic Bezier curves, as found in glyph outlines and vector graphics, 
+    // into polylines. The number of segments is computed up front from a bound on the second derivative, 
+    // so that no point of the curve is further than the tolerance from the polyline. The points of all 
+    // contours are stored one after the other, and contourOffset gives the index of the first point of a 
+    // contour. 
+
+    class Flattener
+    {
+    public:
+        Flattener(Scalar tolerance = Scalar(1))
+        {
+            setTolerance(tolerance);
+        }
+
+        Scalar tolerance() const { return mTolerance; }
+        void setTolerance(Scalar tolerance) { ASSERT(tolerance > Scalar()); mTolerance = tolerance; }
+
+        static int quadraticSegmentCount(const Vector2& p0, const Vector2& p1, const Vector2& p2, Scalar tolerance);
+        static int cubicSegmentCount(const Vector2& p0, const Vector2& p1, const Vector2& p2, const Vector2& p3, Scalar tolerance);
+
+        // Starts a new contour at the given point.
+        void moveTo(const Vector2& point);
+        void lineTo(const Vector2& point);
+        void quadraticTo(const Vector2& control, const Vector2& point);
+        void cubicTo(const Vector2& control1, const Vector2& control2, const Vector2& point);
+        
+        void clear() { mPoints.resize(0); mContourOffsets.resize(0); }
+
+        size_t pointCount() const { return mPoints.size(); }
+
+        const Vector2& point(size_t index) const { return mPoints[index]; } 
+
+        size_t contourCount() const { return mContourOffsets.size(); }
+
+        size_t contourOffset(size_t index) const { return mContourOffsets[index]; }
+        size_t contourPointCount(size_t index) const;
+
+    private:
+        Scalar mTolerance;
+        std::vector<Vector2> mPoints;
+        std::vector<size_t> mContourOffsets;
+    };
+}
+
+
+#endif
@@ -0,0 +1,103 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+namespace cv
+{
+#ifdef _WIN32
+
+    bool MappedFile::open(const char* path)
+    {
+        close();
+
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart != 0 ? CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0) : 0;
+        CloseHandle(file);
+        if (mapping == 0)
+        {
+            return false;
+        }
+
+        mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (mData == 0)
+        {
+            CloseHandle(mapping);
+            return false;
+        }
+
+        mSize = size_t(size.QuadPart);
+        mHandle = mapping;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData != 0)
+        {
+            UnmapViewOfFile(mData);
+            CloseHandle(mHandle);
+            mData = 0;
+            mSize = 0;
+            mHandle = 0;
+        }
+    }
+
+#else
+
+    bool MappedFile::open(const char* path)
+    {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd == -1)
+        {
+            return false;
+        }
+
+        struct stat st;
+        void* data = fstat(fd, &st) == 0 && st.st_size != 0 ? mmap(0, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        mData = data;
+        mSize = size_t(st.st_size);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (mData != 0)
+        {
+            munmap(mData, mSize);
+            mData = 0;
+            mSize = 0;
+        }
+    }
+
+#endif
+}
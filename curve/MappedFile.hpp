@@ -0,0 +1,50 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_MAPPEDFILE_HPP
+#define CV_MAPPEDFILE_HPP
+
+#include <consolid/consolid.h>
+
+#include <cstddef>
+
+namespace cv
+{
+    // Read-only memory mapping of a file. The mapping is page aligned.
+
+    class MappedFile
+    {
+    public:
+        MappedFile()
+            : mData(0)
+            , mSize(0)
+            , mHandle(0)
+        {}
+
+        ~MappedFile() { close(); }
+
+        bool open(const char* path);
+        void close();
+
+        bool isOpen() const { return mData != 0; }
+
+        const void* data() const { return mData; }
+        size_t size() const { return mSize; }
+
+    private:
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+        void* mData;
+        size_t mSize;
+        void* mHandle;
+    };
+}
+
+
+#endif
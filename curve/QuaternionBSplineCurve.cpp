@@ -0,0 +1,114 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "QuaternionBSplineCurve.hpp"
+
+
+namespace cv
+{
+    namespace
+    {
+        // Cumulative basis functions of the uniform cubic B-spline, for Scalar and Lanes
+        template <typename Real>
+        void basis(const Real& t, Real b[3])
+        {
+            Real t2 = t * t;
+            Real t3 = t2 * t;
+            b[0] = (Real(Scalar(5)) + Real(Scalar(3)) * t - Real(Scalar(3)) * t2 + t3) / Real(Scalar(6));
+            b[1] = (Real(Scalar(1)) + Real(Scalar(3)) * t + Real(Scalar(3)) * t2 - Real(Scalar(2)) * t3) / Real(Scalar(6));
+            b[2] = t3 / Real(Scalar(6));
+        }
+    }
+
+    void QuaternionBSplineCurve::addKey(const Quaternion& key)
+    {
+        if (mKeys.empty())
+        {
+            mKeys.push_back(key);
+            mLogs.push_back(Vector3(Zero()));
+        }
+        else
+        {
+            // Take the shortest arc from the previous key.
+            mKeys.push_back(dot(mKeys.back(), key) < Scalar() ? -key : key);
+            mLogs.push_back(logUnit(mul(conjugate(mKeys[mKeys.size() - 2]), mKeys.back())));
+        }
+    }
+
+    void QuaternionBSplineCurve::clear()
+    {
+        mKeys.resize(0);
+        mLogs.resize(0);
+    }
+
+    Scalar QuaternionBSplineCurve::segment(Scalar param, int& index) const
+    {
+        ASSERT(Scalar() <= param && param <= Scalar(1));
+        ASSERT(mKeys.size() >= 4);
+
+        Scalar h = Scalar(mKeys.size() - 3);
+
+        Scalar intg;
+        Scalar frac = mt::modf(param * h, &intg);
+        index = int(intg);
+        if (index + 3 == int(mKeys.size()))
+        {
+            frac += Scalar(1);
+            --index;
+        }
+
+        ASSERT(Scalar() <= frac && frac <= Scalar(1));
+        ASSERT(0 <= index && index + 3 < int(mKeys.size()));
+        return frac;
+    }
+
+    Quaternion QuaternionBSplineCurve::eval(Scalar param) const
+    {
+        int index;
+        Scalar frac = segment(param, index);
+
+        Scalar b[3];
+        basis(frac, b);
+
+        const Vector3* logs = &mLogs[index];
+
+        return mul(mul(mul(mKeys[index], exp(logs[1] * b[0])), exp(logs[2] * b[1])), exp(logs[3] * b[2]));
+    }
+
+    void QuaternionBSplineCurve::eval(const Scalar* params, Quaternion* result, size_t count) const
+    {
+        for (size_t i = 0; i < count; i += Lanes::SIZE)
+        {
+            // Lanes past the end repeat the last parameter.
+            Lanes t;
+            mt::Vector4<Lanes> q;
+            mt::Vector3<Lanes> logs[3];
+            for (int k = 0; k != Lanes::SIZE; ++k)
+            {
+                int index;
+                t[k] = segment(params[mt::min(i + k, count - 1)], index);
+                insertLane(q, k, mKeys[index]);
+                for (int j = 0; j != 3; ++j)
+                {
+                    insertLane(logs[j], k, mLogs[index + j + 1]);
+                }
+            }
+
+            Lanes b[3];
+            basis(t, b);
+            for (int j = 0; j != 3; ++j)
+            {
+                q = mul(q, exp(logs[j] * b[j]));
+            }
+            for (int k = 0; k != Lanes::SIZE && i + k < count; ++k)
+            {
+                result[i + k] = extractLane(q, k);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_QUATERNIONBSPLINECURVE_HPP
+#define CV_QUATERNIONBSPLINECURVE_HPP
+
+#include "Types.hpp"
+
+#include <vector>
+
+namespace cv
+{
+    // Cumulative uniform cubic B-spline on unit quaternions (Kim, Kim & Shin 1995). The curve is C2 
+    // continuous and approximates the keys rather than passing through them. The logarithms of the 
+    // relative rotations between successive keys are computed as keys are added, so evaluation 
+    // takes three exponentials per sample. The array form of eval evaluates a packet of parameters at a time.
+
+    class QuaternionBSplineCurve
+    {
+    public:
+        void addKey(const Quaternion& key);
+        void clear();
+
+        size_t keyCount() const { return mKeys.size(); }
+
+        const Quaternion& key(size_t index) const { return mKeys[index]; }
+
+        Quaternion eval(Scalar param) const;
+        void eval(const Scalar* params, Quaternion* result, size_t count) const;
+
+    private:
+        Scalar segment(Scalar param, int& index) const;
+
+        std::vector<Quaternion> mKeys;
+        std::vector<Vector3> mLogs;
+    };
+}
+
+
+#endif
@@ -7,6 +7,7 @@
 */
 
 #include "SplineCurve.hpp"
+#include "BinaryFormat.hpp"
 
 
 namespace cv
@@ -15,4 +16,35 @@ namespace cv
     {
         mPoints.push_back(point); 
     }
+
+    void SplineCurve::clear()
+    {
+        mPoints.resize(0); 
+    }
+
+    void SplineCurve::syntax(guts::SyntaxStream& ss)
+    {
+        guts::addStruct(ss, 1);
+        guts::addArray(ss);
+        guts::addPrimType(ss, guts::TypeTraits<Vector3>::ID);
+    }
+
+    bool SplineCurve::serialize(std::ostream& os) const
+    {
+        uint32_t count = uint32_t(mPoints.size());
+        return guts::write(os, count) &&
+               writePadding(os, headerSize<SplineCurve>() + sizeof(uint32_t)) &&
+               (count == 0 || !os.write(reinterpret_cast<const char*>(&mPoints[0]), count * sizeof(Vector3)).fail());
+    }
+
+    bool SplineCurve::deserialize(std::istream& is)
+    {
+        uint32_t count;
+        if (!guts::read(is, count) || !skipPadding(is, headerSize<SplineCurve>() + sizeof(uint32_t)))
+        {
+            return false;
+        }
+
+        return readArray(is, mPoints, count);
+    }
 }
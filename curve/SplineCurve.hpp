@@ -11,7 +11,10 @@
 
 #include "Curve.hpp"
 
+#include <guts/Syntax.hpp>
+
 #include <vector>
+#include <iosfwd>
 
 namespace cv
 {
@@ -21,6 +24,15 @@ namespace cv
     public:
       
         void addPoint(const Vector3& point);
+        void clear();
+
+        size_t pointCount() const { return mPoints.size(); }
+
+        const Vector3& point(size_t index) const { return mPoints[index]; }
+
+        static void syntax(guts::SyntaxStream& ss);
+        bool serialize(std::ostream& os) const;
+        bool deserialize(std::istream& is);
  
 	protected: 
         std::vector<Vector3> mPoints;
@@ -0,0 +1,46 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "SplineCurveView.hpp"
+#include "BinaryFormat.hpp"
+
+
+namespace cv
+{
+    bool SplineCurveView::map(const void* data, size_t size)
+    {
+        const char* begin = static_cast<const char*>(data);
+        const char* end = begin + size;
+        const char* ptr = begin;
+
+        mPoints = 0;
+        mPointCount = 0;
+
+        // The arrays are aligned relative to the header, so the header itself must be aligned.
+        if (reinterpret_cast<uintptr_t>(begin) % CV_FILE_ALIGNMENT != 0 || 
+            !checkHeader<SplineCurve>(ptr, end) || size_t(end - ptr) < sizeof(uint32_t))
+        {
+            return false;
+        }
+
+        uint32_t count;
+        std::memcpy(&count, ptr, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+
+        size_t padding = paddingSize(ptr - begin);
+        if (size_t(end - ptr) < padding || size_t(end - ptr - padding) / sizeof(Vector3) < count)
+        {
+            return false;
+        }
+        ptr += padding;
+
+        mPoints = reinterpret_cast<const Vector3*>(ptr);
+        mPointCount = count;
+        return true;
+    }
+}
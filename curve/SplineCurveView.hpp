@@ -0,0 +1,41 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_SPLINECURVEVIEW_HPP
+#define CV_SPLINECURVEVIEW_HPP
+
+#include "SplineCurve.hpp"
+
+namespace cv
+{
+    // Zero-copy view on the control points of a spline curve written by guts::serialize, e.g. in 
+    // a memory-mapped file. The memory must be aligned to CV_FILE_ALIGNMENT bytes and remain 
+    // valid for as long as the view is used.
+
+    class SplineCurveView
+    {
+    public:
+        SplineCurveView()
+            : mPoints(0)
+            , mPointCount(0)
+        {}
+
+        bool map(const void* data, size_t size);
+
+        size_t pointCount() const { return mPointCount; }
+
+        const Vector3& point(size_t index) const { ASSERT(index < mPointCount); return mPoints[index]; }
+
+    private:
+        const Vector3* mPoints;
+        size_t mPointCount;
+    };
+}
+
+
+#endif
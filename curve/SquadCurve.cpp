@@ -0,0 +1,114 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "SquadCurve.hpp"
+
+
+namespace cv
+{
+    namespace
+    {
+        // Slerp along the arc from q0 to q1 as given, without taking the shortest arc, since the inner 
+        // quaternions of SQUAD need not lie in the hemisphere of the keys. The cosine is clamped, so that 
+        // rounding cannot push it out of the domain of acos, and below an angle of 1e-4 the weights are 
+        // 1 - t and t up to rounding. This is generic over Scalar and Lanes.
+        template <typename Real>
+        mt::Vector4<Real> slerpArc(const mt::Vector4<Real>& q0, const mt::Vector4<Real>& q1, const Real& t)
+        {
+            Real theta = mt::acos(mt::min(mt::max(dot(q0, q1), Real(Scalar(-1))), Real(Scalar(1))));
+            Real one(Scalar(1));
+            Real threshold(Scalar(1e-4));
+            Real s = mt::select(theta < threshold, one, mt::sin(theta));
+            Real w0 = mt::select(theta < threshold, one - t, mt::sin((one - t) * theta) / s);
+            Real w1 = mt::select(theta < threshold, t, mt::sin(t * theta) / s);
+            return q0 * w0 + q1 * w1;
+        }
+
+        template <typename Real>
+        mt::Vector4<Real> squad(const mt::Vector4<Real>& q0, const mt::Vector4<Real>& s0, const mt::Vector4<Real>& s1, 
+                                const mt::Vector4<Real>& q1, const Real& t)
+        {
+            return slerpArc(slerpArc(q0, q1, t), slerpArc(s0, s1, t), Real(Scalar(2)) * t * (Real(Scalar(1)) - t));
+        }
+    }
+
+    void SquadCurve::addKey(const Quaternion& key)
+    {
+        // Take the shortest arc from the previous key.
+        mKeys.push_back(!mKeys.empty() && dot(mKeys.back(), key) < Scalar() ? -key : key);
+        mInner.push_back(mKeys.back());
+
+        size_t n = mKeys.size();
+        if (n >= 3)
+        {
+            const Quaternion& q = mKeys[n - 2];
+            Quaternion qinv = conjugate(q);
+            Vector3 v = logUnit(mul(qinv, mKeys[n - 1])) + logUnit(mul(qinv, mKeys[n - 3]));
+            mInner[n - 2] = mul(q, exp(v * Scalar(-0.25)));
+        }
+    }
+
+    void SquadCurve::clear()
+    {
+        mKeys.resize(0);
+        mInner.resize(0);
+    }
+
+    Scalar SquadCurve::segment(Scalar param, int& index) const
+    {
+        ASSERT(Scalar() <= param && param <= Scalar(1));
+        ASSERT(mKeys.size() >= 2);
+
+        Scalar h = Scalar(mKeys.size() - 1);
+
+        Scalar intg;
+        Scalar frac = mt::modf(param * h, &intg);
+        index = int(intg);
+        if (index + 1 == int(mKeys.size()))
+        {
+            frac += Scalar(1);
+            --index;
+        }
+
+        ASSERT(Scalar() <= frac && frac <= Scalar(1));
+        ASSERT(0 <= index && index + 1 < int(mKeys.size()));
+        return frac;
+    }
+
+    Quaternion SquadCurve::eval(Scalar param) const
+    {
+        int index;
+        Scalar frac = segment(param, index);
+        return squad(mKeys[index], mInner[index], mInner[index + 1], mKeys[index + 1], frac);
+    }
+
+    void SquadCurve::eval(const Scalar* params, Quaternion* result, size_t count) const
+    {
+        for (size_t i = 0; i < count; i += Lanes::SIZE)
+        {
+            // Lanes past the end repeat the last parameter.
+            Lanes t;
+            mt::Vector4<Lanes> q0, s0, s1, q1;
+            for (int k = 0; k != Lanes::SIZE; ++k)
+            {
+                int index;
+                t[k] = segment(params[mt::min(i + k, count - 1)], index);
+                insertLane(q0, k, mKeys[index]);
+                insertLane(s0, k, mInner[index]);
+                insertLane(s1, k, mInner[index + 1]);
+                insertLane(q1, k, mKeys[index + 1]);
+            }
+
+            mt::Vector4<Lanes> q = squad(q0, s0, s1, q1, t);
+            for (int k = 0; k != Lanes::SIZE && i + k < count; ++k)
+            {
+                result[i + k] = extractLane(q, k);
+            }
+        }
+    }
+}
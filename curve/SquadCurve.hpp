@@ -0,0 +1,44 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_SQUADCURVE_HPP
+#define CV_SQUADCURVE_HPP
+
+#include "Types.hpp"
+
+#include <vector>
+
+namespace cv
+{
+    // Spherical quadrangle interpolation of unit quaternions. The curve passes through the keys 
+    // and is C1 continuous. The inner control quaternions are computed as keys are added, so
+    // evaluation takes constant time. The array form of eval evaluates a packet of parameters at a time.
+
+    class SquadCurve
+    {
+    public:
+        void addKey(const Quaternion& key);
+        void clear();
+
+        size_t keyCount() const { return mKeys.size(); }
+
+        const Quaternion& key(size_t index) const { return mKeys[index]; }
+
+        Quaternion eval(Scalar param) const;
+        void eval(const Scalar* params, Quaternion* result, size_t count) const;
+
+    private:
+        Scalar segment(Scalar param, int& index) const;
+
+        std::vector<Quaternion> mKeys;
+        std::vector<Quaternion> mInner;
+    };
+}
+
+
+#endif
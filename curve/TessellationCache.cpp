@@ -0,0 +1,113 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "TessellationCache.hpp"
+
+#include <algorithm>
+
+
+namespace cv
+{
+    void TessellationCache::setLevels(const Scalar* tolerances, size_t count)
+    {
+        ASSERT(count != 0);
+
+        clear();
+        mLevels.assign(tolerances, tolerances + count);
+        std::sort(mLevels.begin(), mLevels.end());
+    }
+
+    const Extruder& TessellationCache::tessellation(const Curve& curve, Scalar tolerance)
+    {
+        ASSERT(!mLevels.empty());
+
+        // Coarsest level that is within tolerance
+        size_t index = std::upper_bound(mLevels.begin(), mLevels.end(), tolerance) - mLevels.begin();
+        if (index != 0)
+        {
+            --index;
+        }
+
+        EntryMap::iterator it = mIndex.find(&curve);
+        if (it != mIndex.end())
+        {
+            ++mHitCount;
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            return it->second->levels[index];
+        }
+
+        ++mMissCount;
+
+        std::vector<Extruder> levels(mLevels.size());
+        levels[0].setTolerance(mLevels[0]);
+        levels[0].tesselate(curve);
+        size_t sampleCount = levels[0].sampleCount();
+
+        for (size_t i = 1; i != mLevels.size(); ++i)
+        {
+            levels[i].setTolerance(mLevels[i]);
+            levels[i].decimate(levels[0]);
+            sampleCount += levels[i].sampleCount();
+        }
+
+        // A curve that does not fit in the cache on its own is not cached.
+        if (sampleCount > mMaxSampleCount)
+        {
+            mScratch.swap(levels);
+            return mScratch[index];
+        }
+
+        // Make room before inserting, so that the new entry itself is never evicted.
+        evict(mMaxSampleCount - sampleCount);
+
+        mEntries.push_front(Entry());
+        Entry& entry = mEntries.front();
+        entry.curve = &curve;
+        entry.levels.swap(levels);
+        entry.sampleCount = sampleCount;
+        mIndex[&curve] = mEntries.begin();
+        mSampleCount += sampleCount;
+        return entry.levels[index];
+    }
+
+    void TessellationCache::invalidate(const Curve& curve)
+    {
+        EntryMap::iterator it = mIndex.find(&curve);
+        if (it != mIndex.end())
+        {
+            mSampleCount -= it->second->sampleCount;
+            mEntries.erase(it->second);
+            mIndex.erase(it);
+        }
+    }
+
+    void TessellationCache::clear()
+    {
+        mEntries.clear();
+        mIndex.clear();
+        mScratch.clear();
+        mSampleCount = 0;
+    }
+
+    void TessellationCache::setMaxSampleCount(size_t maxSampleCount)
+    {
+        mMaxSampleCount = maxSampleCount;
+        evict(maxSampleCount);
+    }
+
+    void TessellationCache::evict(size_t maxSampleCount)
+    {
+        while (mSampleCount > maxSampleCount)
+        {
+            const Entry& entry = mEntries.back();
+            mSampleCount -= entry.sampleCount;
+            mIndex.erase(entry.curve);
+            mEntries.pop_back();
+        }
+    }
+}
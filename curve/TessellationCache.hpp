@@ -0,0 +1,87 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_TESSELLATIONCACHE_HPP
+#define CV_TESSELLATIONCACHE_HPP
+
+#include "Extruder.hpp"
+
+#include <vector>
+#include <list>
+#include <map>
+
+namespace cv
+{
+    class Curve;
+
+    // Caches tessellations of curves for a fixed set of tolerance levels. Only the finest level is 
+    // tessellated from the curve. The coarser levels are decimated from the finest one. The total 
+    // number of cached samples is bounded, and the least recently used curves are evicted first. A
+    // curve whose levels alone exceed the bound is not cached, but tessellated anew on each request.
+    // Curves are identified by address, so a curve that is modified should be invalidated.
+
+    class TessellationCache
+    {
+    public:
+        TessellationCache(size_t maxSampleCount = 1 << 16)
+            : mMaxSampleCount(maxSampleCount)
+            , mSampleCount(0)
+            , mHitCount(0)
+            , mMissCount(0)
+        {}
+
+        // Replaces the tolerance levels and clears the cache.
+        void setLevels(const Scalar* tolerances, size_t count);
+
+        size_t levelCount() const { return mLevels.size(); }
+        Scalar level(size_t index) const { return mLevels[index]; }
+
+        // Returns the coarsest cached tessellation that is within the given tolerance, or the finest 
+        // if none is. The reference is valid until the next call that modifies the cache.
+        const Extruder& tessellation(const Curve& curve, Scalar tolerance);
+
+        void invalidate(const Curve& curve);
+        void clear();
+
+        size_t maxSampleCount() const { return mMaxSampleCount; }
+        void setMaxSampleCount(size_t maxSampleCount);
+
+        size_t sampleCount() const { return mSampleCount; }
+        size_t curveCount() const { return mEntries.size(); }
+
+        size_t hitCount() const { return mHitCount; }
+        size_t missCount() const { return mMissCount; }
+        Scalar hitRate() const { return mHitCount + mMissCount != 0 ? Scalar(mHitCount) / Scalar(mHitCount + mMissCount) : Scalar(); }
+        void resetStats() { mHitCount = 0; mMissCount = 0; }
+
+    private:
+        struct Entry
+        {
+            const Curve* curve;
+            std::vector<Extruder> levels;
+            size_t sampleCount;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef std::map<const Curve*, EntryList::iterator> EntryMap;
+
+        void evict(size_t maxSampleCount);
+
+        std::vector<Scalar> mLevels;
+        EntryList mEntries;
+        EntryMap mIndex;
+        std::vector<Extruder> mScratch;
+        size_t mMaxSampleCount;
+        size_t mSampleCount;
+        size_t mHitCount;
+        size_t mMissCount;
+    };
+}
+
+
+#endif
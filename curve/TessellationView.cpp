@@ -0,0 +1,47 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "TessellationView.hpp"
+#include "BinaryFormat.hpp"
+
+
+namespace cv
+{
+    bool TessellationView::map(const void* data, size_t size)
+    {
+        const char* begin = static_cast<const char*>(data);
+        const char* end = begin + size;
+        const char* ptr = begin;
+
+        mSamples = 0;
+        mSampleCount = 0;
+
+        // The arrays are aligned relative to the header, so the header itself must be aligned.
+        if (reinterpret_cast<uintptr_t>(begin) % CV_FILE_ALIGNMENT != 0 || 
+            !checkHeader<Extruder>(ptr, end) || size_t(end - ptr) < sizeof(Scalar) + sizeof(uint32_t))
+        {
+            return false;
+        }
+
+        uint32_t count;
+        std::memcpy(&mTolerance, ptr, sizeof(Scalar));
+        std::memcpy(&count, ptr + sizeof(Scalar), sizeof(uint32_t));
+        ptr += sizeof(Scalar) + sizeof(uint32_t);
+
+        size_t padding = paddingSize(ptr - begin);
+        if (size_t(end - ptr) < padding || size_t(end - ptr - padding) / sizeof(Sample) < count)
+        {
+            return false;
+        }
+        ptr += padding;
+
+        mSamples = reinterpret_cast<const Sample*>(ptr);
+        mSampleCount = count;
+        return true;
+    }
+}
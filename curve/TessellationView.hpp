@@ -0,0 +1,45 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef CV_TESSELLATIONVIEW_HPP
+#define CV_TESSELLATIONVIEW_HPP
+
+#include "Extruder.hpp"
+
+namespace cv
+{
+    // Zero-copy view on a tessellation written by guts::serialize for an Extruder, e.g. in a 
+    // memory-mapped file. The memory must be aligned to CV_FILE_ALIGNMENT bytes and remain 
+    // valid for as long as the view is used.
+
+    class TessellationView
+    {
+    public:
+        TessellationView()
+            : mTolerance(Scalar())
+            , mSamples(0)
+            , mSampleCount(0)
+        {}
+
+        bool map(const void* data, size_t size);
+
+        Scalar tolerance() const { return mTolerance; }
+
+        size_t sampleCount() const { return mSampleCount; }
+
+        const Sample& sample(size_t index) const { ASSERT(index < mSampleCount); return mSamples[index]; }
+
+    private:
+        Scalar mTolerance;
+        const Sample* mSamples;
+        size_t mSampleCount;
+    };
+}
+
+
+#endif
@@ -16,6 +16,7 @@
 #include <moto/Metric.hpp>
 #include <moto/ScalarTraits.hpp>
 #include <moto/DualVector3.hpp>
+#include <moto/DualVector4.hpp>
 #include <moto/Trigonometric.hpp>
 
 
@@ -33,11 +34,39 @@ namespace cv
     typedef mt::ScalarTraits<Scalar> ScalarTraits;
     typedef mt::Dual<Scalar> Dual;
     typedef mt::Vector3<Dual> DualVector3;
+    typedef mt::Vector4<Dual> DualQuaternion;
+
+    // The batched curve evaluations gather the keys of consecutive parameters into the lanes of packets.
+    typedef mt::FloatPacket Lanes;
    
    	using mt::Zero;
 	using mt::Identity;
 	using mt::Unit;
  
+    inline
+    void insertLane(mt::Vector3<Lanes>& v, int k, const Vector3& u)
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            v[j][k] = u[j];
+        }
+    }
+
+    inline
+    void insertLane(mt::Vector4<Lanes>& v, int k, const Vector4& u)
+    {
+        for (int j = 0; j != 4; ++j)
+        {
+            v[j][k] = u[j];
+        }
+    }
+
+    inline
+    Vector4 extractLane(const mt::Vector4<Lanes>& v, int k)
+    {
+        return Vector4(v[0][k], v[1][k], v[2][k], v[3][k]);
+    }
+
 #if FUZZY_EQUAL
     inline
     bool operator==(const Vector3& lhs, const Vector3& rhs)
@@ -0,0 +1,159 @@
+/*  Guts - Generic Utilities 
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef GUTS_ARENA_HPP
+#define GUTS_ARENA_HPP
+
+#include "Memory.hpp"
+
+#include <stddef.h>
+
+namespace guts
+{
+    // A bump allocator that carves allocations out of large blocks and releases them all at once.
+    // clear() rewinds to the first block but keeps the blocks, so after a warm-up the same sequence of
+    // allocations is served again without touching the heap. Destructors of objects placed in the
+    // arena are not called.
+    class Arena
+    {
+    public:
+        explicit Arena(size_t blockSize = 64 * 1024);
+        ~Arena();
+
+        void* allocate(size_t size, size_t alignment = 16);
+
+        template <typename T> T* allocate();
+
+        void clear();
+
+        size_t size() const;
+        size_t capacity() const;
+
+    private:
+        Arena(const Arena&);
+        Arena& operator=(const Arena&);
+
+        struct Block
+        {
+            Block* next;
+            size_t size;
+        };
+
+        char* begin(Block* block) const;
+        char* end(Block* block) const;
+
+        Block* mFirst;
+        Block* mCurrent;
+        char* mTop;
+        size_t mBlockSize;
+        size_t mUsed;
+        size_t mCapacity;
+    };
+
+
+    inline
+    Arena::Arena(size_t blockSize)
+        : mFirst(NULLPTR)
+        , mCurrent(NULLPTR)
+        , mTop(NULLPTR)
+        , mBlockSize(blockSize)
+        , mUsed(0)
+        , mCapacity(0)
+    {}
+
+    inline
+    Arena::~Arena()
+    {
+        while (mFirst != NULLPTR)
+        {
+            Block* next = mFirst->next;
+            DEALLOCATE(mFirst);
+            mFirst = next;
+        }
+    }
+
+    inline
+    char* Arena::begin(Block* block) const
+    {
+        return reinterpret_cast<char*>(block + 1);
+    }
+
+    inline
+    char* Arena::end(Block* block) const
+    {
+        return begin(block) + block->size;
+    }
+
+    inline
+    void* Arena::allocate(size_t size, size_t alignment)
+    {
+        ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        char* p = reinterpret_cast<char*>((size_t(mTop) + alignment - 1) & ~(alignment - 1));
+        if (mCurrent == NULLPTR || p + size > end(mCurrent))
+        {
+            // Move on to the next block that is large enough, or insert a new one after the current block.
+            size_t required = size + alignment;
+            Block* next = mCurrent != NULLPTR ? mCurrent->next : mFirst;
+            while (next != NULLPTR && next->size < required)
+            {
+                next = next->next;
+            }
+            if (next == NULLPTR)
+            {
+                size_t blockSize = required > mBlockSize ? required : mBlockSize;
+                next = static_cast<Block*>(static_cast<void*>(ALLOCATE_ARRAY(char, sizeof(Block) + blockSize)));
+                next->size = blockSize;
+                if (mCurrent != NULLPTR)
+                {
+                    next->next = mCurrent->next;
+                    mCurrent->next = next;
+                }
+                else
+                {
+                    next->next = mFirst;
+                    mFirst = next;
+                }
+                mCapacity += blockSize;
+            }
+            mCurrent = next;
+            p = reinterpret_cast<char*>((size_t(begin(mCurrent)) + alignment - 1) & ~(alignment - 1));
+        }
+        mTop = p + size;
+        mUsed += size;
+        return p;
+    }
+
+    template <typename T>
+    FORCEINLINE
+    T* Arena::allocate()
+    {
+        return static_cast<T*>(allocate(sizeof(T)));
+    }
+
+    inline
+    void Arena::clear()
+    {
+        mCurrent = NULLPTR;
+        mTop = NULLPTR;
+        mUsed = 0;
+    }
+
+    inline
+    size_t Arena::size() const
+    {
+        return mUsed;
+    }
+
+    inline
+    size_t Arena::capacity() const
+    {
+        return mCapacity;
+    }
+}
+
+#endif
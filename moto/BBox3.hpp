@@ -11,6 +11,9 @@
 
 #include <moto/Vector3.hpp>
 #include <moto/Interval.hpp>
+#include <moto/BitMask4.hpp>
+
+#include <cstddef>
 
 namespace mt
 {  
@@ -45,6 +48,21 @@ namespace mt
     
     template <typename Scalar> BBox3<Scalar> clamp(const BBox3<Scalar>& b1, const BBox3<Scalar>& b2);
 
+    // Broadphase tests of one box against a structure-of-arrays of boxes, whose lower and upper bounds
+    // are read from three streams each. The four-box versions test boxes i to i + 3 and return one bit
+    // per box. The array versions set bit i % 32 of mask[i / 32] for each of the n boxes, and clear the
+    // remaining bits of the last word. subset tests whether the boxes of the array are contained in b.
+
+    template <typename Scalar> 
+    BitMask4 overlap(const BBox3<Scalar>& b, const Scalar* const lower[3], const Scalar* const upper[3], size_t i);
+    template <typename Scalar> 
+    BitMask4 subset(const Scalar* const lower[3], const Scalar* const upper[3], size_t i, const BBox3<Scalar>& b);
+
+    template <typename Scalar> 
+    void overlap(const BBox3<Scalar>& b, const Scalar* const lower[3], const Scalar* const upper[3], uint32_t* mask, size_t n);
+    template <typename Scalar> 
+    void subset(const Scalar* const lower[3], const Scalar* const upper[3], uint32_t* mask, size_t n, const BBox3<Scalar>& b);
+
 
     template <typename Scalar>
     FORCEINLINE
@@ -180,8 +198,72 @@ namespace mt
     {
         return BBox3<Scalar>(clamp(b1.x, b2.x), clamp(b1.y, b2.y), clamp(b1.z, b2.z));
     }
+
+    // Box i of a structure-of-arrays
+    template <typename Scalar>
+    FORCEINLINE 
+    BBox3<Scalar> loadBox(const Scalar* const lower[3], const Scalar* const upper[3], size_t i)
+    {
+        return BBox3<Scalar>(lower[0][i], upper[0][i], lower[1][i], upper[1][i], lower[2][i], upper[2][i]);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE 
+    BitMask4 overlap(const BBox3<Scalar>& b, const Scalar* const lower[3], const Scalar* const upper[3], size_t i)
+    {
+        return BitMask4(overlap(b, loadBox(lower, upper, i)), 
+                        overlap(b, loadBox(lower, upper, i + 1)), 
+                        overlap(b, loadBox(lower, upper, i + 2)), 
+                        overlap(b, loadBox(lower, upper, i + 3)));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE 
+    BitMask4 subset(const Scalar* const lower[3], const Scalar* const upper[3], size_t i, const BBox3<Scalar>& b)
+    {
+        return BitMask4(subset(loadBox(lower, upper, i), b), 
+                        subset(loadBox(lower, upper, i + 1), b), 
+                        subset(loadBox(lower, upper, i + 2), b), 
+                        subset(loadBox(lower, upper, i + 3), b));
+    }
+
+    template <typename Scalar>
+    void overlap(const BBox3<Scalar>& b, const Scalar* const lower[3], const Scalar* const upper[3], uint32_t* mask, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t bits = uint32_t(overlap(b, lower, upper, i)) << (i % 32);
+            mask[i / 32] = i % 32 == 0 ? bits : mask[i / 32] | bits;
+        }
+        for (; i != n; ++i)
+        {
+            uint32_t bits = uint32_t(overlap(b, loadBox(lower, upper, i))) << (i % 32);
+            mask[i / 32] = i % 32 == 0 ? bits : mask[i / 32] | bits;
+        }
+    }
+
+    template <typename Scalar>
+    void subset(const Scalar* const lower[3], const Scalar* const upper[3], uint32_t* mask, size_t n, const BBox3<Scalar>& b)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t bits = uint32_t(subset(lower, upper, i, b)) << (i % 32);
+            mask[i / 32] = i % 32 == 0 ? bits : mask[i / 32] | bits;
+        }
+        for (; i != n; ++i)
+        {
+            uint32_t bits = uint32_t(subset(loadBox(lower, upper, i), b)) << (i % 32);
+            mask[i / 32] = i % 32 == 0 ? bits : mask[i / 32] | bits;
+        }
+    }
 }
 
+#if USE_SSE
+#include <moto/BBox3_SSE.hpp>
+#endif
+
 #endif
 
 
@@ -0,0 +1,247 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_BBOX3_HPP
+#error This header file should be included by BBox3.hpp only.
+#endif
+
+#include <moto/SSE.hpp>
+#include <moto/Vector4.hpp>
+
+// With USE_SSE_BBOX3, BBox3<float> keeps its lower and upper bounds in two registers instead of three
+// interleaved intervals, so that the box operations are branch-free. The fourth elements are ignored.
+// Elements are read as intervals through operator[]. The comparisons are negated, as in Interval.hpp,
+// so NaN bounds give the same results as the generic versions.
+
+namespace mt
+{
+#if USE_SSE_BBOX3
+
+    template <>
+    class BBox3<float>
+    {
+    public:
+        typedef Interval<float> ScalarType;
+
+        BBox3();
+        BBox3(__m128 lo, __m128 hi);
+        BBox3(Interval<float> x, Interval<float> y, Interval<float> z);
+        BBox3(Zero);
+        template <typename Scalar2> BBox3(const Vector3<Scalar2>& v);
+
+        explicit BBox3(float radius);
+        BBox3(float xabs, float yabs, float zabs);
+        BBox3(float xmin, float xmax, float ymin, float ymax, float zmin, float zmax);
+
+        Interval<float> operator[](int i) const;
+
+        __m128 lo;
+        __m128 hi;
+    };
+
+    Vector3<float> lower(const BBox3<float>& b);
+    Vector3<float> upper(const BBox3<float>& b);
+    Vector3<float> width(const BBox3<float>& b);
+    Vector3<float> median(const BBox3<float>& b);
+
+    BBox3<float> hull(const Vector3<float>& v1, const Vector3<float>& v2);
+    BBox3<float> hull(const BBox3<float>& b, const Vector3<float>& v);
+    BBox3<float> hull(const Vector3<float>& v, const BBox3<float>& b);
+    BBox3<float> hull(const BBox3<float>& b1, const BBox3<float>& b2);
+
+    bool overlap(const BBox3<float>& b1, const BBox3<float>& b2);
+    bool subset(const BBox3<float>& b1, const BBox3<float>& b2);
+    bool in(const Vector3<float>& v, const BBox3<float>& b);
+
+    BBox3<float> clamp(const BBox3<float>& b1, const BBox3<float>& b2);
+
+#endif
+
+    BitMask4 overlap(const BBox3<float>& b, const float* const lower[3], const float* const upper[3], size_t i);
+    BitMask4 subset(const float* const lower[3], const float* const upper[3], size_t i, const BBox3<float>& b);
+
+
+#if USE_SSE_BBOX3
+
+    FORCEINLINE
+    BBox3<float>::BBox3()
+    {}
+
+    FORCEINLINE
+    BBox3<float>::BBox3(__m128 lo, __m128 hi)
+        : lo(lo)
+        , hi(hi)
+    {}
+
+    FORCEINLINE
+    BBox3<float>::BBox3(Interval<float> x, Interval<float> y, Interval<float> z)
+        : lo(_mm_setr_ps(x.lower(), y.lower(), z.lower(), 0.0f))
+        , hi(_mm_setr_ps(x.upper(), y.upper(), z.upper(), 0.0f))
+    {}
+
+    FORCEINLINE
+    BBox3<float>::BBox3(Zero)
+        : lo(_mm_setzero_ps())
+        , hi(_mm_setzero_ps())
+    {}
+
+    template <typename Scalar2>
+    FORCEINLINE
+    BBox3<float>::BBox3(const Vector3<Scalar2>& v)
+    {
+        *this = BBox3<float>(Interval<float>(v.x), Interval<float>(v.y), Interval<float>(v.z));
+    }
+
+    FORCEINLINE
+    BBox3<float>::BBox3(float radius)
+        : lo(_mm_setr_ps(-radius, -radius, -radius, 0.0f))
+        , hi(_mm_setr_ps(radius, radius, radius, 0.0f))
+    {}
+
+    FORCEINLINE
+    BBox3<float>::BBox3(float xabs, float yabs, float zabs)
+        : lo(_mm_setr_ps(-xabs, -yabs, -zabs, 0.0f))
+        , hi(_mm_setr_ps(xabs, yabs, zabs, 0.0f))
+    {}
+
+    FORCEINLINE
+    BBox3<float>::BBox3(float xmin, float xmax, float ymin, float ymax, float zmin, float zmax)
+        : lo(_mm_setr_ps(xmin, ymin, zmin, 0.0f))
+        , hi(_mm_setr_ps(xmax, ymax, zmax, 0.0f))
+    {}
+
+    FORCEINLINE
+    Interval<float> BBox3<float>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < 3);
+        float l[4];
+        float u[4];
+        _mm_storeu_ps(l, lo);
+        _mm_storeu_ps(u, hi);
+        return Interval<float>(l[i], u[i]);
+    }
+
+    FORCEINLINE
+    Vector3<float> lower(const BBox3<float>& b)
+    {
+        Vector3<float> result;
+        store3(result, b.lo);
+        return result;
+    }
+
+    FORCEINLINE
+    Vector3<float> upper(const BBox3<float>& b)
+    {
+        Vector3<float> result;
+        store3(result, b.hi);
+        return result;
+    }
+
+    FORCEINLINE
+    Vector3<float> width(const BBox3<float>& b)
+    {
+        Vector3<float> result;
+        store3(result, _mm_sub_ps(b.hi, b.lo));
+        return result;
+    }
+
+    FORCEINLINE
+    Vector3<float> median(const BBox3<float>& b)
+    {
+        Vector3<float> result;
+        store3(result, _mm_mul_ps(_mm_add_ps(b.lo, b.hi), _mm_set1_ps(0.5f)));
+        return result;
+    }
+
+    FORCEINLINE
+    BBox3<float> hull(const Vector3<float>& v1, const Vector3<float>& v2)
+    {
+        __m128 a = load3(v1);
+        __m128 b = load3(v2);
+        return BBox3<float>(_mm_min_ps(a, b), _mm_max_ps(a, b));
+    }
+
+    FORCEINLINE
+    BBox3<float> hull(const BBox3<float>& b, const Vector3<float>& v)
+    {
+        __m128 a = load3(v);
+        return BBox3<float>(_mm_min_ps(b.lo, a), _mm_max_ps(b.hi, a));
+    }
+
+    FORCEINLINE
+    BBox3<float> hull(const Vector3<float>& v, const BBox3<float>& b)
+    {
+        return hull(b, v);
+    }
+
+    FORCEINLINE
+    BBox3<float> hull(const BBox3<float>& b1, const BBox3<float>& b2)
+    {
+        return BBox3<float>(_mm_min_ps(b1.lo, b2.lo), _mm_max_ps(b1.hi, b2.hi));
+    }
+
+    FORCEINLINE
+    bool overlap(const BBox3<float>& b1, const BBox3<float>& b2)
+    {
+        __m128 m = _mm_and_ps(_mm_cmpnlt_ps(b1.hi, b2.lo), _mm_cmpnlt_ps(b2.hi, b1.lo));
+        return (_mm_movemask_ps(m) & 0x7) == 0x7;
+    }
+
+    FORCEINLINE
+    bool subset(const BBox3<float>& b1, const BBox3<float>& b2)
+    {
+        __m128 m = _mm_and_ps(_mm_cmpnlt_ps(b1.lo, b2.lo), _mm_cmpnlt_ps(b2.hi, b1.hi));
+        return (_mm_movemask_ps(m) & 0x7) == 0x7;
+    }
+
+    FORCEINLINE
+    bool in(const Vector3<float>& v, const BBox3<float>& b)
+    {
+        __m128 a = load3(v);
+        __m128 m = _mm_and_ps(_mm_cmpnlt_ps(a, b.lo), _mm_cmpnlt_ps(b.hi, a));
+        return (_mm_movemask_ps(m) & 0x7) == 0x7;
+    }
+
+    FORCEINLINE
+    BBox3<float> clamp(const BBox3<float>& b1, const BBox3<float>& b2)
+    {
+        // Disjoint intervals collapse to the nearest bound of b2.
+        return BBox3<float>(_mm_min_ps(_mm_max_ps(b1.lo, b2.lo), b2.hi),
+                            _mm_max_ps(_mm_min_ps(b1.hi, b2.hi), b2.lo));
+    }
+
+#endif
+
+    FORCEINLINE
+    BitMask4 overlap(const BBox3<float>& b, const float* const lower[3], const float* const upper[3], size_t i)
+    {
+        Vector3<float> l = mt::lower(b);
+        Vector3<float> u = mt::upper(b);
+        __m128 m = _mm_and_ps(_mm_cmpnlt_ps(_mm_set1_ps(u.x), _mm_loadu_ps(lower[0] + i)),
+                              _mm_cmpnlt_ps(_mm_loadu_ps(upper[0] + i), _mm_set1_ps(l.x)));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpnlt_ps(_mm_set1_ps(u.y), _mm_loadu_ps(lower[1] + i)),
+                                     _mm_cmpnlt_ps(_mm_loadu_ps(upper[1] + i), _mm_set1_ps(l.y))));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpnlt_ps(_mm_set1_ps(u.z), _mm_loadu_ps(lower[2] + i)),
+                                     _mm_cmpnlt_ps(_mm_loadu_ps(upper[2] + i), _mm_set1_ps(l.z))));
+        return BitMask4(uint32_t(_mm_movemask_ps(m)));
+    }
+
+    FORCEINLINE
+    BitMask4 subset(const float* const lower[3], const float* const upper[3], size_t i, const BBox3<float>& b)
+    {
+        Vector3<float> l = mt::lower(b);
+        Vector3<float> u = mt::upper(b);
+        __m128 m = _mm_and_ps(_mm_cmpnlt_ps(_mm_loadu_ps(lower[0] + i), _mm_set1_ps(l.x)),
+                              _mm_cmpnlt_ps(_mm_set1_ps(u.x), _mm_loadu_ps(upper[0] + i)));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpnlt_ps(_mm_loadu_ps(lower[1] + i), _mm_set1_ps(l.y)),
+                                     _mm_cmpnlt_ps(_mm_set1_ps(u.y), _mm_loadu_ps(upper[1] + i))));
+        m = _mm_and_ps(m, _mm_and_ps(_mm_cmpnlt_ps(_mm_loadu_ps(lower[2] + i), _mm_set1_ps(l.z)),
+                                     _mm_cmpnlt_ps(_mm_set1_ps(u.z), _mm_loadu_ps(upper[2] + i))));
+        return BitMask4(uint32_t(_mm_movemask_ps(m)));
+    }
+}
@@ -37,6 +37,7 @@ namespace mt
 
     bool any(BitMask4 a);
     bool all(BitMask4 a);
+    bool none(BitMask4 a);
 
     
    
@@ -117,6 +118,12 @@ namespace mt
         return a == 0xf;
     }
 
+    FORCEINLINE
+    bool none(BitMask4 a)
+    {
+        return a == 0x0;
+    }
+
 
 
 }
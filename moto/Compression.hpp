@@ -0,0 +1,566 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_COMPRESSION_HPP
+#define MT_COMPRESSION_HPP
+
+#include <moto/PacketMath.hpp>
+#include <moto/Vector3.hpp>
+#include <moto/Vector4.hpp>
+
+#if USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace mt
+{
+    // Compact storage for rotations, positions and vectors of floats. Each codec has a form for a single
+    // value and a batch form for arrays. The batch forms take quaternions and positions as structures of
+    // arrays, one float array per coordinate, and write the codes of consecutive elements one after the
+    // other.
+    //
+    // Quaternions are stored as their three smallest components, plus the two-bit index of the largest
+    // one. Since q and -q are the same rotation, the sign of the largest component is made positive,
+    // after which it follows from the unit length. The three smallest lie in [-1/sqrt(2), 1/sqrt(2)]
+    // and are quantized uniformly to 10 bits (packQuaternion32) or 15 bits (packQuaternion48). One
+    // code is left unused, so that zero is a code, and the identity and rotations of multiples of 90
+    // degrees about the axes decode exactly. The quaternions should have unit length. The error of a
+    // component is at most half a step, h = 1 / (sqrt(2) (2^bits - 2)), so the three smallest are off
+    // by at most sqrt(3) h. The largest component is at least 1/2, so its reconstruction from the unit
+    // length adds at most sqrt(3) times that, and the angle of the rotation between the original and
+    // the decoded rotation, twice the distance of the quaternions, is at most 4 sqrt(3) h radians:
+    //
+    //   packQuaternion32    0.0048 radians, 0.275 degrees
+    //   packQuaternion48    0.00015 radians, 0.0086 degrees
+    //
+    // PositionQuantizer maps each coordinate within a box to 16 bits. Positions outside the box are
+    // clamped. The maximum error per coordinate is half a step, as returned by maxError.
+    //
+    // Half floats are IEEE 754 binary16: 11 significant bits, normals from 2^-14 up to 65504, and
+    // subnormals down to 2^-24. packHalf rounds to nearest even, overflows to infinity and keeps NaNs.
+    // The relative error of normal results is at most 2^-11. The conversion is done in software, and
+    // the batch forms use SSE2 rather than the F16C instructions, so that they run on any x86-64.
+
+    uint32_t packQuaternion32(const Vector4<float>& q);
+    Vector4<float> unpackQuaternion32(uint32_t code);
+    void packQuaternion48(const Vector4<float>& q, uint16_t code[3]);
+    Vector4<float> unpackQuaternion48(const uint16_t code[3]);
+
+    void packQuaternion32(const float* const q[4], uint32_t* code, size_t n);
+    void unpackQuaternion32(const uint32_t* code, float* const q[4], size_t n);
+    void packQuaternion48(const float* const q[4], uint16_t* code, size_t n);
+    void unpackQuaternion48(const uint16_t* code, float* const q[4], size_t n);
+
+    class PositionQuantizer
+    {
+    public:
+        PositionQuantizer(const Vector3<float>& lower, const Vector3<float>& upper);
+        PositionQuantizer(const float* const p[3], size_t n);
+
+        const Vector3<float>& lower() const;
+        const Vector3<float>& upper() const;
+        Vector3<float> maxError() const;
+
+        void pack(const Vector3<float>& p, uint16_t code[3]) const;
+        Vector3<float> unpack(const uint16_t code[3]) const;
+
+        void pack(const float* const p[3], uint16_t* code, size_t n) const;
+        void unpack(const uint16_t* code, float* const p[3], size_t n) const;
+
+    private:
+        void setRange(const Vector3<float>& lower, const Vector3<float>& upper);
+
+        Vector3<float> mLower;
+        Vector3<float> mUpper;
+        float mScale[3];
+        float mStep[3];
+    };
+
+    uint16_t packHalf(float x);
+    float unpackHalf(uint16_t h);
+    void packHalf(const Vector3<float>& v, uint16_t h[3]);
+    void unpackHalf(const uint16_t h[3], Vector3<float>& v);
+
+    void packHalf(const float* x, uint16_t* h, size_t n);
+    void unpackHalf(const uint16_t* h, float* x, size_t n);
+
+
+    namespace detail
+    {
+        // Rounds x * scale to an integral value in [0, maxCode].
+        template <typename Scalar>
+        FORCEINLINE
+        Scalar quantize(const Scalar& x, float scale, float maxCode)
+        {
+            return min(max(floor(x * scale + 0.5f), Scalar(0.0f)), Scalar(maxCode));
+        }
+
+        // Quantizes the three smallest components of q to integral values in [0, 2 half], where half is
+        // zero, and returns the index of the largest. Generic over float and packets of floats.
+        template <typename Scalar>
+        FORCEINLINE
+        void packSmallestThree(const Scalar q[4], float half, Scalar& index, Scalar c[3])
+        {
+            const float SQRT1_2 = 0.70710678f;
+            Scalar largest = q[0];
+            index = Scalar(0.0f);
+            for (int k = 1; k != 4; ++k)
+            {
+                index = select(abs(largest) < abs(q[k]), Scalar(float(k)), index);
+                largest = select(abs(largest) < abs(q[k]), q[k], largest);
+            }
+            Scalar sign = select(isnegative(largest), Scalar(-1.0f), Scalar(1.0f));
+            c[0] = select(index == Scalar(0.0f), q[1], q[0]);
+            c[1] = select(index <= Scalar(1.0f), q[2], q[1]);
+            c[2] = select(index <= Scalar(2.0f), q[3], q[2]);
+            for (int k = 0; k != 3; ++k)
+            {
+                c[k] = min(max(floor(c[k] * sign * (half / SQRT1_2) + (half + 0.5f)), Scalar(0.0f)), Scalar(2.0f * half));
+            }
+        }
+
+        template <typename Scalar>
+        FORCEINLINE
+        void unpackSmallestThree(const Scalar& index, const Scalar c[3], float half, Scalar q[4])
+        {
+            const float SQRT1_2 = 0.70710678f;
+            Scalar a = (c[0] - half) * (SQRT1_2 / half);
+            Scalar b = (c[1] - half) * (SQRT1_2 / half);
+            Scalar d = (c[2] - half) * (SQRT1_2 / half);
+            Scalar w = sqrt(max(Scalar(1.0f) - a * a - b * b - d * d, Scalar(0.0f)));
+            q[0] = select(index == Scalar(0.0f), w, a);
+            q[1] = select(index == Scalar(0.0f), a, select(index == Scalar(1.0f), w, b));
+            q[2] = select(index <= Scalar(1.0f), b, select(index == Scalar(2.0f), w, d));
+            q[3] = select(index <= Scalar(2.0f), d, w);
+        }
+
+        // The 32-bit code holds the index in bits 30-31, and the components in bits 20-29, 10-19 and 0-9.
+        FORCEINLINE
+        uint32_t packCode32(float index, const float c[3])
+        {
+            return (uint32_t(index) << 30) | (uint32_t(c[0]) << 20) | (uint32_t(c[1]) << 10) | uint32_t(c[2]);
+        }
+
+        FORCEINLINE
+        void unpackCode32(uint32_t code, float& index, float c[3])
+        {
+            index = float(int32_t(code >> 30));
+            c[0] = float(int32_t((code >> 20) & 0x3ff));
+            c[1] = float(int32_t((code >> 10) & 0x3ff));
+            c[2] = float(int32_t(code & 0x3ff));
+        }
+
+        // The 48-bit code holds the components in the low 15 bits of three words, and the index in the
+        // top bits of the first two.
+        FORCEINLINE
+        void packCode48(float index, const float c[3], uint16_t code[3])
+        {
+            uint32_t i = uint32_t(index);
+            code[0] = uint16_t(((i & 2) << 14) | uint32_t(c[0]));
+            code[1] = uint16_t(((i & 1) << 15) | uint32_t(c[1]));
+            code[2] = uint16_t(c[2]);
+        }
+
+        FORCEINLINE
+        void unpackCode48(const uint16_t code[3], float& index, float c[3])
+        {
+            index = float(int32_t(((code[0] >> 14) & 2) | (code[1] >> 15)));
+            c[0] = float(int32_t(code[0] & 0x7fff));
+            c[1] = float(int32_t(code[1] & 0x7fff));
+            c[2] = float(int32_t(code[2] & 0x7fff));
+        }
+    }
+
+    inline
+    uint32_t packQuaternion32(const Vector4<float>& q)
+    {
+        const float v[4] = { q[0], q[1], q[2], q[3] };
+        float index;
+        float c[3];
+        detail::packSmallestThree(v, 511.0f, index, c);
+        return detail::packCode32(index, c);
+    }
+
+    inline
+    Vector4<float> unpackQuaternion32(uint32_t code)
+    {
+        float index;
+        float c[3];
+        detail::unpackCode32(code, index, c);
+        float q[4];
+        detail::unpackSmallestThree(index, c, 511.0f, q);
+        return Vector4<float>(q[0], q[1], q[2], q[3]);
+    }
+
+    inline
+    void packQuaternion48(const Vector4<float>& q, uint16_t code[3])
+    {
+        const float v[4] = { q[0], q[1], q[2], q[3] };
+        float index;
+        float c[3];
+        detail::packSmallestThree(v, 16383.0f, index, c);
+        detail::packCode48(index, c, code);
+    }
+
+    inline
+    Vector4<float> unpackQuaternion48(const uint16_t code[3])
+    {
+        float index;
+        float c[3];
+        detail::unpackCode48(code, index, c);
+        float q[4];
+        detail::unpackSmallestThree(index, c, 16383.0f, q);
+        return Vector4<float>(q[0], q[1], q[2], q[3]);
+    }
+
+    inline
+    void packQuaternion32(const float* const q[4], uint32_t* code, size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            const FloatPacket v[4] = { detail::loadLanes(q[0], i, n), detail::loadLanes(q[1], i, n), detail::loadLanes(q[2], i, n), detail::loadLanes(q[3], i, n) };
+            FloatPacket index;
+            FloatPacket c[3];
+            detail::packSmallestThree(v, 511.0f, index, c);
+            for (size_t k = 0; k != N && i + k < n; ++k)
+            {
+                const float lane[3] = { c[0][int(k)], c[1][int(k)], c[2][int(k)] };
+                code[i + k] = detail::packCode32(index[int(k)], lane);
+            }
+        }
+    }
+
+    inline
+    void unpackQuaternion32(const uint32_t* code, float* const q[4], size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            FloatPacket index;
+            FloatPacket c[3];
+            for (size_t k = 0; k != N && i + k < n; ++k)
+            {
+                float lane[3];
+                detail::unpackCode32(code[i + k], index[int(k)], lane);
+                c[0][int(k)] = lane[0];
+                c[1][int(k)] = lane[1];
+                c[2][int(k)] = lane[2];
+            }
+            FloatPacket v[4];
+            detail::unpackSmallestThree(index, c, 511.0f, v);
+            for (int j = 0; j != 4; ++j)
+            {
+                detail::storeLanes(q[j], i, n, v[j]);
+            }
+        }
+    }
+
+    inline
+    void packQuaternion48(const float* const q[4], uint16_t* code, size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            const FloatPacket v[4] = { detail::loadLanes(q[0], i, n), detail::loadLanes(q[1], i, n), detail::loadLanes(q[2], i, n), detail::loadLanes(q[3], i, n) };
+            FloatPacket index;
+            FloatPacket c[3];
+            detail::packSmallestThree(v, 16383.0f, index, c);
+            for (size_t k = 0; k != N && i + k < n; ++k)
+            {
+                const float lane[3] = { c[0][int(k)], c[1][int(k)], c[2][int(k)] };
+                detail::packCode48(index[int(k)], lane, code + 3 * (i + k));
+            }
+        }
+    }
+
+    inline
+    void unpackQuaternion48(const uint16_t* code, float* const q[4], size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            FloatPacket index;
+            FloatPacket c[3];
+            for (size_t k = 0; k != N && i + k < n; ++k)
+            {
+                float lane[3];
+                detail::unpackCode48(code + 3 * (i + k), index[int(k)], lane);
+                c[0][int(k)] = lane[0];
+                c[1][int(k)] = lane[1];
+                c[2][int(k)] = lane[2];
+            }
+            FloatPacket v[4];
+            detail::unpackSmallestThree(index, c, 16383.0f, v);
+            for (int j = 0; j != 4; ++j)
+            {
+                detail::storeLanes(q[j], i, n, v[j]);
+            }
+        }
+    }
+
+    inline
+    PositionQuantizer::PositionQuantizer(const Vector3<float>& lower, const Vector3<float>& upper)
+    {
+        setRange(lower, upper);
+    }
+
+    inline
+    PositionQuantizer::PositionQuantizer(const float* const p[3], size_t n)
+    {
+        // The range of a stream of positions
+        ASSERT(n != 0);
+        float lower[3] = { p[0][0], p[1][0], p[2][0] };
+        float upper[3] = { p[0][0], p[1][0], p[2][0] };
+        for (int j = 0; j != 3; ++j)
+        {
+            for (size_t i = 1; i < n; ++i)
+            {
+                lower[j] = min(lower[j], p[j][i]);
+                upper[j] = max(upper[j], p[j][i]);
+            }
+        }
+        setRange(Vector3<float>(lower[0], lower[1], lower[2]), Vector3<float>(upper[0], upper[1], upper[2]));
+    }
+
+    inline
+    void PositionQuantizer::setRange(const Vector3<float>& lower, const Vector3<float>& upper)
+    {
+        mLower = lower;
+        mUpper = upper;
+        for (int j = 0; j != 3; ++j)
+        {
+            float extent = upper[j] - lower[j];
+            ASSERT(!(extent < 0.0f));
+            mScale[j] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+            mStep[j] = extent / 65535.0f;
+        }
+    }
+
+    inline
+    const Vector3<float>& PositionQuantizer::lower() const
+    {
+        return mLower;
+    }
+
+    inline
+    const Vector3<float>& PositionQuantizer::upper() const
+    {
+        return mUpper;
+    }
+
+    inline
+    Vector3<float> PositionQuantizer::maxError() const
+    {
+        return Vector3<float>(mStep[0], mStep[1], mStep[2]) * 0.5f;
+    }
+
+    inline
+    void PositionQuantizer::pack(const Vector3<float>& p, uint16_t code[3]) const
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            code[j] = uint16_t(detail::quantize(p[j] - mLower[j], mScale[j], 65535.0f));
+        }
+    }
+
+    inline
+    Vector3<float> PositionQuantizer::unpack(const uint16_t code[3]) const
+    {
+        return Vector3<float>(mLower[0] + float(int32_t(code[0])) * mStep[0],
+                              mLower[1] + float(int32_t(code[1])) * mStep[1],
+                              mLower[2] + float(int32_t(code[2])) * mStep[2]);
+    }
+
+    inline
+    void PositionQuantizer::pack(const float* const p[3], uint16_t* code, size_t n) const
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            for (int j = 0; j != 3; ++j)
+            {
+                FloatPacket c = detail::quantize(detail::loadLanes(p[j], i, n) - mLower[j], mScale[j], 65535.0f);
+                for (size_t k = 0; k != N && i + k < n; ++k)
+                {
+                    code[3 * (i + k) + j] = uint16_t(c[int(k)]);
+                }
+            }
+        }
+    }
+
+    inline
+    void PositionQuantizer::unpack(const uint16_t* code, float* const p[3], size_t n) const
+    {
+        const size_t N = FloatPacket::SIZE;
+        for (size_t i = 0; i < n; i += N)
+        {
+            for (int j = 0; j != 3; ++j)
+            {
+                FloatPacket c;
+                for (size_t k = 0; k != N && i + k < n; ++k)
+                {
+                    c[int(k)] = float(int32_t(code[3 * (i + k) + j]));
+                }
+                detail::storeLanes(p[j], i, n, c * mStep[j] + mLower[j]);
+            }
+        }
+    }
+
+    // After "Float->half variants" and "Half->float variants", Fabian Giesen, 2016. Subnormal results are
+    // rounded by adding a magic number in float arithmetic. Normal results add the rounding bias to
+    // the bits, plus one if the lowest bit that is kept is odd, so that ties round to even.
+
+    inline
+    uint16_t packHalf(float x)
+    {
+        uint32_t f = bitcast<uint32_t>(x);
+        uint32_t sign = (f >> 16) & 0x8000;
+        f &= 0x7fffffff;
+        uint32_t h;
+        if (f >= 0x47800000UL)
+        {
+            // Overflow to infinity, NaNs stay quiet NaNs.
+            h = f > 0x7f800000UL ? 0x7e00 : 0x7c00;
+        }
+        else if (f < 0x38800000UL)
+        {
+            const uint32_t MAGIC = 0x3f000000UL;
+            h = bitcast<uint32_t>(bitcast<float>(f) + bitcast<float>(MAGIC)) - MAGIC;
+        }
+        else
+        {
+            uint32_t odd = (f >> 13) & 1;
+            h = (f + 0xc8000fffUL + odd) >> 13;
+        }
+        return uint16_t(h | sign);
+    }
+
+    inline
+    float unpackHalf(uint16_t h)
+    {
+        // Shifting the exponent and significand into place and multiplying by 2^112 rebiases the
+        // exponent, and normalizes subnormals.
+        uint32_t expmant = uint32_t(h) & 0x7fff;
+        uint32_t f = bitcast<uint32_t>(bitcast<float>(expmant << 13) * bitcast<float>(uint32_t(0x77800000UL)));
+        if (expmant >= 0x7c00)
+        {
+            f |= 0x7f800000UL;
+        }
+        return bitcast<float>(f | ((uint32_t(h) & 0x8000) << 16));
+    }
+
+    inline
+    void packHalf(const Vector3<float>& v, uint16_t h[3])
+    {
+        h[0] = packHalf(v[0]);
+        h[1] = packHalf(v[1]);
+        h[2] = packHalf(v[2]);
+    }
+
+    inline
+    void unpackHalf(const uint16_t h[3], Vector3<float>& v)
+    {
+        v = Vector3<float>(unpackHalf(h[0]), unpackHalf(h[1]), unpackHalf(h[2]));
+    }
+
+#if USE_SSE
+
+    namespace detail
+    {
+        // Four packHalf in the low halves of 32-bit lanes. The high halves are the sign extension, so that
+        // a signed pack to 16 bits keeps the results.
+        FORCEINLINE
+        __m128i packHalf(__m128 x)
+        {
+            __m128i sign = _mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(int(0x80000000UL)));
+            __m128i f = _mm_xor_si128(_mm_castps_si128(x), sign);
+            __m128i nan = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(x, x)), _mm_set1_epi32(0x200));
+            __m128i special = _mm_or_si128(nan, _mm_set1_epi32(0x7c00));
+            __m128i regular = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), f);
+            __m128i subnormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), f);
+
+            const __m128i MAGIC = _mm_set1_epi32(0x3f000000);
+            __m128i small = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(f), _mm_castsi128_ps(MAGIC))), MAGIC);
+
+            __m128i odd = _mm_srai_epi32(_mm_slli_epi32(f, 18), 31);
+            __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(f, _mm_set1_epi32(int(0xc8000fffUL))), odd), 13);
+
+            __m128i h = _mm_or_si128(_mm_and_si128(subnormal, small), _mm_andnot_si128(subnormal, normal));
+            h = _mm_or_si128(_mm_and_si128(regular, h), _mm_andnot_si128(regular, special));
+            return _mm_or_si128(h, _mm_srai_epi32(sign, 16));
+        }
+
+        // Four unpackHalf of the zero-extended halves in 32-bit lanes
+        FORCEINLINE
+        __m128 unpackHalf(__m128i h)
+        {
+            __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+            __m128 f = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+            __m128i special = _mm_and_si128(_mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff)), _mm_set1_epi32(0x7f800000));
+            __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+            return _mm_or_ps(f, _mm_castsi128_ps(_mm_or_si128(special, sign)));
+        }
+    }
+
+    inline
+    void packHalf(const float* x, uint16_t* h, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i lo = detail::packHalf(_mm_loadu_ps(x + i));
+            __m128i hi = detail::packHalf(_mm_loadu_ps(x + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(h + i), _mm_packs_epi32(lo, hi));
+        }
+        for (; i != n; ++i)
+        {
+            h[i] = packHalf(x[i]);
+        }
+    }
+
+    inline
+    void unpackHalf(const uint16_t* h, float* x, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            _mm_storeu_ps(x + i, detail::unpackHalf(_mm_unpacklo_epi16(v, _mm_setzero_si128())));
+            _mm_storeu_ps(x + i + 4, detail::unpackHalf(_mm_unpackhi_epi16(v, _mm_setzero_si128())));
+        }
+        for (; i != n; ++i)
+        {
+            x[i] = unpackHalf(h[i]);
+        }
+    }
+
+#else
+
+    inline
+    void packHalf(const float* x, uint16_t* h, size_t n)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            h[i] = packHalf(x[i]);
+        }
+    }
+
+    inline
+    void unpackHalf(const uint16_t* h, float* x, size_t n)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            x[i] = unpackHalf(h[i]);
+        }
+    }
+
+#endif
+}
+
+#endif
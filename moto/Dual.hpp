@@ -15,6 +15,7 @@
 
 #include <guts/TypeTraits.hpp>
 
+#include <moto/Algebra.hpp>
 #include <moto/Promote.hpp>
 #include <moto/Scalar.hpp>
 #include <moto/ScalarTraits.hpp>
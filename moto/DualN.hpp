@@ -0,0 +1,581 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_DUALN_HPP
+#define MT_DUALN_HPP
+
+#ifdef USE_OSTREAM
+#include <ostream>
+#endif
+
+#include <moto/Dual.hpp>
+#include <moto/Packet.hpp>
+
+namespace mt
+{
+    // A dual number with N infinitesimal parts, one per input, so that a single evaluation of a function
+    // yields its full gradient. The infinitesimal parts are stored in a Packet, which makes the derivative
+    // arithmetic SIMD for DualN<float, 4> (SSE) and DualN<float, 8> (AVX). Input i of a function is
+    // seeded with variable<N>(x, i), and each output carries the row of the Jacobian in dual().
+
+    template <typename Scalar, int N>
+    class DualN
+    {
+    public:
+        typedef Scalar ScalarType;
+
+        enum { SIZE = N };
+
+        DualN(Scalar real = Scalar(), const Packet<Scalar, N>& dual = Packet<Scalar, N>());
+
+        Scalar real() const;
+        const Packet<Scalar, N>& dual() const;
+        Scalar dual(int i) const;
+
+        DualN<Scalar, N>& operator=(Scalar rhs);
+        DualN<Scalar, N>& operator+=(Scalar rhs);
+        DualN<Scalar, N>& operator-=(Scalar rhs);
+        DualN<Scalar, N>& operator*=(Scalar rhs);
+        DualN<Scalar, N>& operator/=(Scalar rhs);
+
+        DualN<Scalar, N>& operator+=(const DualN<Scalar, N>& rhs);
+        DualN<Scalar, N>& operator-=(const DualN<Scalar, N>& rhs);
+        DualN<Scalar, N>& operator*=(const DualN<Scalar, N>& rhs);
+        DualN<Scalar, N>& operator/=(const DualN<Scalar, N>& rhs);
+
+    private:
+        Scalar mReal;
+        Packet<Scalar, N> mDual;
+    };
+
+#ifdef USE_OSTREAM
+
+    template <typename CharT, typename Traits, typename Scalar, int N>
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const DualN<Scalar, N>& rhs);
+
+#endif
+
+    template <typename Scalar, int N> bool operator==(const DualN<Scalar, N>& a, Scalar b);
+    template <typename Scalar, int N> bool operator==(Scalar a, const DualN<Scalar, N>& b);
+    template <typename Scalar, int N> bool operator==(const DualN<Scalar, N>& a, const DualN<Scalar, N>& b);
+
+    template <typename Scalar, int N> bool operator<(const DualN<Scalar, N>& a, Scalar b);
+    template <typename Scalar, int N> bool operator<(Scalar a, const DualN<Scalar, N>& b);
+    template <typename Scalar, int N> bool operator<(const DualN<Scalar, N>& a, const DualN<Scalar, N>& b);
+
+    template <typename Scalar, int N> DualN<Scalar, N> operator-(const DualN<Scalar, N>& rhs);
+
+    template <typename Scalar, int N> DualN<Scalar, N> operator+(const DualN<Scalar, N>& lhs, Scalar rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator-(const DualN<Scalar, N>& lhs, Scalar rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator*(const DualN<Scalar, N>& lhs, Scalar rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator/(const DualN<Scalar, N>& lhs, Scalar rhs);
+
+    template <typename Scalar, int N> DualN<Scalar, N> operator+(Scalar lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator-(Scalar lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator*(Scalar lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator/(Scalar lhs, const DualN<Scalar, N>& rhs);
+
+    template <typename Scalar, int N> DualN<Scalar, N> operator+(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator-(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator*(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs);
+    template <typename Scalar, int N> DualN<Scalar, N> operator/(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs);
+
+    // Input i of N, i.e. x with a unit infinitesimal part i
+    template <int N, typename Scalar> DualN<Scalar, N> variable(Scalar x, int i);
+
+    template <typename Scalar, int N> Scalar real(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> const Packet<Scalar, N>& dual(const DualN<Scalar, N>& z);
+
+    template <typename Scalar, int N> DualN<Scalar, N> acos(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> asin(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> atan(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> atan2(const DualN<Scalar, N>& y, const DualN<Scalar, N>& x);
+    template <typename Scalar, int N> DualN<Scalar, N> cos(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> cosh(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> exp(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> log(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> log10(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> pow(const DualN<Scalar, N>& x, const DualN<Scalar, N>& y);
+    template <typename Scalar, int N> DualN<Scalar, N> sin(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> sinh(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> sqrt(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> tan(const DualN<Scalar, N>& z);
+    template <typename Scalar, int N> DualN<Scalar, N> tanh(const DualN<Scalar, N>& z);
+
+    template <typename Scalar, int N> bool isfinite(const DualN<Scalar, N>& z);
+
+
+    // Member functions
+
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>::DualN(Scalar real, const Packet<Scalar, N>& dual)
+        : mReal(real)
+        , mDual(dual)
+    {}
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar DualN<Scalar, N>::real() const
+    {
+        return mReal;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    const Packet<Scalar, N>& DualN<Scalar, N>::dual() const
+    {
+        return mDual;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar DualN<Scalar, N>::dual(int i) const
+    {
+        ASSERT(0 <= i && i < N);
+        return mDual[i];
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator=(Scalar rhs)
+    {
+        mReal = rhs;
+        mDual = Packet<Scalar, N>();
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator+=(Scalar rhs)
+    {
+        mReal += rhs;
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator-=(Scalar rhs)
+    {
+        mReal -= rhs;
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator*=(Scalar rhs)
+    {
+        mReal *= rhs;
+        mDual *= rhs;
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator/=(Scalar rhs)
+    {
+        mReal /= rhs;
+        mDual /= rhs;
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator+=(const DualN<Scalar, N>& rhs)
+    {
+        mReal += rhs.real();
+        mDual += rhs.dual();
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator-=(const DualN<Scalar, N>& rhs)
+    {
+        mReal -= rhs.real();
+        mDual -= rhs.dual();
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator*=(const DualN<Scalar, N>& rhs)
+    {
+        mDual = mDual * rhs.real() + rhs.dual() * mReal;
+        mReal *= rhs.real();
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N>& DualN<Scalar, N>::operator/=(const DualN<Scalar, N>& rhs)
+    {
+        Scalar r = Scalar(1) / rhs.real();
+        mReal *= r;
+        mDual = (mDual - rhs.dual() * mReal) * r;
+        return *this;
+    }
+
+
+    // Non-member functions
+
+
+#ifdef USE_OSTREAM
+
+    template <typename CharT, typename Traits, typename Scalar, int N>
+    FORCEINLINE
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const DualN<Scalar, N>& rhs)
+    {
+        os << rhs.real() << " + \xee [" << rhs.dual(0);
+        for (int i = 1; i != N; ++i)
+        {
+            os << ", " << rhs.dual(i);
+        }
+        return os << ']';
+    }
+
+#endif
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator==(const DualN<Scalar, N>& a, Scalar b)
+    {
+        return a.real() == b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator==(Scalar a, const DualN<Scalar, N>& b)
+    {
+        return a == b.real();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator==(const DualN<Scalar, N>& a, const DualN<Scalar, N>& b)
+    {
+        return a.real() == b.real();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator<(const DualN<Scalar, N>& a, Scalar b)
+    {
+        return a.real() < b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator<(Scalar a, const DualN<Scalar, N>& b)
+    {
+        return a < b.real();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    bool operator<(const DualN<Scalar, N>& a, const DualN<Scalar, N>& b)
+    {
+        return a.real() < b.real();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator-(const DualN<Scalar, N>& rhs)
+    {
+        return DualN<Scalar, N>(-rhs.real(), -rhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator+(const DualN<Scalar, N>& lhs, Scalar rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() + rhs, lhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator-(const DualN<Scalar, N>& lhs, Scalar rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() - rhs, lhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator*(const DualN<Scalar, N>& lhs, Scalar rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() * rhs, lhs.dual() * rhs);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator/(const DualN<Scalar, N>& lhs, Scalar rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() / rhs, lhs.dual() / rhs);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator+(Scalar lhs, const DualN<Scalar, N>& rhs)
+    {
+        return rhs + lhs;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator-(Scalar lhs, const DualN<Scalar, N>& rhs)
+    {
+         return DualN<Scalar, N>(lhs - rhs.real(), -rhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator*(Scalar lhs, const DualN<Scalar, N>& rhs)
+    {
+         return rhs * lhs;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator/(Scalar lhs, const DualN<Scalar, N>& rhs)
+    {
+        Scalar r = Scalar(1) / rhs.real();
+        lhs *= r;
+        return DualN<Scalar, N>(lhs, rhs.dual() * (-lhs * r));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator+(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() + rhs.real(), lhs.dual() + rhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator-(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() - rhs.real(), lhs.dual() - rhs.dual());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator*(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs)
+    {
+        return DualN<Scalar, N>(lhs.real() * rhs.real(), lhs.dual() * rhs.real() + rhs.dual() * lhs.real());
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> operator/(const DualN<Scalar, N>& lhs, const DualN<Scalar, N>& rhs)
+    {
+        Scalar r = Scalar(1) / rhs.real();
+        Scalar x = lhs.real() * r;
+        return DualN<Scalar, N>(x, (lhs.dual() - rhs.dual() * x) * r);
+    }
+
+    template <int N, typename Scalar>
+    FORCEINLINE
+    DualN<Scalar, N> variable(Scalar x, int i)
+    {
+        ASSERT(0 <= i && i < N);
+        Packet<Scalar, N> dual;
+        dual[i] = Scalar(1);
+        return DualN<Scalar, N>(x, dual);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar real(const DualN<Scalar, N>& z)
+    {
+        return z.real();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    const Packet<Scalar, N>& dual(const DualN<Scalar, N>& z)
+    {
+        return z.dual();
+    }
+
+    // Each function below is f(real) + f'(real) dual.
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> acos(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(acos(z.real()), z.dual() * (Scalar(-1) / sqrt(Scalar(1) - z.real() * z.real())));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> asin(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(asin(z.real()), z.dual() * (Scalar(1) / sqrt(Scalar(1) - z.real() * z.real())));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> atan(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(atan(z.real()), z.dual() * (Scalar(1) / (Scalar(1) + z.real() * z.real())));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> atan2(const DualN<Scalar, N>& y, const DualN<Scalar, N>& x)
+    {
+        // d atan2(y, x) = (x dy - y dx) / (x^2 + y^2), which unlike d atan(y / x) is finite for x = 0.
+        Scalar r = Scalar(1) / (x.real() * x.real() + y.real() * y.real());
+        return DualN<Scalar, N>(atan2(y.real(), x.real()), (y.dual() * x.real() - x.dual() * y.real()) * r);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> cos(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(cos(z.real()), z.dual() * -sin(z.real()));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> cosh(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(cosh(z.real()), z.dual() * sinh(z.real()));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> exp(const DualN<Scalar, N>& z)
+    {
+        Scalar x = exp(z.real());
+        return DualN<Scalar, N>(x, z.dual() * x);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> log(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(log(z.real()), z.dual() * (Scalar(1) / z.real()));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> log10(const DualN<Scalar, N>& z)
+    {
+        return log(z) * (Scalar(1) / log(Scalar(10)));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> pow(const DualN<Scalar, N>& x, const DualN<Scalar, N>& y)
+    {
+        return exp(log(x) * y);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> sin(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(sin(z.real()), z.dual() * cos(z.real()));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> sinh(const DualN<Scalar, N>& z)
+    {
+        return DualN<Scalar, N>(sinh(z.real()), z.dual() * cosh(z.real()));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> sqrt(const DualN<Scalar, N>& z)
+    {
+        Scalar x = sqrt(z.real());
+        return DualN<Scalar, N>(x, z.dual() * (Scalar(0.5) / x));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> tan(const DualN<Scalar, N>& z)
+    {
+        Scalar x = tan(z.real());
+        return DualN<Scalar, N>(x, z.dual() * (Scalar(1) + x * x));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    DualN<Scalar, N> tanh(const DualN<Scalar, N>& z)
+    {
+        Scalar x = tanh(z.real());
+        return DualN<Scalar, N>(x, z.dual() * (Scalar(1) - x * x));
+    }
+
+
+#ifndef HAVE_TYPEOF
+
+    template <typename Scalar1, typename Scalar2, int N>
+    struct Promote<Scalar1, DualN<Scalar2, N> >
+    {
+        typedef DualN<typename Promote<Scalar1, Scalar2>::RT, N> RT;
+    };
+
+    template <typename Scalar1, typename Scalar2, int N>
+    struct Promote<DualN<Scalar1, N>, DualN<Scalar2, N> >
+    {
+        typedef DualN<typename Promote<Scalar1, Scalar2>::RT, N> RT;
+    };
+
+#endif
+
+    template <typename Scalar, int N>
+    struct ScalarTraits<DualN<Scalar, N> >
+    {
+
+        // These are all constants and thus have a zero dual part.
+
+        static DualN<Scalar, N> pi()
+        {
+            return DualN<Scalar, N>(ScalarTraits<Scalar>::pi());
+        }
+
+        static DualN<Scalar, N> infinity()
+        {
+            return DualN<Scalar, N>(ScalarTraits<Scalar>::infinity());
+        }
+
+        static DualN<Scalar, N> epsilon()
+        {
+            return DualN<Scalar, N>(ScalarTraits<Scalar>::epsilon());
+        }
+
+        static DualN<Scalar, N> max()
+        {
+            return DualN<Scalar, N>(ScalarTraits<Scalar>::max());
+        }
+    };
+
+    template <typename Scalar, int N>
+    bool isfinite(const DualN<Scalar, N>& z)
+    {
+        if (!isfinite(z.real()))
+        {
+            return false;
+        }
+        for (int i = 0; i != N; ++i)
+        {
+            if (!isfinite(z.dual(i)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+#endif
@@ -41,6 +41,17 @@ namespace mt
 
     template <typename Scalar> Vector3<Dual<Scalar> > logUnit(const Vector4<Dual<Scalar> >& q);
     template <typename Scalar> Vector4<Dual<Scalar> > exp(const Vector3<Dual<Scalar> >& v);
+
+
+    // Dual quaternion linear blending: the weighted sum of the indexed bones, each taken in the hemisphere
+    // of the first one, divided by the length of its real part. The weights need not sum to one. 
+    template <typename Scalar> Vector4<Dual<Scalar> > blend(const Vector4<Dual<Scalar> >* bones, const int* indices, const Scalar* weights, int influences);
+
+    // Skins n vertices, each having "influences" consecutive entries in indices and weights. Normals are 
+    // rotated only. Pass null for normals and outNormals to skip them.
+    template <typename Scalar> void skin(const Vector4<Dual<Scalar> >* bones, const int* indices, const Scalar* weights, int influences, 
+                                         const Vector3<Scalar>* positions, const Vector3<Scalar>* normals, 
+                                         Vector3<Scalar>* outPositions, Vector3<Scalar>* outNormals, size_t n);
     
 #ifdef USE_OSTREAM
     template <typename CharT, typename Traits, typename Scalar> 
@@ -127,6 +138,41 @@ namespace mt
         return makeDual(q, mul(dual(v), q));
     }
 
+    template <typename Scalar>
+    Vector4<Dual<Scalar> > blend(const Vector4<Dual<Scalar> >* bones, const int* indices, const Scalar* weights, int influences)
+    {
+        ASSERT(influences > 0);
+        Vector4<Scalar> pivot = real(bones[indices[0]]);
+        Vector4<Scalar> u = pivot * weights[0];
+        Vector4<Scalar> v = dual(bones[indices[0]]) * weights[0];
+        for (int k = 1; k < influences; ++k)
+        {
+            const Vector4<Dual<Scalar> >& q = bones[indices[k]];
+            Scalar w = isnegative(dot(real(q), pivot)) ? -weights[k] : weights[k];
+            u += real(q) * w;
+            v += dual(q) * w;
+        }
+        Scalar s = length(u);
+        ASSERT(ispositive(s));
+        return makeDual(u / s, v / s);
+    }
+
+    template <typename Scalar>
+    void skin(const Vector4<Dual<Scalar> >* bones, const int* indices, const Scalar* weights, int influences, 
+              const Vector3<Scalar>* positions, const Vector3<Scalar>* normals, 
+              Vector3<Scalar>* outPositions, Vector3<Scalar>* outNormals, size_t n)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector4<Dual<Scalar> > q = blend(bones, indices + i * influences, weights + i * influences, influences);
+            outPositions[i] = rigidTransform(q, positions[i]);
+            if (normals)
+            {
+                outNormals[i] = rotation(q)(normals[i]);
+            }
+        }
+    }
+
 #ifdef USE_OSTREAM
 
     template <typename CharT, typename Traits, typename Scalar> 
@@ -140,5 +186,9 @@ namespace mt
     
 }
 
+#if USE_SSE
+#include <moto/DualVector4_SSE.hpp>
+#endif
+
 #endif
 
@@ -0,0 +1,70 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_DUALVECTOR4BATCH_HPP
+#define MT_DUALVECTOR4BATCH_HPP
+
+#include <moto/DualVector4.hpp>
+#include <moto/PacketMath.hpp>
+
+namespace mt
+{
+    // Dual quaternion linear blending as in blend, of m poses per lane with one weight per pose, e.g. for
+    // blending whole skeletons in one pass. The array form reads the real x, y, z, w and dual x, y, z, w
+    // streams of pose k from q[k].
+    template <typename Scalar, int N> 
+    Vector4<Dual<Packet<Scalar, N> > > blendBatch(const Vector4<Dual<Packet<Scalar, N> > >* q, const Scalar* weights, int m);
+
+    void blendBatch(const float* const q[][8], const float* weights, int m, float* const v[8], size_t n);
+
+
+    template <typename Scalar, int N> 
+    Vector4<Dual<Packet<Scalar, N> > > blendBatch(const Vector4<Dual<Packet<Scalar, N> > >* q, const Scalar* weights, int m)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        ASSERT(m > 0);
+        Vector4<Lanes> pivot = real(q[0]);
+        Vector4<Lanes> u = pivot * Lanes(weights[0]);
+        Vector4<Lanes> v = dual(q[0]) * Lanes(weights[0]);
+        for (int k = 1; k < m; ++k)
+        {
+            Lanes w = select(isnegative(dot(real(q[k]), pivot)), Lanes(-weights[k]), Lanes(weights[k]));
+            u += real(q[k]) * w;
+            v += dual(q[k]) * w;
+        }
+        Lanes s = Scalar(1) / length(u);
+        return makeDual(u * s, v * s);
+    }
+
+    inline
+    void blendBatch(const float* const q[][8], const float* weights, int m, float* const v[8], size_t n)
+    {
+        typedef FloatPacket Lanes;
+
+        ASSERT(m > 0);
+        for (size_t i = 0; i < n; i += Lanes::SIZE)
+        {
+            Vector4<Lanes> pivot = detail::loadLanes(q[0], i, n);
+            Vector4<Lanes> a = pivot * Lanes(weights[0]);
+            Vector4<Lanes> b = detail::loadLanes(q[0] + 4, i, n) * Lanes(weights[0]);
+            for (int k = 1; k < m; ++k)
+            {
+                Vector4<Lanes> r = detail::loadLanes(q[k], i, n);
+                Lanes w = select(isnegative(dot(r, pivot)), Lanes(-weights[k]), Lanes(weights[k]));
+                a += r * w;
+                b += detail::loadLanes(q[k] + 4, i, n) * w;
+            }
+            Lanes s = 1.0f / length(a);
+            detail::storeLanes(v, i, n, a * s);
+            detail::storeLanes(v + 4, i, n, b * s);
+        }
+    }
+}
+
+#endif
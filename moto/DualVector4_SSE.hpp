@@ -0,0 +1,133 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_DUALVECTOR4_HPP
+#error This header file should be included by DualVector4.hpp only.
+#endif
+
+#include <moto/SSE.hpp>
+
+// The float skinning kernel keeps the real and dual parts of the blended dual quaternion in two
+// registers. If both output streams are 16-byte aligned, vertices are written in groups of four
+// with non-temporal stores, so that large output buffers do not evict the bones and weights from
+// the cache.
+
+namespace mt
+{
+    void skin(const Vector4<Dual<float> >* bones, const int* indices, const float* weights, int influences,
+              const Vector3<float>* positions, const Vector3<float>* normals,
+              Vector3<float>* outPositions, Vector3<float>* outNormals, size_t n);
+
+
+    // The elements of a Dual<float> are stored as (real, dual) pairs.
+    FORCEINLINE
+    void load(__m128& u, __m128& v, const Vector4<Dual<float> >& q)
+    {
+        const float* p = reinterpret_cast<const float*>(&q);
+        __m128 lo = _mm_loadu_ps(p);
+        __m128 hi = _mm_loadu_ps(p + 4);
+        u = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        v = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    // Dot product of all four elements, broadcast to all elements
+    FORCEINLINE
+    __m128 dotSplat(__m128 a, __m128 b)
+    {
+        __m128 tmp = _mm_mul_ps(a, b);
+        tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    FORCEINLINE
+    void blend(__m128& u, __m128& v, const Vector4<Dual<float> >* bones, const int* indices, const float* weights, int influences)
+    {
+        ASSERT(influences > 0);
+        __m128 pivot;
+        load(pivot, v, bones[indices[0]]);
+        __m128 w = _mm_set1_ps(weights[0]);
+        u = _mm_mul_ps(pivot, w);
+        v = _mm_mul_ps(v, w);
+        for (int k = 1; k < influences; ++k)
+        {
+            __m128 qu, qv;
+            load(qu, qv, bones[indices[k]]);
+            // Flip the weight's sign bit if q lies in the opposite hemisphere of the pivot.
+            w = _mm_xor_ps(_mm_set1_ps(weights[k]), _mm_and_ps(dotSplat(qu, pivot), _mm_set1_ps(-0.0f)));
+            u = _mm_add_ps(u, _mm_mul_ps(qu, w));
+            v = _mm_add_ps(v, _mm_mul_ps(qv, w));
+        }
+        __m128 s = dotSplat(u, u);
+        ASSERT(ispositive(_mm_cvtss_f32(s)));
+        s = _mm_sqrt_ps(s);
+        u = _mm_div_ps(u, s);
+        v = _mm_div_ps(v, s);
+    }
+
+    // Rotates p by the unit quaternion u, i.e. p + 2 * cross(u, cross(u, p) + w * p)
+    FORCEINLINE
+    __m128 rotate(__m128 u, __m128 p)
+    {
+        __m128 t = _mm_add_ps(cross3(u, p), _mm_mul_ps(MT_SPLAT(u, 3), p));
+        t = cross3(u, t);
+        return _mm_add_ps(p, _mm_add_ps(t, t));
+    }
+
+    // The translation of the unit dual quaternion u + v e, i.e. 2 * xyz(mul(v, conjugate(u)))
+    FORCEINLINE
+    __m128 translation(__m128 u, __m128 v)
+    {
+        __m128 t = _mm_sub_ps(_mm_mul_ps(MT_SPLAT(u, 3), v), _mm_mul_ps(MT_SPLAT(v, 3), u));
+        t = _mm_add_ps(t, cross3(u, v));
+        return _mm_add_ps(t, t);
+    }
+
+    FORCEINLINE
+    void skin(const Vector4<Dual<float> >* bones, const int* indices, const float* weights, int influences,
+              const Vector3<float>* positions, const Vector3<float>* normals,
+              Vector3<float>* outPositions, Vector3<float>* outNormals, size_t n)
+    {
+        size_t i = 0;
+
+        if (isaligned(outPositions) && (!normals || isaligned(outNormals)))
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128 p[4];
+                __m128 r[4];
+                for (int j = 0; j != 4; ++j)
+                {
+                    __m128 u, v;
+                    blend(u, v, bones, indices + (i + j) * influences, weights + (i + j) * influences, influences);
+                    p[j] = _mm_add_ps(rotate(u, load3(positions[i + j])), translation(u, v));
+                    if (normals)
+                    {
+                        r[j] = rotate(u, load3(normals[i + j]));
+                    }
+                }
+                stream4(outPositions + i, p[0], p[1], p[2], p[3]);
+                if (normals)
+                {
+                    stream4(outNormals + i, r[0], r[1], r[2], r[3]);
+                }
+            }
+            _mm_sfence();
+        }
+
+        for (; i != n; ++i)
+        {
+            __m128 u, v;
+            blend(u, v, bones, indices + i * influences, weights + i * influences, influences);
+            store3(outPositions[i], _mm_add_ps(rotate(u, load3(positions[i])), translation(u, v)));
+            if (normals)
+            {
+                store3(outNormals[i], rotate(u, load3(normals[i])));
+            }
+        }
+    }
+}
@@ -73,6 +73,9 @@ namespace mt
    
     template <typename Scalar1, typename Scalar2>
     Interval<typename Promote<Scalar1, Scalar2>::RT> operator-(const Interval<Scalar1>& z1, const Interval<Scalar2>& z2);
+
+    template <typename Scalar1, typename Scalar2>
+    Interval<typename Promote<Scalar1, Scalar2>::RT> operator*(const Interval<Scalar1>& z1, const Interval<Scalar2>& z2);
        
     
    
@@ -277,7 +280,7 @@ namespace mt
     FORCEINLINE 
     Interval<Scalar> operator*(const Interval<Scalar>& z, Scalar x)
     {
-        return Interval<Scalar>(z.lower() * x, z.upper() * x);
+        return x < Scalar() ? Interval<Scalar>(z.upper() * x, z.lower() * x) : Interval<Scalar>(z.lower() * x, z.upper() * x);
     }
 
     template <typename Scalar>
@@ -298,7 +301,7 @@ namespace mt
     FORCEINLINE 
     Interval<Scalar> operator*(Scalar x, const Interval<Scalar>& z)
     {
-         return Interval<Scalar>(x * z.upper(), x * z.lower());
+         return z * x;
     }
     
     template <typename Scalar1, typename Scalar2>
@@ -319,6 +322,19 @@ namespace mt
         return Interval<RT>(z1.lower() - z2.upper(), z1.upper() - z2.lower());
     }
 
+    template <typename Scalar1, typename Scalar2>
+    FORCEINLINE 
+    Interval<typename Promote<Scalar1, Scalar2>::RT> operator*(const Interval<Scalar1>& z1,
+                                                               const Interval<Scalar2>& z2)
+    {
+        typedef typename Promote<Scalar1, Scalar2>::RT RT; 
+        RT a = z1.lower() * z2.lower();
+        RT b = z1.lower() * z2.upper();
+        RT c = z1.upper() * z2.lower();
+        RT d = z1.upper() * z2.upper();
+        return Interval<RT>(min(min(a, b), min(c, d)), max(max(a, b), max(c, d)));
+    }
+
     template <typename Scalar1, typename Scalar2>
     FORCEINLINE 
     bool overlap(const Interval<Scalar1>& z1, const Interval<Scalar2>& z2)
@@ -405,7 +421,14 @@ namespace mt
 }
 namespace guts
 {
+#if !USE_SSE || !USE_SSE_INTERVAL
     template <> struct TypeTraits<mt::Interval<float> > { enum { ID = TT_FLOAT2 }; };
+#endif
     template <> struct TypeTraits<mt::Interval<double> > { enum { ID = TT_DOUBLE2 }; };
 }
+
+#if USE_SSE
+#include <moto/Interval_SSE.hpp>
+#endif
+
 #endif
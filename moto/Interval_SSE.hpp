@@ -0,0 +1,339 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_INTERVAL_HPP
+#error This header file should be included by Interval.hpp only.
+#endif
+
+#include <moto/SSE.hpp>
+
+// With USE_SSE_INTERVAL, Interval<float> holds (-lower, upper) in the first two elements of a register.
+// Negating the lower bound turns rounding down into rounding up, so under ScopedRoundUp every operation
+// rounds both bounds outward with a single rounding mode, and the bounds are conservative. Under the
+// default round-to-nearest mode, the bounds are off by at most half an ulp, as in the generic version.
+// The bounds are read-only, since lower() cannot return a reference.
+//
+// The compiler assumes round-to-nearest when it folds constants. Compile with -frounding-math (GCC,
+// Clang) or /fp:strict (MSVC) if interval operations may be evaluated at compile time.
+
+namespace mt
+{
+    // Sets the SSE rounding mode to round-up for the lifetime of the guard and restores the previous
+    // mode afterwards. Changing the mode costs a pipeline flush, so put the guard around a whole query
+    // rather than around single operations. It affects all SSE float arithmetic of the current thread.
+    class ScopedRoundUp
+    {
+    public:
+        ScopedRoundUp();
+        ~ScopedRoundUp();
+
+    private:
+        ScopedRoundUp(const ScopedRoundUp&);
+        ScopedRoundUp& operator=(const ScopedRoundUp&);
+
+        unsigned int mSaved;
+    };
+
+#if USE_SSE_INTERVAL
+
+    template <>
+    class Interval<float>
+    {
+    public:
+        typedef float ScalarType;
+
+        Interval();
+        Interval(float x);
+        Interval(float lower, float upper);
+        template <typename Scalar2> Interval(const Interval<Scalar2>& z);
+        explicit Interval(__m128 v);
+
+        float lower() const;
+        float upper() const;
+
+        Interval<float>& operator=(float x);
+        Interval<float>& operator+=(float x);
+        Interval<float>& operator-=(float x);
+
+        template <typename Scalar2> Interval<float>& operator=(const Interval<Scalar2>& z);
+        Interval<float>& operator+=(const Interval<float>& z);
+        Interval<float>& operator-=(const Interval<float>& z);
+
+        __m128 vec;
+    };
+
+    Interval<float> operator-(const Interval<float>& z);
+
+    Interval<float> operator+(const Interval<float>& z, float x);
+    Interval<float> operator-(const Interval<float>& z, float x);
+    Interval<float> operator*(const Interval<float>& z, float x);
+
+    Interval<float> operator+(float x, const Interval<float>& z);
+    Interval<float> operator-(float x, const Interval<float>& z);
+    Interval<float> operator*(float x, const Interval<float>& z);
+
+    Interval<float> operator+(const Interval<float>& z1, const Interval<float>& z2);
+    Interval<float> operator-(const Interval<float>& z1, const Interval<float>& z2);
+    Interval<float> operator*(const Interval<float>& z1, const Interval<float>& z2);
+
+    float width(const Interval<float>& z);
+
+    bool overlap(const Interval<float>& z1, const Interval<float>& z2);
+    bool subset(const Interval<float>& z1, const Interval<float>& z2);
+    bool in(float x, const Interval<float>& z);
+
+    Interval<float> hull(float x, float y);
+    Interval<float> hull(const Interval<float>& z, float x);
+    Interval<float> hull(float x, const Interval<float>& z);
+    Interval<float> hull(const Interval<float>& z1, const Interval<float>& z2);
+
+#endif
+
+
+    FORCEINLINE
+    ScopedRoundUp::ScopedRoundUp()
+        : mSaved(_mm_getcsr())
+    {
+        _mm_setcsr((mSaved & ~_MM_ROUND_MASK) | _MM_ROUND_UP);
+    }
+
+    FORCEINLINE
+    ScopedRoundUp::~ScopedRoundUp()
+    {
+        _mm_setcsr(mSaved);
+    }
+
+#if USE_SSE_INTERVAL
+
+    // Swaps -lower and upper, i.e. negates the interval.
+#define MT_INTERVAL_SWAP(v) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(3, 2, 0, 1))
+
+    FORCEINLINE
+    Interval<float>::Interval()
+        : vec(_mm_setzero_ps())
+    {}
+
+    FORCEINLINE
+    Interval<float>::Interval(float x)
+        : vec(_mm_setr_ps(-x, x, 0.0f, 0.0f))
+    {}
+
+    FORCEINLINE
+    Interval<float>::Interval(float lower, float upper)
+        : vec(_mm_setr_ps(-lower, upper, 0.0f, 0.0f))
+    {
+        ASSERT(!(upper < lower));
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    Interval<float>::Interval(const Interval<Scalar2>& z)
+        : vec(_mm_setr_ps(-float(z.lower()), float(z.upper()), 0.0f, 0.0f))
+    {}
+
+    FORCEINLINE
+    Interval<float>::Interval(__m128 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    float Interval<float>::lower() const
+    {
+        return -_mm_cvtss_f32(vec);
+    }
+
+    FORCEINLINE
+    float Interval<float>::upper() const
+    {
+        return _mm_cvtss_f32(MT_SPLAT(vec, 1));
+    }
+
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator=(float x)
+    {
+        vec = _mm_setr_ps(-x, x, 0.0f, 0.0f);
+        return *this;
+    }
+
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator+=(float x)
+    {
+        vec = _mm_add_ps(vec, _mm_setr_ps(-x, x, 0.0f, 0.0f));
+        return *this;
+    }
+
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator-=(float x)
+    {
+        vec = _mm_add_ps(vec, _mm_setr_ps(x, -x, 0.0f, 0.0f));
+        return *this;
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator=(const Interval<Scalar2>& z)
+    {
+        vec = Interval<float>(z).vec;
+        return *this;
+    }
+
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator+=(const Interval<float>& z)
+    {
+        vec = _mm_add_ps(vec, z.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Interval<float>& Interval<float>::operator-=(const Interval<float>& z)
+    {
+        vec = _mm_add_ps(vec, MT_INTERVAL_SWAP(z.vec));
+        return *this;
+    }
+
+    FORCEINLINE
+    Interval<float> operator-(const Interval<float>& z)
+    {
+        return Interval<float>(MT_INTERVAL_SWAP(z.vec));
+    }
+
+    FORCEINLINE
+    Interval<float> operator+(const Interval<float>& z, float x)
+    {
+        return Interval<float>(_mm_add_ps(z.vec, _mm_setr_ps(-x, x, 0.0f, 0.0f)));
+    }
+
+    FORCEINLINE
+    Interval<float> operator-(const Interval<float>& z, float x)
+    {
+        return Interval<float>(_mm_add_ps(z.vec, _mm_setr_ps(x, -x, 0.0f, 0.0f)));
+    }
+
+    FORCEINLINE
+    Interval<float> operator*(const Interval<float>& z, float x)
+    {
+        // A negative factor swaps the bounds. Multiplying by |x| keeps the signs of -lower and upper
+        // apart, so the products round outward.
+        __m128 s = _mm_set1_ps(x);
+        __m128 negative = _mm_cmplt_ps(s, _mm_setzero_ps());
+        __m128 v = _mm_or_ps(_mm_and_ps(negative, MT_INTERVAL_SWAP(z.vec)), _mm_andnot_ps(negative, z.vec));
+        return Interval<float>(_mm_mul_ps(v, _mm_andnot_ps(_mm_set1_ps(-0.0f), s)));
+    }
+
+    FORCEINLINE
+    Interval<float> operator+(float x, const Interval<float>& z)
+    {
+        return z + x;
+    }
+
+    FORCEINLINE
+    Interval<float> operator-(float x, const Interval<float>& z)
+    {
+        return Interval<float>(_mm_add_ps(MT_INTERVAL_SWAP(z.vec), _mm_setr_ps(-x, x, 0.0f, 0.0f)));
+    }
+
+    FORCEINLINE
+    Interval<float> operator*(float x, const Interval<float>& z)
+    {
+        return z * x;
+    }
+
+    FORCEINLINE
+    Interval<float> operator+(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        return Interval<float>(_mm_add_ps(z1.vec, z2.vec));
+    }
+
+    FORCEINLINE
+    Interval<float> operator-(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        return Interval<float>(_mm_add_ps(z1.vec, MT_INTERVAL_SWAP(z2.vec)));
+    }
+
+    FORCEINLINE
+    Interval<float> operator*(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        // With a = (-l1, -l1, u1, u1) and b = (l2, u2, -l2, -u2), the elements of a * b are the four
+        // products of the bounds negated, and those of a * -b the products themselves. Their maxima are
+        // -lower and upper, each rounded up.
+        __m128 a = _mm_shuffle_ps(z1.vec, z1.vec, _MM_SHUFFLE(1, 1, 0, 0));
+        __m128 b = _mm_shuffle_ps(z2.vec, z2.vec, _MM_SHUFFLE(1, 0, 1, 0));
+        b = _mm_xor_ps(b, _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
+        __m128 p = _mm_mul_ps(a, b);
+        __m128 q = _mm_mul_ps(a, _mm_xor_ps(b, _mm_set1_ps(-0.0f)));
+        // (max(p0, p2), max(q0, q2), max(p1, p3), max(q1, q3))
+        __m128 m = _mm_max_ps(_mm_unpacklo_ps(p, q), _mm_unpackhi_ps(p, q));
+        return Interval<float>(_mm_max_ps(m, _mm_movehl_ps(m, m)));
+    }
+
+    FORCEINLINE
+    float width(const Interval<float>& z)
+    {
+        // upper + -lower, rounded up under ScopedRoundUp
+        return _mm_cvtss_f32(_mm_add_ss(z.vec, MT_SPLAT(z.vec, 1)));
+    }
+
+    FORCEINLINE
+    bool overlap(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        // -lower1 >= -upper2 and upper1 >= lower2, i.e. !(z1.upper() < z2.lower() || z2.upper() < z1.lower())
+        return (_mm_movemask_ps(_mm_cmpnlt_ps(z1.vec, _mm_xor_ps(MT_INTERVAL_SWAP(z2.vec), _mm_set1_ps(-0.0f)))) & 0x3) == 0x3;
+    }
+
+    FORCEINLINE
+    bool subset(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        // -lower2 >= -lower1 and upper2 >= upper1
+        return (_mm_movemask_ps(_mm_cmpnlt_ps(z2.vec, z1.vec)) & 0x3) == 0x3;
+    }
+
+    FORCEINLINE
+    bool in(float x, const Interval<float>& z)
+    {
+        return subset(Interval<float>(x), z);
+    }
+
+    FORCEINLINE
+    Interval<float> hull(float x, float y)
+    {
+        return hull(Interval<float>(x), Interval<float>(y));
+    }
+
+    FORCEINLINE
+    Interval<float> hull(const Interval<float>& z, float x)
+    {
+        return hull(z, Interval<float>(x));
+    }
+
+    FORCEINLINE
+    Interval<float> hull(float x, const Interval<float>& z)
+    {
+        return hull(z, Interval<float>(x));
+    }
+
+    FORCEINLINE
+    Interval<float> hull(const Interval<float>& z1, const Interval<float>& z2)
+    {
+        return Interval<float>(_mm_max_ps(z1.vec, z2.vec));
+    }
+
+#undef MT_INTERVAL_SWAP
+
+#endif
+}
+
+#if USE_SSE_INTERVAL
+
+namespace guts
+{
+    // Packed intervals are four-element records of (-lower, upper) and two unused elements, so they
+    // cannot be read as the (lower, upper) pairs of the generic version.
+    template <> struct TypeTraits<mt::Interval<float> > { enum { ID = TT_FLOAT4 }; };
+}
+
+#endif
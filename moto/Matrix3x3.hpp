@@ -145,6 +145,7 @@ namespace mt
     template <typename Scalar> Matrix3x3<Scalar> transpose(const Matrix3x3<Scalar>& a);
     template <typename Scalar> Matrix3x3<Scalar> adjoint(const Matrix3x3<Scalar>& a);
     template <typename Scalar> Matrix3x3<Scalar> inverse(const Matrix3x3<Scalar>& a);
+    template <typename Scalar, typename Policy> Matrix3x3<Scalar> inverse(const Matrix3x3<Scalar>& a, Policy p);
     template <typename Scalar> Matrix3x3<Scalar> orthonormalize(const Matrix3x3<Scalar>& a);
     template <typename Scalar> Scalar trace(const Matrix3x3<Scalar>& a);  
     template <typename Scalar> Vector4<Scalar> rotation(const Matrix3x3<Scalar>& a);
@@ -158,6 +159,18 @@ namespace mt
     template <typename Scalar> Vector3<Scalar> solveTranspose(const Matrix3x3<Scalar>& a, const Vector3<Scalar>& v);
     template <typename Scalar> Vector3<Scalar> solve(const Matrix3x3<Scalar>& a, const Vector3<Scalar>& v);
 
+    // Singular value decomposition a = u diag(sigma) v^T by cyclic Jacobi rotations on a^T a followed by a
+    // Givens QR decomposition of a v. Both u and v are rotations, so sigma is sorted by decreasing magnitude
+    // and sigma.z is negative if a is a reflection. The number of sweeps is fixed and all conditionals are
+    // selects, so the same code runs lane-wise on Matrix3x3<Packet>. Four sweeps are enough for float,
+    // six for double.
+    template <typename Scalar>
+    void svd(const Matrix3x3<Scalar>& a, Matrix3x3<Scalar>& u, Vector3<Scalar>& sigma, Matrix3x3<Scalar>& v, int sweeps = 4);
+
+    // Polar decomposition a = r s, where r is the rotation nearest to a and s is symmetric.
+    template <typename Scalar>
+    void polar(const Matrix3x3<Scalar>& a, Matrix3x3<Scalar>& r, Matrix3x3<Scalar>& s, int sweeps = 4);
+
     template <typename Scalar1, typename Scalar2> void convert(Scalar1* v, const Matrix3x3<Scalar2>& a);
        
       
@@ -659,13 +672,20 @@ namespace mt
     template <typename Scalar>
     FORCEINLINE 
     Matrix3x3<Scalar> inverse(const Matrix3x3<Scalar>& a)
+    {
+        return inverse<Scalar>(a, Exact());
+    }
+
+    template <typename Scalar, typename Policy>
+    FORCEINLINE 
+    Matrix3x3<Scalar> inverse(const Matrix3x3<Scalar>& a, Policy p)
     {
         Vector3<Scalar> co(cofactor<0, 0>(a), 
                            cofactor<0, 1>(a), 
                            cofactor<0, 2>(a));
         Scalar det = dot(a[0], co);
         ASSERT(!iszero(det));
-        Scalar s = Scalar(1) / det;
+        Scalar s = rcp(det, p);
         return Matrix3x3<Scalar>(co[0] * s, cofactor<1, 0>(a) * s, cofactor<2, 0>(a) * s, 
                                  co[1] * s, cofactor<1, 1>(a) * s, cofactor<2, 1>(a) * s,
                                  co[2] * s, cofactor<1, 2>(a) * s, cofactor<2, 2>(a) * s);
@@ -810,6 +830,134 @@ namespace mt
         return solveTranspose(transpose(a), v);
     }     
     
+    namespace detail
+    {
+        // A Jacobi rotation in the (p, q) plane that annihilates s[p][q] of the symmetric matrix s, accumulated in v
+        template <int p, int q, typename Scalar>
+        FORCEINLINE
+        void jacobiRotate(Matrix3x3<Scalar>& s, Matrix3x3<Scalar>& v)
+        {
+            const int r = 3 - p - q;
+            Scalar apq = s[p][q];
+            Scalar d = s[q][q] - s[p][p];
+
+            // t = tan(angle), the smaller root of t^2 + (d / apq) t - 1 = 0, or zero if apq and d are zero.
+            Scalar den = abs(d) + sqrt(d * d + Scalar(4) * apq * apq);
+            Scalar t = select(isnegative(d), Scalar(-2), Scalar(2)) * apq / select(iszero(den), Scalar(1), den);
+            Scalar c = rsqrt(t * t + Scalar(1));
+            Scalar sn = t * c;
+
+            s[p][p] -= t * apq;
+            s[q][q] += t * apq;
+            s[p][q] = s[q][p] = Scalar();
+            Scalar srp = s[r][p];
+            Scalar srq = s[r][q];
+            s[r][p] = s[p][r] = c * srp - sn * srq;
+            s[r][q] = s[q][r] = sn * srp + c * srq;
+
+            for (int i = 0; i != 3; ++i)
+            {
+                Scalar vp = v[i][p];
+                Scalar vq = v[i][q];
+                v[i][p] = c * vp - sn * vq;
+                v[i][q] = sn * vp + c * vq;
+            }
+        }
+
+        // A Givens rotation of rows k and r of b that annihilates b[r][k], with its transpose accumulated in u
+        template <int k, int r, typename Scalar>
+        FORCEINLINE
+        void givensRotate(Matrix3x3<Scalar>& b, Matrix3x3<Scalar>& u)
+        {
+            Scalar x = b[k][k];
+            Scalar y = b[r][k];
+            Scalar rho2 = x * x + y * y;
+            Scalar w = rsqrt(select(iszero(rho2), Scalar(1), rho2));
+            Scalar c = select(iszero(rho2), Scalar(1), x * w);
+            Scalar s = y * w;
+
+            for (int j = 0; j != 3; ++j)
+            {
+                Scalar bk = b[k][j];
+                Scalar br = b[r][j];
+                b[k][j] = c * bk + s * br;
+                b[r][j] = c * br - s * bk;
+            }
+
+            for (int i = 0; i != 3; ++i)
+            {
+                Scalar uk = u[i][k];
+                Scalar ur = u[i][r];
+                u[i][k] = c * uk + s * ur;
+                u[i][r] = c * ur - s * uk;
+            }
+        }
+
+        // Replaces (x, y) by (y, -x) where the condition holds, which for columns of a rotation keeps it a rotation.
+        template <typename Mask, typename Scalar>
+        FORCEINLINE
+        void rotateIf(Mask condition, Scalar& x, Scalar& y)
+        {
+            Scalar t = select(condition, y, x);
+            y = select(condition, -x, y);
+            x = t;
+        }
+
+        // Swaps columns i and j of b and v if column j of b is longer.
+        template <int i, int j, typename Scalar>
+        FORCEINLINE
+        void sortColumns(Matrix3x3<Scalar>& b, Matrix3x3<Scalar>& v, Vector3<Scalar>& n)
+        {
+            for (int k = 0; k != 3; ++k)
+            {
+                rotateIf(n[i] < n[j], b[k][i], b[k][j]);
+                rotateIf(n[i] < n[j], v[k][i], v[k][j]);
+            }
+            Scalar t = max(n[i], n[j]);
+            n[j] = min(n[i], n[j]);
+            n[i] = t;
+        }
+    }
+
+    template <typename Scalar>
+    void svd(const Matrix3x3<Scalar>& a, Matrix3x3<Scalar>& u, Vector3<Scalar>& sigma, Matrix3x3<Scalar>& v, int sweeps)
+    {
+        // The eigenvectors of a^T a are the right singular vectors.
+        Matrix3x3<Scalar> s = transposeMul(a, a);
+        v = Matrix3x3<Scalar>(Identity());
+        for (int k = 0; k != sweeps; ++k)
+        {
+            detail::jacobiRotate<0, 1>(s, v);
+            detail::jacobiRotate<0, 2>(s, v);
+            detail::jacobiRotate<1, 2>(s, v);
+        }
+
+        // The columns of a v are the left singular vectors scaled by the singular values.
+        Matrix3x3<Scalar> b = mul(a, v);
+        Vector3<Scalar> n(dot(column(b, 0), column(b, 0)), dot(column(b, 1), column(b, 1)), dot(column(b, 2), column(b, 2)));
+        detail::sortColumns<0, 1>(b, v, n);
+        detail::sortColumns<0, 2>(b, v, n);
+        detail::sortColumns<1, 2>(b, v, n);
+
+        // b = u r, with r upper triangular. Since the columns of b are orthogonal, r is diagonal up to rounding.
+        u = Matrix3x3<Scalar>(Identity());
+        detail::givensRotate<0, 1>(b, u);
+        detail::givensRotate<0, 2>(b, u);
+        detail::givensRotate<1, 2>(b, u);
+        sigma = Vector3<Scalar>(b[0][0], b[1][1], b[2][2]);
+    }
+
+    template <typename Scalar>
+    void polar(const Matrix3x3<Scalar>& a, Matrix3x3<Scalar>& r, Matrix3x3<Scalar>& s, int sweeps)
+    {
+        Matrix3x3<Scalar> u;
+        Matrix3x3<Scalar> v;
+        Vector3<Scalar> sigma;
+        svd(a, u, sigma, v, sweeps);
+        r = mulTranspose(u, v);
+        s = mulTranspose(mul(v, diag(sigma)), v);
+    }
+
     template <typename Scalar1, typename Scalar2> 
     FORCEINLINE 
     void convert(Scalar1* v, const Matrix3x3<Scalar2>& a)
@@ -827,4 +975,8 @@ namespace guts
     template <> struct TypeTraits<mt::Matrix3x3<double> > { enum { ID = TT_DOUBLE3 | TT_3 }; };
 }
 
+#if USE_SSE
+#include <moto/Matrix3x3_SSE.hpp>
+#endif
+
 #endif
@@ -0,0 +1,253 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_MATRIX3X3BATCH_HPP
+#define MT_MATRIX3X3BATCH_HPP
+
+#include <moto/Matrix3x3.hpp>
+#include <moto/PacketMath.hpp>
+
+namespace mt
+{
+    // Batched factorizations of symmetric matrices with one system per lane. Only the lower triangles of the
+    // matrices are read. cholesky returns the lanes that are not positive definite, i.e., have a pivot not
+    // above the tolerance. From the failing pivot on, the factor of such a lane is zero, and choleskySolve
+    // returns zero for it.
+    template <typename Scalar, int N>
+    PacketMask<N> cholesky(const Matrix3x3<Packet<Scalar, N> >& a, Matrix3x3<Packet<Scalar, N> >& l, Scalar tolerance = Scalar());
+    template <typename Scalar, int N>
+    Vector3<Packet<Scalar, N> > choleskySolve(const Matrix3x3<Packet<Scalar, N> >& l, const Vector3<Packet<Scalar, N> >& b);
+
+    // a = l diag(d) l^T, with l unit lower triangular. Being free of square roots, it handles semidefinite
+    // and indefinite matrices. Pivots with a magnitude not above tolerance times the largest diagonal
+    // element are set to zero, and ldlt returns the lanes that have one. ldltSolve skips the components of
+    // zero pivots, which for a consistent semidefinite system yields a solution.
+    template <typename Scalar, int N>
+    PacketMask<N> ldlt(const Matrix3x3<Packet<Scalar, N> >& a, Matrix3x3<Packet<Scalar, N> >& l, Vector3<Packet<Scalar, N> >& d,
+                       Scalar tolerance = Scalar(1e-6));
+    template <typename Scalar, int N>
+    Vector3<Packet<Scalar, N> > ldltSolve(const Matrix3x3<Packet<Scalar, N> >& l, const Vector3<Packet<Scalar, N> >& d,
+                                          const Vector3<Packet<Scalar, N> >& b);
+
+    // The same over n systems stored as structure-of-arrays streams. The lower triangles are the six
+    // streams (a00, a10, a11, a20, a21, a22), the factors use the same layout, the LDL^T factor l holds
+    // (l10, l20, l21), and vectors are three streams. x may alias b. The returned lanes set bit i % 32 of
+    // flags[i / 32] for system i.
+    void cholesky(const float* const a[6], float* const l[6], uint32_t* flags, size_t n, float tolerance = 0.0f);
+    void choleskySolve(const float* const l[6], const float* const b[3], float* const x[3], size_t n);
+    void ldlt(const float* const a[6], float* const l[3], float* const d[3], uint32_t* flags, size_t n, float tolerance = 1e-6f);
+    void ldltSolve(const float* const l[3], const float* const d[3], const float* const b[3], float* const x[3], size_t n);
+
+
+    template <typename Scalar, int N>
+    PacketMask<N> cholesky(const Matrix3x3<Packet<Scalar, N> >& a, Matrix3x3<Packet<Scalar, N> >& l, Scalar tolerance)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        PacketMask<N> ok = ~PacketMask<N>(0);
+        l = Matrix3x3<Lanes>(Zero());
+        for (int k = 0; k != 3; ++k)
+        {
+            Lanes pivot = a[k][k];
+            for (int j = 0; j != k; ++j)
+            {
+                pivot -= l[k][j] * l[k][j];
+            }
+
+            // Once a lane fails, its remaining columns stay zero. NaN pivots fail as well.
+            ok &= pivot > Lanes(tolerance);
+            Lanes lkk = select(ok, sqrt(pivot), Lanes());
+            Lanes r = select(ok, Scalar(1) / select(ok, lkk, Lanes(Scalar(1))), Lanes());
+            l[k][k] = lkk;
+            for (int i = k + 1; i != 3; ++i)
+            {
+                Lanes x = a[i][k];
+                for (int j = 0; j != k; ++j)
+                {
+                    x -= l[i][j] * l[k][j];
+                }
+                l[i][k] = x * r;
+            }
+        }
+        return ~ok;
+    }
+
+    template <typename Scalar, int N>
+    Vector3<Packet<Scalar, N> > choleskySolve(const Matrix3x3<Packet<Scalar, N> >& l, const Vector3<Packet<Scalar, N> >& b)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        PacketMask<N> singular = iszero(l[0][0]) | iszero(l[1][1]) | iszero(l[2][2]);
+        Lanes one(Scalar(1));
+        Lanes r0 = one / select(singular, one, l[0][0]);
+        Lanes r1 = one / select(singular, one, l[1][1]);
+        Lanes r2 = one / select(singular, one, l[2][2]);
+
+        // l y = b, then l^T x = y
+        Lanes y0 = b[0] * r0;
+        Lanes y1 = (b[1] - l[1][0] * y0) * r1;
+        Lanes y2 = (b[2] - l[2][0] * y0 - l[2][1] * y1) * r2;
+        Lanes x2 = y2 * r2;
+        Lanes x1 = (y1 - l[2][1] * x2) * r1;
+        Lanes x0 = (y0 - l[1][0] * x1 - l[2][0] * x2) * r0;
+        return Vector3<Lanes>(select(singular, Lanes(), x0), select(singular, Lanes(), x1), select(singular, Lanes(), x2));
+    }
+
+    template <typename Scalar, int N>
+    PacketMask<N> ldlt(const Matrix3x3<Packet<Scalar, N> >& a, Matrix3x3<Packet<Scalar, N> >& l, Vector3<Packet<Scalar, N> >& d,
+                       Scalar tolerance)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        Lanes threshold = max(max(abs(a[0][0]), abs(a[1][1])), abs(a[2][2])) * tolerance;
+        PacketMask<N> degenerate(0);
+        l = Matrix3x3<Lanes>(Lanes(Scalar(1)));
+        for (int k = 0; k != 3; ++k)
+        {
+            Lanes pivot = a[k][k];
+            for (int j = 0; j != k; ++j)
+            {
+                pivot -= l[k][j] * l[k][j] * d[j];
+            }
+
+            PacketMask<N> zero = ~(abs(pivot) > threshold);
+            degenerate |= zero;
+            d[k] = select(zero, Lanes(), pivot);
+            Lanes r = select(zero, Lanes(), Scalar(1) / select(zero, Lanes(Scalar(1)), pivot));
+            for (int i = k + 1; i != 3; ++i)
+            {
+                Lanes x = a[i][k];
+                for (int j = 0; j != k; ++j)
+                {
+                    x -= l[i][j] * l[k][j] * d[j];
+                }
+                l[i][k] = x * r;
+            }
+        }
+        return degenerate;
+    }
+
+    template <typename Scalar, int N>
+    Vector3<Packet<Scalar, N> > ldltSolve(const Matrix3x3<Packet<Scalar, N> >& l, const Vector3<Packet<Scalar, N> >& d,
+                                          const Vector3<Packet<Scalar, N> >& b)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        // l y = b, z = d^+ y, then l^T x = z
+        Lanes y0 = b[0];
+        Lanes y1 = b[1] - l[1][0] * y0;
+        Lanes y2 = b[2] - l[2][0] * y0 - l[2][1] * y1;
+        Lanes z[3];
+        Lanes y[3] = { y0, y1, y2 };
+        for (int k = 0; k != 3; ++k)
+        {
+            PacketMask<N> zero = iszero(d[k]);
+            z[k] = select(zero, Lanes(), y[k] / select(zero, Lanes(Scalar(1)), d[k]));
+        }
+        Lanes x2 = z[2];
+        Lanes x1 = z[1] - l[2][1] * x2;
+        Lanes x0 = z[0] - l[1][0] * x1 - l[2][0] * x2;
+        return Vector3<Lanes>(x0, x1, x2);
+    }
+
+    namespace detail
+    {
+        // Lanes i to i + N of the lower triangles in a, padded with the identity past n
+        FORCEINLINE
+        Matrix3x3<FloatPacket> loadLowerLanes(const float* const a[6], size_t i, size_t n)
+        {
+            Matrix3x3<FloatPacket> result;
+            result[0][0] = detail::loadLanes(a[0], i, n, 1.0f);
+            result[1][0] = detail::loadLanes(a[1], i, n);
+            result[1][1] = detail::loadLanes(a[2], i, n, 1.0f);
+            result[2][0] = detail::loadLanes(a[3], i, n);
+            result[2][1] = detail::loadLanes(a[4], i, n);
+            result[2][2] = detail::loadLanes(a[5], i, n, 1.0f);
+            return result;
+        }
+
+        // Sets the bits of lanes i to i + N in flags
+        FORCEINLINE
+        void storeFlags(uint32_t* flags, size_t i, size_t n, uint32_t bits)
+        {
+            const size_t N = FloatPacket::SIZE;
+            if (i + N > n)
+            {
+                bits &= (1u << (n - i)) - 1;
+            }
+            bits <<= i % 32;
+            flags[i / 32] = i % 32 == 0 ? bits : flags[i / 32] | bits;
+        }
+    }
+
+    inline
+    void cholesky(const float* const a[6], float* const l[6], uint32_t* flags, size_t n, float tolerance)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            Matrix3x3<FloatPacket> li;
+            detail::storeFlags(flags, i, n, cholesky(detail::loadLowerLanes(a, i, n), li, tolerance).bits());
+            detail::storeLanes(l[0], i, n, li[0][0]);
+            detail::storeLanes(l[1], i, n, li[1][0]);
+            detail::storeLanes(l[2], i, n, li[1][1]);
+            detail::storeLanes(l[3], i, n, li[2][0]);
+            detail::storeLanes(l[4], i, n, li[2][1]);
+            detail::storeLanes(l[5], i, n, li[2][2]);
+        }
+    }
+
+    inline
+    void choleskySolve(const float* const l[6], const float* const b[3], float* const x[3], size_t n)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            Vector3<FloatPacket> bi(detail::loadLanes(b[0], i, n), detail::loadLanes(b[1], i, n), detail::loadLanes(b[2], i, n));
+            Vector3<FloatPacket> xi = choleskySolve(detail::loadLowerLanes(l, i, n), bi);
+            detail::storeLanes(x[0], i, n, xi[0]);
+            detail::storeLanes(x[1], i, n, xi[1]);
+            detail::storeLanes(x[2], i, n, xi[2]);
+        }
+    }
+
+    inline
+    void ldlt(const float* const a[6], float* const l[3], float* const d[3], uint32_t* flags, size_t n, float tolerance)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            Matrix3x3<FloatPacket> li;
+            Vector3<FloatPacket> di;
+            detail::storeFlags(flags, i, n, ldlt(detail::loadLowerLanes(a, i, n), li, di, tolerance).bits());
+            detail::storeLanes(l[0], i, n, li[1][0]);
+            detail::storeLanes(l[1], i, n, li[2][0]);
+            detail::storeLanes(l[2], i, n, li[2][1]);
+            detail::storeLanes(d[0], i, n, di[0]);
+            detail::storeLanes(d[1], i, n, di[1]);
+            detail::storeLanes(d[2], i, n, di[2]);
+        }
+    }
+
+    inline
+    void ldltSolve(const float* const l[3], const float* const d[3], const float* const b[3], float* const x[3], size_t n)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            Matrix3x3<FloatPacket> li(FloatPacket(1.0f));
+            li[1][0] = detail::loadLanes(l[0], i, n);
+            li[2][0] = detail::loadLanes(l[1], i, n);
+            li[2][1] = detail::loadLanes(l[2], i, n);
+            Vector3<FloatPacket> di(detail::loadLanes(d[0], i, n), detail::loadLanes(d[1], i, n), detail::loadLanes(d[2], i, n));
+            Vector3<FloatPacket> bi(detail::loadLanes(b[0], i, n), detail::loadLanes(b[1], i, n), detail::loadLanes(b[2], i, n));
+            Vector3<FloatPacket> xi = ldltSolve(li, di, bi);
+            detail::storeLanes(x[0], i, n, xi[0]);
+            detail::storeLanes(x[1], i, n, xi[1]);
+            detail::storeLanes(x[2], i, n, xi[2]);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,287 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_MATRIX3X3_HPP
+#error This header file should be included by Matrix3x3.hpp only.
+#endif
+
+// The rows of Matrix3x3<float> are packed, so they are loaded into registers and stored back three
+// elements at a time. The fourth elements of the registers are ignored.
+
+namespace mt
+{
+    Vector3<float> mul(const Matrix3x3<float>& a, const Vector3<float>& v);
+    Vector3<float> mul(const Vector3<float>& v, const Matrix3x3<float>& a);
+
+    Matrix3x3<float> mul(const Matrix3x3<float>& a, const Matrix3x3<float>& b);
+    Matrix3x3<float> transposeMul(const Matrix3x3<float>& a, const Matrix3x3<float>& b);
+    Matrix3x3<float> mulTranspose(const Matrix3x3<float>& a, const Matrix3x3<float>& b);
+
+    float determinant(const Matrix3x3<float>& a);
+    Matrix3x3<float> transpose(const Matrix3x3<float>& a);
+    Matrix3x3<float> inverse(const Matrix3x3<float>& a);
+    template <typename Policy> Matrix3x3<float> inverse(const Matrix3x3<float>& a, Policy p);
+    Matrix3x3<float> orthonormalize(const Matrix3x3<float>& a);
+    Vector4<float> rotation(const Matrix3x3<float>& a);
+
+    Matrix3x3<float> cholesky(const Matrix3x3<float> a);
+    Vector3<float> solveTranspose(const Matrix3x3<float>& a, const Vector3<float>& v);
+    Vector3<float> solve(const Matrix3x3<float>& a, const Vector3<float>& v);
+
+
+    // The first two rows are read four elements at a time, which stays inside the matrix.
+    FORCEINLINE
+    void loadRows(const Matrix3x3<float>& a, __m128& r0, __m128& r1, __m128& r2)
+    {
+        r0 = _mm_loadu_ps(&a[0].x);
+        r1 = _mm_loadu_ps(&a[1].x);
+        r2 = load3(a[2]);
+    }
+
+    // Each row store spills into the next row, which is stored after it.
+    FORCEINLINE
+    Matrix3x3<float> storeRows(__m128 r0, __m128 r1, __m128 r2)
+    {
+        Matrix3x3<float> result;
+        _mm_storeu_ps(&result[0].x, r0);
+        _mm_storeu_ps(&result[1].x, r1);
+        store3(result[2], r2);
+        return result;
+    }
+
+    FORCEINLINE
+    Vector3<float> storeVector3(__m128 v)
+    {
+        Vector3<float> result;
+        store3(result, v);
+        return result;
+    }
+
+    FORCEINLINE
+    Vector3<float> mul(const Matrix3x3<float>& a, const Vector3<float>& v)
+    {
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        __m128 u = load3(v);
+
+        __m128 tmp0 = _mm_mul_ps(r0, u);
+        __m128 tmp1 = _mm_mul_ps(r1, u);
+        __m128 tmp2 = _mm_mul_ps(r2, u);
+        __m128 tmp3 = _mm_setzero_ps();
+
+        transpose(tmp0, tmp1, tmp2, tmp3);
+
+        return storeVector3(_mm_add_ps(_mm_add_ps(tmp0, tmp1), tmp2));
+    }
+
+    FORCEINLINE
+    Vector3<float> mul(const Vector3<float>& v, const Matrix3x3<float>& a)
+    {
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        return storeVector3(combine3(load3(v), r0, r1, r2));
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> mul(const Matrix3x3<float>& a, const Matrix3x3<float>& b)
+    {
+        __m128 a0, a1, a2;
+        loadRows(a, a0, a1, a2);
+        __m128 b0, b1, b2;
+        loadRows(b, b0, b1, b2);
+        return storeRows(combine3(a0, b0, b1, b2),
+                         combine3(a1, b0, b1, b2),
+                         combine3(a2, b0, b1, b2));
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> transposeMul(const Matrix3x3<float>& a, const Matrix3x3<float>& b)
+    {
+        return mul(transpose(a), b);
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> mulTranspose(const Matrix3x3<float>& a, const Matrix3x3<float>& b)
+    {
+        return mul(a, transpose(b));
+    }
+
+    FORCEINLINE
+    float determinant(const Matrix3x3<float>& a)
+    {
+        return dot(a[0], cross(a[1], a[2]));
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> transpose(const Matrix3x3<float>& a)
+    {
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        __m128 r3 = _mm_setzero_ps();
+
+        transpose(r0, r1, r2, r3);
+
+        return storeRows(r0, r1, r2);
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> inverse(const Matrix3x3<float>& a)
+    {
+        return inverse(a, Exact());
+    }
+
+    template <typename Policy>
+    FORCEINLINE
+    Matrix3x3<float> inverse(const Matrix3x3<float>& a, Policy p)
+    {
+        // The columns of the inverse are the cross products of the rows over the determinant.
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        __m128 c0 = cross3(r1, r2);
+        __m128 c1 = cross3(r2, r0);
+        __m128 c2 = cross3(r0, r1);
+        __m128 c3 = _mm_setzero_ps();
+
+        float det = dot(a[0], storeVector3(c0));
+        ASSERT(!iszero(det));
+
+        transpose(c0, c1, c2, c3);
+
+        __m128 s = _mm_set1_ps(rcp(det, p));
+        return storeRows(_mm_mul_ps(c0, s), _mm_mul_ps(c1, s), _mm_mul_ps(c2, s));
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> orthonormalize(const Matrix3x3<float>& a)
+    {
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        r0 = normalize3(r0);
+        r2 = cross3(r0, normalize3(r1));
+        return storeRows(r0, cross3(r2, r0), r2);
+    }
+
+    FORCEINLINE
+    Vector4<float> rotation(const Matrix3x3<float>& a)
+    {
+        // Computes 4 * square of each element at once, i.e. (1 + a00 - a11 - a22, 1 - a00 + a11 - a22,
+        // 1 - a00 - a11 + a22, 1 + a00 + a11 + a22), and derives the other elements from the largest one.
+        __m128 m = _mm_set1_ps(1.0f);
+        m = _mm_add_ps(m, _mm_mul_ps(_mm_set1_ps(a[0][0]), _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f)));
+        m = _mm_add_ps(m, _mm_mul_ps(_mm_set1_ps(a[1][1]), _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f)));
+        m = _mm_add_ps(m, _mm_mul_ps(_mm_set1_ps(a[2][2]), _mm_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f)));
+
+        Vector4<float> sq(m);
+        __m128 u;
+        float d;
+
+        if (ispositive(trace(a)))
+        {
+            d = sq.w;
+            u = _mm_setr_ps(a[2][1] - a[1][2], a[0][2] - a[2][0], a[1][0] - a[0][1], d);
+        }
+        else if (a[0][0] < a[1][1])
+        {
+            if (a[1][1] < a[2][2])
+            {
+                d = sq.z;
+                u = _mm_setr_ps(a[2][0] + a[0][2], a[2][1] + a[1][2], d, a[1][0] - a[0][1]);
+            }
+            else
+            {
+                d = sq.y;
+                u = _mm_setr_ps(a[1][0] + a[0][1], d, a[1][2] + a[2][1], a[0][2] - a[2][0]);
+            }
+        }
+        else if (a[0][0] < a[2][2])
+        {
+            d = sq.z;
+            u = _mm_setr_ps(a[2][0] + a[0][2], a[2][1] + a[1][2], d, a[1][0] - a[0][1]);
+        }
+        else
+        {
+            d = sq.x;
+            u = _mm_setr_ps(d, a[0][1] + a[1][0], a[0][2] + a[2][0], a[2][1] - a[1][2]);
+        }
+
+        return Vector4<float>(_mm_mul_ps(u, _mm_set1_ps(0.5f / sqrt(d))));
+    }
+
+    FORCEINLINE
+    Matrix3x3<float> cholesky(const Matrix3x3<float> a)
+    {
+        // Computes the rows of the upper triangular factor, by subtracting outer products of the
+        // completed rows from the remaining ones, and returns its transpose.
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+
+        ASSERT(!isnegative(a[0][0]));
+        __m128 u0 = _mm_mul_ps(r0, _mm_set1_ps(1.0f / sqrt(a[0][0])));
+
+        r1 = _mm_sub_ps(r1, _mm_mul_ps(MT_SPLAT(u0, 1), u0));
+        r2 = _mm_sub_ps(r2, _mm_mul_ps(MT_SPLAT(u0, 2), u0));
+
+        float d1 = _mm_cvtss_f32(MT_SPLAT(r1, 1));
+        ASSERT(!isnegative(d1));
+        float s1 = 1.0f / sqrt(d1);
+        __m128 u1 = _mm_mul_ps(r1, _mm_setr_ps(0.0f, s1, s1, s1));
+
+        r2 = _mm_sub_ps(r2, _mm_mul_ps(MT_SPLAT(u1, 2), u1));
+
+        float d2 = _mm_cvtss_f32(MT_SPLAT(r2, 2));
+        ASSERT(!isnegative(d2));
+        float s2 = 1.0f / sqrt(d2);
+        __m128 u2 = _mm_mul_ps(r2, _mm_setr_ps(0.0f, 0.0f, s2, s2));
+
+        __m128 u3 = _mm_setzero_ps();
+
+        transpose(u0, u1, u2, u3);
+
+        return storeRows(u0, u1, u2);
+    }
+
+    FORCEINLINE
+    Vector3<float> solveTranspose(const Matrix3x3<float>& a, const Vector3<float>& v)
+    {
+        // Cramer's rule: the rows of the inverse transpose are the cross products of the rows.
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        __m128 c0 = cross3(r1, r2);
+        __m128 c1 = cross3(r2, r0);
+        __m128 c2 = cross3(r0, r1);
+        __m128 u = load3(v);
+
+        float det = dot(a[0], storeVector3(c0));
+        ASSERT(!iszero(det));
+
+        __m128 tmp0 = _mm_mul_ps(c0, u);
+        __m128 tmp1 = _mm_mul_ps(c1, u);
+        __m128 tmp2 = _mm_mul_ps(c2, u);
+        __m128 tmp3 = _mm_setzero_ps();
+
+        transpose(tmp0, tmp1, tmp2, tmp3);
+
+        return storeVector3(div(_mm_add_ps(_mm_add_ps(tmp0, tmp1), tmp2), det));
+    }
+
+    FORCEINLINE
+    Vector3<float> solve(const Matrix3x3<float>& a, const Vector3<float>& v)
+    {
+        // Cramer's rule: the columns of the inverse are the cross products of the rows.
+        __m128 r0, r1, r2;
+        loadRows(a, r0, r1, r2);
+        __m128 c0 = cross3(r1, r2);
+        __m128 c1 = cross3(r2, r0);
+        __m128 c2 = cross3(r0, r1);
+
+        float det = dot(a[0], storeVector3(c0));
+        ASSERT(!iszero(det));
+
+        return storeVector3(div(combine3(load3(v), c0, c1, c2), det));
+    }
+}
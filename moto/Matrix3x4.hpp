@@ -81,7 +81,24 @@ namespace mt
     template <typename Scalar> Matrix3x4<Scalar> mul(const Matrix3x4<Scalar>& a, const Matrix3x4<Scalar>& b);
 
     template <typename Scalar> Matrix3x4<Scalar> inverse(const Matrix3x4<Scalar>& a);
+    template <typename Scalar, typename Policy> Matrix3x4<Scalar> inverse(const Matrix3x4<Scalar>& a, Policy p);
     template <typename Scalar> Matrix3x4<Scalar> inverseOrthogonal(const Matrix3x4<Scalar>& a);  
+
+    // Computes world transforms out[i] = mul(out[parents[i]], locals[i]) in a single pass, where parents[i] < i,
+    // or out[i] = locals[i] for roots, which have a negative parent index.
+    template <typename Scalar> void concatenateHierarchy(const int* parents, const Matrix3x4<Scalar>* locals, Matrix3x4<Scalar>* out, size_t n);
+
+    // Bulk transforms of n elements. Points get the translation and vectors do not. Planes are transformed along 
+    // with the points, so out[i] = mul(planes[i], inverse(a)). The structure-of-arrays versions read and write 
+    // separate coordinate streams. Non-temporal stores bypass the cache for large outputs, where supported.
+    template <typename Scalar> void transformPoints(const Matrix3x4<Scalar>& a, const Vector3<Scalar>* p, Vector3<Scalar>* out, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformVectors(const Matrix3x4<Scalar>& a, const Vector3<Scalar>* v, Vector3<Scalar>* out, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformPlanes(const Matrix3x4<Scalar>& a, const Vector4<Scalar>* planes, Vector4<Scalar>* out, size_t n, bool nonTemporal = false);
+
+    template <typename Scalar> void transformPoints(const Matrix3x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                                                    Scalar* outX, Scalar* outY, Scalar* outZ, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformVectors(const Matrix3x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                                                     Scalar* outX, Scalar* outY, Scalar* outZ, size_t n, bool nonTemporal = false);
     
     template <typename Scalar> Matrix3x4<Scalar> lookat(const Vector3<Scalar>& eye, const Vector3<Scalar>& center, const Vector3<Scalar>& up);
 
@@ -336,7 +353,14 @@ namespace mt
     FORCEINLINE 
     Matrix3x4<Scalar> inverse(const Matrix3x4<Scalar>& a)
     {
-        Matrix3x3<Scalar> invBasis = inverse(basis(a));
+        return inverse<Scalar>(a, Exact());
+    }
+
+    template <typename Scalar, typename Policy>
+    FORCEINLINE 
+    Matrix3x4<Scalar> inverse(const Matrix3x4<Scalar>& a, Policy p)
+    {
+        Matrix3x3<Scalar> invBasis = inverse(basis(a), p);
 
         return Matrix3x4<Scalar>(invBasis, mul(invBasis, -origin(a)));
     }
@@ -350,6 +374,70 @@ namespace mt
         return Matrix3x4<Scalar>(invBasis, mul(invBasis, -origin(a)));
     }  
 
+    template <typename Scalar>
+    void concatenateHierarchy(const int* parents, const Matrix3x4<Scalar>* locals, Matrix3x4<Scalar>* out, size_t n)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            ASSERT(parents[i] < int(i));
+            out[i] = parents[i] < 0 ? locals[i] : mul(out[parents[i]], locals[i]);
+        }
+    }
+
+    template <typename Scalar>
+    void transformPoints(const Matrix3x4<Scalar>& a, const Vector3<Scalar>* p, Vector3<Scalar>* out, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(a, Vector4<Scalar>(p[i], Scalar(1)));
+        }
+    }
+
+    template <typename Scalar>
+    void transformVectors(const Matrix3x4<Scalar>& a, const Vector3<Scalar>* v, Vector3<Scalar>* out, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(a, Vector4<Scalar>(v[i], Scalar()));
+        }
+    }
+
+    template <typename Scalar>
+    void transformPlanes(const Matrix3x4<Scalar>& a, const Vector4<Scalar>* planes, Vector4<Scalar>* out, size_t n, bool)
+    {
+        Matrix3x4<Scalar> b = inverse(a);
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(planes[i], b);
+        }
+    }
+
+    template <typename Scalar>
+    void transformPoints(const Matrix3x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                         Scalar* outX, Scalar* outY, Scalar* outZ, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector3<Scalar> p = mul(a, Vector4<Scalar>(x[i], y[i], z[i], Scalar(1)));
+            outX[i] = p.x;
+            outY[i] = p.y;
+            outZ[i] = p.z;
+        }
+    }
+
+    template <typename Scalar>
+    void transformVectors(const Matrix3x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                          Scalar* outX, Scalar* outY, Scalar* outZ, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector3<Scalar> v = mul(a, Vector4<Scalar>(x[i], y[i], z[i], Scalar()));
+            outX[i] = v.x;
+            outY[i] = v.y;
+            outZ[i] = v.z;
+        }
+    }
+
     template <typename Scalar>
     FORCEINLINE
     Matrix3x4<Scalar> lookat(const Vector3<Scalar>& eye, const Vector3<Scalar>& center, const Vector3<Scalar>& up)
@@ -52,6 +52,22 @@ namespace mt
 
     Vector3<float> mul(const Matrix3x4<float>& a, const Vector4<float>& v);
     Vector4<float> mul(const Vector4<float>& v, const Matrix3x4<float>& a);
+
+    Matrix3x4<float> mul(const Matrix3x4<float>& a, const Matrix3x4<float>& b);
+    Matrix3x4<float> inverse(const Matrix3x4<float>& a);
+    template <typename Policy> Matrix3x4<float> inverse(const Matrix3x4<float>& a, Policy p);
+    Matrix3x4<float> inverseOrthogonal(const Matrix3x4<float>& a);
+
+    void concatenateHierarchy(const int* parents, const Matrix3x4<float>* locals, Matrix3x4<float>* out, size_t n);
+
+    void transformPoints(const Matrix3x4<float>& a, const Vector3<float>* p, Vector3<float>* out, size_t n, bool nonTemporal = false);
+    void transformVectors(const Matrix3x4<float>& a, const Vector3<float>* v, Vector3<float>* out, size_t n, bool nonTemporal = false);
+    void transformPlanes(const Matrix3x4<float>& a, const Vector4<float>* planes, Vector4<float>* out, size_t n, bool nonTemporal = false);
+
+    void transformPoints(const Matrix3x4<float>& a, const float* x, const float* y, const float* z, 
+                         float* outX, float* outY, float* outZ, size_t n, bool nonTemporal = false);
+    void transformVectors(const Matrix3x4<float>& a, const float* x, const float* y, const float* z, 
+                          float* outX, float* outY, float* outZ, size_t n, bool nonTemporal = false);
     
     
     FORCEINLINE 
@@ -212,7 +228,7 @@ namespace mt
         __m128 tmp0 = _mm_mul_ps(a[0].vec, v.vec);
         __m128 tmp1 = _mm_mul_ps(a[1].vec, v.vec);
         __m128 tmp2 = _mm_mul_ps(a[2].vec, v.vec);
-        __m128 tmp3;
+        __m128 tmp3 = _mm_setzero_ps();
 
         transpose(tmp0, tmp1, tmp2, tmp3);
 
@@ -229,4 +245,235 @@ namespace mt
         result = _mm_add_ps(result, _mm_setr_ps(0.0f, 0.0f, 0.0f, v.w));
         return Vector4<float>(result);
     }
+
+    // Row v of an affine product, i.e. mul(v, b) where the implicit bottom row of b is [0, 0, 0, 1]
+    FORCEINLINE
+    __m128 combineRows(__m128 v, const Matrix3x4<float>& b)
+    {
+        __m128 result = _mm_mul_ps(v, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 0), b[0].vec));
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 1), b[1].vec));
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 2), b[2].vec));
+        return result;
+    }
+
+    FORCEINLINE 
+    Matrix3x4<float> mul(const Matrix3x4<float>& a, const Matrix3x4<float>& b)
+    {
+        return Matrix3x4<float>(combineRows(a[0].vec, b), 
+                                combineRows(a[1].vec, b), 
+                                combineRows(a[2].vec, b));
+    }
+
+    FORCEINLINE 
+    Matrix3x4<float> inverse(const Matrix3x4<float>& a)
+    {
+        return inverse(a, Exact());
+    }
+
+    template <typename Policy>
+    FORCEINLINE 
+    Matrix3x4<float> inverse(const Matrix3x4<float>& a, Policy p)
+    {
+        // The columns of the inverse basis are the cross products of the rows of the basis over the determinant.
+        __m128 c0 = cross3(a[1].vec, a[2].vec);
+        __m128 c1 = cross3(a[2].vec, a[0].vec);
+        __m128 c2 = cross3(a[0].vec, a[1].vec);
+
+        float det = dot3(a[0], Vector4<float>(c0));
+
+        ASSERT(!iszero(det));
+
+        __m128 s = _mm_set1_ps(rcp(det, p));
+        c0 = _mm_mul_ps(c0, s);
+        c1 = _mm_mul_ps(c1, s);
+        c2 = _mm_mul_ps(c2, s);
+
+        __m128 c3 = _mm_mul_ps(c0, MT_SPLAT(a[0].vec, 3));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, MT_SPLAT(a[1].vec, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, MT_SPLAT(a[2].vec, 3)));
+        c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix3x4<float>(c0, c1, c2);
+    }
+
+    FORCEINLINE 
+    Matrix3x4<float> inverseOrthogonal(const Matrix3x4<float>& a)
+    {
+        // The fourth elements of the rows end up in the fourth row after transposition, which is dropped.
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+
+        __m128 c3 = _mm_mul_ps(c0, MT_SPLAT(c0, 3));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, MT_SPLAT(c1, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, MT_SPLAT(c2, 3)));
+        c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix3x4<float>(c0, c1, c2);
+    }
+
+    inline
+    void concatenateHierarchy(const int* parents, const Matrix3x4<float>* locals, Matrix3x4<float>* out, size_t n)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            ASSERT(parents[i] < int(i));
+
+            const Matrix3x4<float>& b = locals[i];
+            if (parents[i] < 0)
+            {
+                out[i] = b;
+            }
+            else
+            {
+                const Matrix3x4<float>& a = out[parents[i]];
+                __m128 r0 = combineRows(a[0].vec, b);
+                __m128 r1 = combineRows(a[1].vec, b);
+                __m128 r2 = combineRows(a[2].vec, b);
+                out[i].setValue(r0, r1, r2);
+            }
+        }
+    }
+
+    // Computes c0 * v.x + c1 * v.y + c2 * v.z + c3 for n vectors, four at a time. Non-temporal stores are
+    // used only if the destination is aligned.
+    inline
+    void transformColumns(__m128 c0, __m128 c1, __m128 c2, __m128 c3, const Vector3<float>* v, Vector3<float>* out, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(out);
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 v0, v1, v2, v3;
+            load4(v + i, v0, v1, v2, v3);
+            v0 = _mm_add_ps(combine3(v0, c0, c1, c2), c3);
+            v1 = _mm_add_ps(combine3(v1, c0, c1, c2), c3);
+            v2 = _mm_add_ps(combine3(v2, c0, c1, c2), c3);
+            v3 = _mm_add_ps(combine3(v3, c0, c1, c2), c3);
+            if (stream)
+            {
+                stream4(out + i, v0, v1, v2, v3);
+            }
+            else
+            {
+                store4(out + i, v0, v1, v2, v3);
+            }
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+
+        for (; i != n; ++i)
+        {
+            store3(out[i], _mm_add_ps(combine3(load3(v[i]), c0, c1, c2), c3));
+        }
+    }
+
+    // Computes the rows r0, r1 and r2 times (x, y, z, 1) for separate coordinate streams.
+    inline
+    void transformRows(__m128 r0, __m128 r1, __m128 r2, const float* x, const float* y, const float* z, 
+                          float* outX, float* outY, float* outZ, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(outX) && isaligned(outY) && isaligned(outZ);
+
+        __m128 m00 = MT_SPLAT(r0, 0), m01 = MT_SPLAT(r0, 1), m02 = MT_SPLAT(r0, 2), m03 = MT_SPLAT(r0, 3);
+        __m128 m10 = MT_SPLAT(r1, 0), m11 = MT_SPLAT(r1, 1), m12 = MT_SPLAT(r1, 2), m13 = MT_SPLAT(r1, 3);
+        __m128 m20 = MT_SPLAT(r2, 0), m21 = MT_SPLAT(r2, 1), m22 = MT_SPLAT(r2, 2), m23 = MT_SPLAT(r2, 3);
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            __m128 vz = _mm_loadu_ps(z + i);
+            store(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m01, vy)), _mm_add_ps(_mm_mul_ps(m02, vz), m03)), stream);
+            store(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, vx), _mm_mul_ps(m11, vy)), _mm_add_ps(_mm_mul_ps(m12, vz), m13)), stream);
+            store(outZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, vx), _mm_mul_ps(m21, vy)), _mm_add_ps(_mm_mul_ps(m22, vz), m23)), stream);
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+
+        __m128 r3 = _mm_setzero_ps();
+        transpose(r0, r1, r2, r3);
+
+        for (; i != n; ++i)
+        {
+            Vector4<float> v(_mm_add_ps(combine3(_mm_setr_ps(x[i], y[i], z[i], 0.0f), r0, r1, r2), r3));
+            outX[i] = v.x;
+            outY[i] = v.y;
+            outZ[i] = v.z;
+        }
+    }
+
+    inline
+    void transformPoints(const Matrix3x4<float>& a, const Vector3<float>* p, Vector3<float>* out, size_t n, bool nonTemporal)
+    {
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+        __m128 c3 = _mm_setzero_ps();
+
+        transpose(c0, c1, c2, c3);
+
+        transformColumns(c0, c1, c2, c3, p, out, n, nonTemporal);
+    }
+
+    inline
+    void transformVectors(const Matrix3x4<float>& a, const Vector3<float>* v, Vector3<float>* out, size_t n, bool nonTemporal)
+    {
+        // Transposes the linear part only. The fourth lanes of the columns end up in the fourth
+        // lanes of the results, which are not stored.
+        __m128 lo01 = _mm_unpacklo_ps(a[0].vec, a[1].vec);
+        __m128 hi01 = _mm_unpackhi_ps(a[0].vec, a[1].vec);
+        __m128 c0 = _mm_movelh_ps(lo01, a[2].vec);
+        __m128 c1 = _mm_shuffle_ps(lo01, a[2].vec, _MM_SHUFFLE(3, 1, 3, 2));
+        __m128 c2 = _mm_shuffle_ps(hi01, a[2].vec, _MM_SHUFFLE(3, 2, 1, 0));
+
+        transformColumns(c0, c1, c2, _mm_setzero_ps(), v, out, n, nonTemporal);
+    }
+
+    inline
+    void transformPlanes(const Matrix3x4<float>& a, const Vector4<float>* planes, Vector4<float>* out, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(out);
+
+        Matrix3x4<float> b = inverse(a);
+        for (size_t i = 0; i != n; ++i)
+        {
+            store(out[i], combineRows(planes[i].vec, b), stream);
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+    }
+
+    inline
+    void transformPoints(const Matrix3x4<float>& a, const float* x, const float* y, const float* z, 
+                         float* outX, float* outY, float* outZ, size_t n, bool nonTemporal)
+    {
+        transformRows(a[0].vec, a[1].vec, a[2].vec, x, y, z, outX, outY, outZ, n, nonTemporal);
+    }
+
+    inline
+    void transformVectors(const Matrix3x4<float>& a, const float* x, const float* y, const float* z, 
+                          float* outX, float* outY, float* outZ, size_t n, bool nonTemporal)
+    {
+        // Clears the translation column.
+        __m128 mask = _mm_setr_ps(1.0f, 1.0f, 1.0f, 0.0f);
+        transformRows(_mm_mul_ps(a[0].vec, mask), _mm_mul_ps(a[1].vec, mask), _mm_mul_ps(a[2].vec, mask), 
+                      x, y, z, outX, outY, outZ, n, nonTemporal);
+    }
 }
@@ -143,8 +143,22 @@ namespace mt
     template <typename Scalar> Matrix4x4<Scalar> transpose(const Matrix4x4<Scalar>& a);
     template <typename Scalar> Matrix4x4<Scalar> adjoint(const Matrix4x4<Scalar>& a);
     template <typename Scalar> Matrix4x4<Scalar> inverse(const Matrix4x4<Scalar>& a);
+    template <typename Scalar, typename Policy> Matrix4x4<Scalar> inverse(const Matrix4x4<Scalar>& a, Policy p);
     template <typename Scalar> Matrix4x4<Scalar> inverseAffine(const Matrix4x4<Scalar>& a);
     template <typename Scalar> Matrix4x4<Scalar> inverseOrthogonal(const Matrix4x4<Scalar>& a);
+
+    // Bulk transforms of n elements. Points get a homogeneous coordinate of one, and the results are not 
+    // homogenized. Vectors are full homogeneous vectors, so directions need a zero w. Planes are transformed 
+    // along with the points, so out[i] = mul(planes[i], inverse(a)). The structure-of-arrays versions read and
+    // write separate coordinate streams. Non-temporal stores bypass the cache for large outputs, where supported.
+    template <typename Scalar> void transformPoints(const Matrix4x4<Scalar>& a, const Vector3<Scalar>* p, Vector4<Scalar>* out, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformVectors(const Matrix4x4<Scalar>& a, const Vector4<Scalar>* v, Vector4<Scalar>* out, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformPlanes(const Matrix4x4<Scalar>& a, const Vector4<Scalar>* planes, Vector4<Scalar>* out, size_t n, bool nonTemporal = false);
+
+    template <typename Scalar> void transformPoints(const Matrix4x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                                                    Scalar* outX, Scalar* outY, Scalar* outZ, Scalar* outW, size_t n, bool nonTemporal = false);
+    template <typename Scalar> void transformVectors(const Matrix4x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, const Scalar* w, 
+                                                     Scalar* outX, Scalar* outY, Scalar* outZ, Scalar* outW, size_t n, bool nonTemporal = false);
     
     template <typename Scalar> Matrix4x4<Scalar> frustum(Scalar left, Scalar right, Scalar bottom, Scalar top, Scalar zNear, Scalar zFar);
 
@@ -839,6 +853,13 @@ namespace mt
     template <typename Scalar>
     FORCEINLINE 
     Matrix4x4<Scalar> inverse(const Matrix4x4<Scalar>& a)
+    {
+        return inverse<Scalar>(a, Exact());
+    }
+
+    template <typename Scalar, typename Policy>
+    FORCEINLINE 
+    Matrix4x4<Scalar> inverse(const Matrix4x4<Scalar>& a, Policy p)
     {
         // From: Streaming SIMD Extensions - Inverse of 4x4 Matrix, Intel
         
@@ -900,7 +921,7 @@ namespace mt
         ASSERT(!iszero(det));
 
         /* calculate matrix inverse */
-        Scalar s = Scalar(1) / det;
+        Scalar s = rcp(det, p);
       
         return Matrix4x4<Scalar>(dst[0] * s, dst[1] * s, dst[2] * s, dst[3] * s);
     }
@@ -923,6 +944,62 @@ namespace mt
         return Matrix4x4<Scalar>(invBasis, mul(invBasis, -origin(a)));
     }
 
+    template <typename Scalar>
+    void transformPoints(const Matrix4x4<Scalar>& a, const Vector3<Scalar>* p, Vector4<Scalar>* out, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(a, Vector4<Scalar>(p[i], Scalar(1)));
+        }
+    }
+
+    template <typename Scalar>
+    void transformVectors(const Matrix4x4<Scalar>& a, const Vector4<Scalar>* v, Vector4<Scalar>* out, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(a, v[i]);
+        }
+    }
+
+    template <typename Scalar>
+    void transformPlanes(const Matrix4x4<Scalar>& a, const Vector4<Scalar>* planes, Vector4<Scalar>* out, size_t n, bool)
+    {
+        Matrix4x4<Scalar> b = inverse(a);
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = mul(planes[i], b);
+        }
+    }
+
+    template <typename Scalar>
+    void transformPoints(const Matrix4x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, 
+                         Scalar* outX, Scalar* outY, Scalar* outZ, Scalar* outW, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector4<Scalar> p = mul(a, Vector4<Scalar>(x[i], y[i], z[i], Scalar(1)));
+            outX[i] = p.x;
+            outY[i] = p.y;
+            outZ[i] = p.z;
+            outW[i] = p.w;
+        }
+    }
+
+    template <typename Scalar>
+    void transformVectors(const Matrix4x4<Scalar>& a, const Scalar* x, const Scalar* y, const Scalar* z, const Scalar* w, 
+                          Scalar* outX, Scalar* outY, Scalar* outZ, Scalar* outW, size_t n, bool)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector4<Scalar> v = mul(a, Vector4<Scalar>(x[i], y[i], z[i], w[i]));
+            outX[i] = v.x;
+            outY[i] = v.y;
+            outZ[i] = v.z;
+            outW[i] = v.w;
+        }
+    }
+
     template <typename Scalar>
     FORCEINLINE 
     Matrix4x4<Scalar> frustum(Scalar left, Scalar right, Scalar bottom, Scalar top, Scalar zNear, Scalar zFar)
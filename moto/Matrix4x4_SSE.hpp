@@ -74,7 +74,26 @@ namespace mt
     Vector4<float> mul(const Matrix4x4<float>& a, const Vector4<float>& v);
     Vector4<float> mul(const Vector4<float>& v, const Matrix4x4<float>& a);
 
+    Matrix4x4<float> mul(const Matrix4x4<float>& a, const Matrix4x4<float>& b);
+    Matrix4x4<float> transposeMul(const Matrix4x4<float>& a, const Matrix4x4<float>& b);
+    Matrix4x4<float> mulTranspose(const Matrix4x4<float>& a, const Matrix4x4<float>& b);
+
     Matrix4x4<float> transpose(const Matrix4x4<float>& a);
+    float determinant(const Matrix4x4<float>& a);
+    Matrix4x4<float> adjoint(const Matrix4x4<float>& a);
+    Matrix4x4<float> inverse(const Matrix4x4<float>& a);
+    template <typename Policy> Matrix4x4<float> inverse(const Matrix4x4<float>& a, Policy p);
+    Matrix4x4<float> inverseAffine(const Matrix4x4<float>& a);
+    Matrix4x4<float> inverseOrthogonal(const Matrix4x4<float>& a);
+
+    void transformPoints(const Matrix4x4<float>& a, const Vector3<float>* p, Vector4<float>* out, size_t n, bool nonTemporal = false);
+    void transformVectors(const Matrix4x4<float>& a, const Vector4<float>* v, Vector4<float>* out, size_t n, bool nonTemporal = false);
+    void transformPlanes(const Matrix4x4<float>& a, const Vector4<float>* planes, Vector4<float>* out, size_t n, bool nonTemporal = false);
+
+    void transformPoints(const Matrix4x4<float>& a, const float* x, const float* y, const float* z, 
+                         float* outX, float* outY, float* outZ, float* outW, size_t n, bool nonTemporal = false);
+    void transformVectors(const Matrix4x4<float>& a, const float* x, const float* y, const float* z, const float* w, 
+                          float* outX, float* outY, float* outZ, float* outW, size_t n, bool nonTemporal = false);
 
 
     
@@ -399,4 +418,334 @@ namespace mt
         
         return Matrix4x4<float>(tmp0, tmp1, tmp2, tmp3);
     }
+
+
+    // Linear combination of the rows of a with the elements of v, i.e. mul(v, a)
+    FORCEINLINE
+    __m128 combineRows(__m128 v, const Matrix4x4<float>& a)
+    {
+        __m128 result = _mm_mul_ps(MT_SPLAT(v, 0), a[0].vec);
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 1), a[1].vec));
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 2), a[2].vec));
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 3), a[3].vec));
+        return result;
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> mul(const Matrix4x4<float>& a, const Matrix4x4<float>& b)
+    {
+        return Matrix4x4<float>(combineRows(a[0].vec, b), 
+                                combineRows(a[1].vec, b), 
+                                combineRows(a[2].vec, b), 
+                                combineRows(a[3].vec, b));
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> transposeMul(const Matrix4x4<float>& a, const Matrix4x4<float>& b)
+    {
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+        __m128 c3 = a[3].vec;
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix4x4<float>(combineRows(c0, b), 
+                                combineRows(c1, b), 
+                                combineRows(c2, b), 
+                                combineRows(c3, b));
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> mulTranspose(const Matrix4x4<float>& a, const Matrix4x4<float>& b)
+    {
+        Matrix4x4<float> bt = transpose(b);
+
+        return Matrix4x4<float>(combineRows(a[0].vec, bt), 
+                                combineRows(a[1].vec, bt), 
+                                combineRows(a[2].vec, bt), 
+                                combineRows(a[3].vec, bt));
+    }
+
+    // The 2x2 minors m_ij = p_i * q_j - p_j * q_i of rows p and q, arranged as 
+    // ma = [m23, m23, m13, m12], mb = [m13, m03, m03, m02], mc = [m12, m02, m01, m01]
+    FORCEINLINE
+    void minors(__m128& ma, __m128& mb, __m128& mc, __m128 p, __m128 q)
+    {
+        __m128 p1 = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 1));
+        __m128 p2 = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 2, 2));
+        __m128 p3 = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 3, 3));
+        __m128 q1 = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 1));
+        __m128 q2 = _mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 2, 2));
+        __m128 q3 = _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 3, 3));
+
+        ma = _mm_sub_ps(_mm_mul_ps(p2, q3), _mm_mul_ps(p3, q2));
+        mb = _mm_sub_ps(_mm_mul_ps(p1, q3), _mm_mul_ps(p3, q1));
+        mc = _mm_sub_ps(_mm_mul_ps(p1, q2), _mm_mul_ps(p2, q1));
+    }
+
+    // Cofactors of one row of a 4x4 matrix, by expanding the 3x3 minors along row u, given the 2x2 minors 
+    // of the two other remaining rows. The sign vector holds the signs of the row's cofactors.
+    FORCEINLINE
+    __m128 cofactors(__m128 u, __m128 ma, __m128 mb, __m128 mc, __m128 sign)
+    {
+        __m128 u1 = _mm_shuffle_ps(u, u, _MM_SHUFFLE(0, 0, 0, 1));
+        __m128 u2 = _mm_shuffle_ps(u, u, _MM_SHUFFLE(1, 1, 2, 2));
+        __m128 u3 = _mm_shuffle_ps(u, u, _MM_SHUFFLE(2, 3, 3, 3));
+
+        __m128 result = _mm_sub_ps(_mm_mul_ps(u1, ma), _mm_mul_ps(u2, mb));
+        result = _mm_add_ps(result, _mm_mul_ps(u3, mc));
+        return _mm_mul_ps(result, sign);
+    }
+
+    FORCEINLINE 
+    float determinant(const Matrix4x4<float>& a)
+    {
+        __m128 ma, mb, mc;
+        minors(ma, mb, mc, a[2].vec, a[3].vec);
+
+        __m128 c0 = cofactors(a[1].vec, ma, mb, mc, _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f));
+        return dot(a[0], Vector4<float>(c0));
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> adjoint(const Matrix4x4<float>& a)
+    {
+        __m128 even = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        __m128 odd = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+
+        __m128 ma, mb, mc;
+        minors(ma, mb, mc, a[2].vec, a[3].vec);
+        __m128 c0 = cofactors(a[1].vec, ma, mb, mc, even);
+        __m128 c1 = cofactors(a[0].vec, ma, mb, mc, odd);
+
+        minors(ma, mb, mc, a[0].vec, a[1].vec);
+        __m128 c2 = cofactors(a[3].vec, ma, mb, mc, even);
+        __m128 c3 = cofactors(a[2].vec, ma, mb, mc, odd);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix4x4<float>(c0, c1, c2, c3);
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> inverse(const Matrix4x4<float>& a)
+    {
+        return inverse(a, Exact());
+    }
+
+    template <typename Policy>
+    FORCEINLINE 
+    Matrix4x4<float> inverse(const Matrix4x4<float>& a, Policy p)
+    {
+        __m128 even = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        __m128 odd = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+
+        __m128 ma, mb, mc;
+        minors(ma, mb, mc, a[2].vec, a[3].vec);
+        __m128 c0 = cofactors(a[1].vec, ma, mb, mc, even);
+        __m128 c1 = cofactors(a[0].vec, ma, mb, mc, odd);
+
+        minors(ma, mb, mc, a[0].vec, a[1].vec);
+        __m128 c2 = cofactors(a[3].vec, ma, mb, mc, even);
+        __m128 c3 = cofactors(a[2].vec, ma, mb, mc, odd);
+
+        float det = dot(a[0], Vector4<float>(c0));
+
+        ASSERT(!iszero(det));
+
+        __m128 s = _mm_set1_ps(rcp(det, p));
+        c0 = _mm_mul_ps(c0, s);
+        c1 = _mm_mul_ps(c1, s);
+        c2 = _mm_mul_ps(c2, s);
+        c3 = _mm_mul_ps(c3, s);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix4x4<float>(c0, c1, c2, c3);
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> inverseAffine(const Matrix4x4<float>& a)
+    {
+        // The columns of the inverse basis are the cross products of the rows of the basis over the determinant.
+        __m128 c0 = cross3(a[1].vec, a[2].vec);
+        __m128 c1 = cross3(a[2].vec, a[0].vec);
+        __m128 c2 = cross3(a[0].vec, a[1].vec);
+
+        float det = dot3(a[0], Vector4<float>(c0));
+
+        ASSERT(!iszero(det));
+
+        __m128 s = _mm_set1_ps(1.0f / det);
+        c0 = _mm_mul_ps(c0, s);
+        c1 = _mm_mul_ps(c1, s);
+        c2 = _mm_mul_ps(c2, s);
+
+        __m128 c3 = _mm_mul_ps(c0, MT_SPLAT(a[0].vec, 3));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, MT_SPLAT(a[1].vec, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, MT_SPLAT(a[2].vec, 3)));
+        c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix4x4<float>(c0, c1, c2, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+    }
+
+    FORCEINLINE 
+    Matrix4x4<float> inverseOrthogonal(const Matrix4x4<float>& a)
+    {
+        // The fourth elements end up in the bottom row, which is replaced.
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+
+        __m128 c3 = _mm_mul_ps(c0, MT_SPLAT(a[0].vec, 3));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c1, MT_SPLAT(a[1].vec, 3)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(c2, MT_SPLAT(a[2].vec, 3)));
+        c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+        transpose(c0, c1, c2, c3);
+
+        return Matrix4x4<float>(c0, c1, c2, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+    }
+
+    inline
+    void transformPoints(const Matrix4x4<float>& a, const Vector3<float>* p, Vector4<float>* out, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(out);
+
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+        __m128 c3 = a[3].vec;
+
+        transpose(c0, c1, c2, c3);
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 v0, v1, v2, v3;
+            load4(p + i, v0, v1, v2, v3);
+            store(out[i], _mm_add_ps(combine3(v0, c0, c1, c2), c3), stream);
+            store(out[i + 1], _mm_add_ps(combine3(v1, c0, c1, c2), c3), stream);
+            store(out[i + 2], _mm_add_ps(combine3(v2, c0, c1, c2), c3), stream);
+            store(out[i + 3], _mm_add_ps(combine3(v3, c0, c1, c2), c3), stream);
+        }
+
+        for (; i != n; ++i)
+        {
+            store(out[i], _mm_add_ps(combine3(load3(p[i]), c0, c1, c2), c3), stream);
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+    }
+
+    inline
+    void transformVectors(const Matrix4x4<float>& a, const Vector4<float>* v, Vector4<float>* out, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(out);
+
+        __m128 c0 = a[0].vec;
+        __m128 c1 = a[1].vec;
+        __m128 c2 = a[2].vec;
+        __m128 c3 = a[3].vec;
+
+        transpose(c0, c1, c2, c3);
+
+        for (size_t i = 0; i != n; ++i)
+        {
+            __m128 tmp = v[i].vec;
+            store(out[i], _mm_add_ps(combine3(tmp, c0, c1, c2), _mm_mul_ps(MT_SPLAT(tmp, 3), c3)), stream);
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+    }
+
+    inline
+    void transformPlanes(const Matrix4x4<float>& a, const Vector4<float>* planes, Vector4<float>* out, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(out);
+
+        Matrix4x4<float> b = inverse(a);
+        for (size_t i = 0; i != n; ++i)
+        {
+            __m128 tmp = planes[i].vec;
+            store(out[i], _mm_add_ps(combine3(tmp, b[0].vec, b[1].vec, b[2].vec), _mm_mul_ps(MT_SPLAT(tmp, 3), b[3].vec)), stream);
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+    }
+
+    // Computes the rows of a times (x, y, z, w) for separate coordinate streams. A null w stands for w = 1.
+    inline
+    void transformRows(const Matrix4x4<float>& a, const float* x, const float* y, const float* z, const float* w, 
+                       float* outX, float* outY, float* outZ, float* outW, size_t n, bool nonTemporal)
+    {
+        bool stream = nonTemporal && isaligned(outX) && isaligned(outY) && isaligned(outZ) && isaligned(outW);
+
+        __m128 m[4][4];
+        for (int j = 0; j != 4; ++j)
+        {
+            m[j][0] = MT_SPLAT(a[j].vec, 0);
+            m[j][1] = MT_SPLAT(a[j].vec, 1);
+            m[j][2] = MT_SPLAT(a[j].vec, 2);
+            m[j][3] = MT_SPLAT(a[j].vec, 3);
+        }
+
+        float* out[4] = { outX, outY, outZ, outW };
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            __m128 vz = _mm_loadu_ps(z + i);
+            __m128 vw = w ? _mm_loadu_ps(w + i) : _mm_set1_ps(1.0f);
+            for (int j = 0; j != 4; ++j)
+            {
+                __m128 result = _mm_add_ps(_mm_mul_ps(m[j][0], vx), _mm_mul_ps(m[j][1], vy));
+                result = _mm_add_ps(result, _mm_add_ps(_mm_mul_ps(m[j][2], vz), _mm_mul_ps(m[j][3], vw)));
+                store(out[j] + i, result, stream);
+            }
+        }
+
+        if (stream)
+        {
+            _mm_sfence();
+        }
+
+        for (; i != n; ++i)
+        {
+            Vector4<float> v = mul(a, Vector4<float>(x[i], y[i], z[i], w ? w[i] : 1.0f));
+            outX[i] = v.x;
+            outY[i] = v.y;
+            outZ[i] = v.z;
+            outW[i] = v.w;
+        }
+    }
+
+    inline
+    void transformPoints(const Matrix4x4<float>& a, const float* x, const float* y, const float* z, 
+                         float* outX, float* outY, float* outZ, float* outW, size_t n, bool nonTemporal)
+    {
+        transformRows(a, x, y, z, 0, outX, outY, outZ, outW, n, nonTemporal);
+    }
+
+    inline
+    void transformVectors(const Matrix4x4<float>& a, const float* x, const float* y, const float* z, const float* w, 
+                          float* outX, float* outY, float* outZ, float* outW, size_t n, bool nonTemporal)
+    {
+        ASSERT(w != 0);
+        transformRows(a, x, y, z, w, outX, outY, outZ, outW, n, nonTemporal);
+    }
 }
@@ -9,6 +9,7 @@
 #ifndef MT_METRIC_HPP
 #define MT_METRIC_HPP
 
+#include <moto/Precision.hpp>
 #include <moto/Scalar.hpp>
 
 namespace mt
@@ -19,6 +20,8 @@ namespace mt
     template <typename Vector> typename Vector::ScalarType distance(const Vector& p1, const Vector& p2);
     template <typename Vector> Vector normalize(const Vector& v);
     template <typename Vector, typename Scalar> Vector nlerp(const Vector& v1, const Vector& v2, Scalar t);
+    template <typename Vector, typename Policy> Vector normalize(const Vector& v, Policy p);
+    template <typename Vector, typename Scalar, typename Policy> Vector nlerp(const Vector& v1, const Vector& v2, Scalar t, Policy p);
     template <typename Vector> Vector bound(const Vector& v, typename Vector::ScalarType b);
 
     template <typename Vector> typename Vector::ScalarType lengthSquared3(const Vector& v);
@@ -27,6 +30,8 @@ namespace mt
     template <typename Vector> typename Vector::ScalarType distance3(const Vector& p1, const Vector& p2);
     template <typename Vector> Vector normalize3(const Vector& v);
     template <typename Vector, typename Scalar> Vector nlerp3(const Vector& v1, const Vector& v2, Scalar t);
+    template <typename Vector, typename Policy> Vector normalize3(const Vector& v, Policy p);
+    template <typename Vector, typename Scalar, typename Policy> Vector nlerp3(const Vector& v1, const Vector& v2, Scalar t, Policy p);
     template <typename Vector> Vector bound3(const Vector& v, typename Vector::ScalarType b);
 
     template <typename Vector>
@@ -72,6 +77,21 @@ namespace mt
         return normalize(lerp(v1, v2, t));
     }
 
+    template <typename Vector, typename Policy>
+    FORCEINLINE
+    Vector normalize(const Vector& v, Policy p)
+    { 
+        typename Vector::ScalarType s = lengthSquared(v);  
+        return ispositive(s) ? v * rsqrt(s, p) : v;
+    }
+
+    template <typename Vector, typename Scalar, typename Policy>
+    FORCEINLINE 
+    Vector nlerp(const Vector& v1, const Vector& v2, Scalar t, Policy p)
+    {
+        return normalize(lerp(v1, v2, t), p);
+    }
+
     template <typename Vector>
     FORCEINLINE
     Vector bound(const Vector& v, typename Vector::ScalarType b)
@@ -126,6 +146,21 @@ namespace mt
         return normalize3(lerp(v1, v2, t));
     } 
 
+    template <typename Vector, typename Policy>
+    FORCEINLINE
+    Vector normalize3(const Vector& v, Policy p)
+    {   
+        typename Vector::ScalarType s = lengthSquared3(v);  
+        return ispositive(s) ? v * rsqrt(s, p) : v;
+    }
+
+    template <typename Vector, typename Scalar, typename Policy>
+    FORCEINLINE 
+    Vector nlerp3(const Vector& v1, const Vector& v2, Scalar t, Policy p)
+    {
+        return normalize3(lerp(v1, v2, t), p);
+    } 
+
     template <typename Vector>
     FORCEINLINE
     Vector bound3(const Vector& v, typename Vector::ScalarType b)
@@ -0,0 +1,680 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PACKET_HPP
+#define MT_PACKET_HPP
+
+#include <moto/Precision.hpp>
+#include <moto/Promote.hpp>
+#include <moto/Scalar.hpp>
+#include <moto/ScalarTraits.hpp>
+
+namespace mt
+{
+    // A Packet holds N independent lanes and can be used as Scalar type of the other classes, e.g.
+    // Vector3<Packet<float, 4> > computes four vectors at once. Comparisons and predicates return a
+    // PacketMask with one flag per lane. A PacketMask does not convert to bool or an integer, so that
+    // generic code cannot branch on a mask by accident. Use select() for lane-wise conditionals, and
+    // any(), all() or none() for branches. bits() returns the flags as the low N bits of a word.
+    //
+    // The SSE and AVX float packets keep their masks as full lane masks in a register, so that a
+    // comparison feeds select() without a round trip through bits().
+
+    template <int N>
+    class PacketMask
+    {
+    public:
+        PacketMask();
+        explicit PacketMask(uint32_t bits);
+
+        uint32_t bits() const;
+        bool operator[](int i) const;
+
+        PacketMask<N>& operator|=(PacketMask<N> rhs);
+        PacketMask<N>& operator&=(PacketMask<N> rhs);
+        PacketMask<N>& operator^=(PacketMask<N> rhs);
+
+    private:
+        uint32_t mBits;
+    };
+
+    template <int N> PacketMask<N> operator~(PacketMask<N> a);
+    template <int N> PacketMask<N> operator&(PacketMask<N> a, PacketMask<N> b);
+    template <int N> PacketMask<N> operator|(PacketMask<N> a, PacketMask<N> b);
+
+    template <int N> bool any(PacketMask<N> a);
+    template <int N> bool all(PacketMask<N> a);
+    template <int N> bool none(PacketMask<N> a);
+
+
+    template <typename Scalar, int N>
+    class Packet
+    {
+    public:
+        typedef Scalar ScalarType;
+        typedef PacketMask<N> MaskType;
+
+        enum { SIZE = N };
+
+        // Zero-initialized, since generic code uses Scalar() for zero.
+        Packet();
+        Packet(Scalar s);
+        explicit Packet(const Scalar* v);
+
+        Scalar operator[](int i) const;
+        Scalar& operator[](int i);
+
+        Packet<Scalar, N>& operator+=(const Packet<Scalar, N>& a);
+        Packet<Scalar, N>& operator-=(const Packet<Scalar, N>& a);
+        Packet<Scalar, N>& operator*=(const Packet<Scalar, N>& a);
+        Packet<Scalar, N>& operator/=(const Packet<Scalar, N>& a);
+
+    private:
+        Scalar mLane[N];
+    };
+
+    template <typename Scalar, int N> void store(Scalar* v, const Packet<Scalar, N>& a);
+
+    template <typename Scalar, int N> PacketMask<N> operator==(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> PacketMask<N> operator!=(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> PacketMask<N> operator<(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> PacketMask<N> operator<=(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> PacketMask<N> operator>(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> PacketMask<N> operator>=(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+
+    template <typename Scalar, int N> Packet<Scalar, N> operator-(const Packet<Scalar, N>& a);
+
+    template <typename Scalar, int N> Packet<Scalar, N> operator+(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> Packet<Scalar, N> operator-(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> Packet<Scalar, N> operator*(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> Packet<Scalar, N> operator/(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+
+    template <typename Scalar, int N> Packet<Scalar, N> operator+(const Packet<Scalar, N>& a, Scalar s);
+    template <typename Scalar, int N> Packet<Scalar, N> operator-(const Packet<Scalar, N>& a, Scalar s);
+    template <typename Scalar, int N> Packet<Scalar, N> operator*(const Packet<Scalar, N>& a, Scalar s);
+    template <typename Scalar, int N> Packet<Scalar, N> operator/(const Packet<Scalar, N>& a, Scalar s);
+
+    template <typename Scalar, int N> Packet<Scalar, N> operator+(Scalar s, const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> operator-(Scalar s, const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> operator*(Scalar s, const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> operator/(Scalar s, const Packet<Scalar, N>& a);
+
+    template <typename Scalar, int N>
+    Packet<Scalar, N> select(PacketMask<N> mask, const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+
+    template <typename Scalar, int N> PacketMask<N> ispositive(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> PacketMask<N> isnegative(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> PacketMask<N> iszero(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> PacketMask<N> isfinite(const Packet<Scalar, N>& a);
+
+    template <typename Scalar, int N> Packet<Scalar, N> min(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> Packet<Scalar, N> max(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b);
+    template <typename Scalar, int N> Packet<Scalar, N> abs(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> sqrt(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> rsqrt(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N, typename Policy> Packet<Scalar, N> rcp(const Packet<Scalar, N>& a, Policy p);
+    template <typename Scalar, int N, typename Policy> Packet<Scalar, N> rsqrt(const Packet<Scalar, N>& a, Policy p);
+    template <typename Element, typename Scalar, int N> Element div(const Element& e, const Packet<Scalar, N>& s, Exact);
+
+    template <typename Scalar, int N> Scalar hsum(const Packet<Scalar, N>& a);
+
+    // Bit-level primitives of the transcendentals in PacketMath.hpp. The exponents taken and
+    // returned by ldexp and frexp are integral values stored in lanes.
+    template <typename Scalar, int N> Packet<Scalar, N> floor(const Packet<Scalar, N>& a);
+    template <typename Scalar, int N> Packet<Scalar, N> ldexp(const Packet<Scalar, N>& a, const Packet<Scalar, N>& e);
+    template <typename Scalar, int N> Packet<Scalar, N> frexp(const Packet<Scalar, N>& a, Packet<Scalar, N>* e);
+
+
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N>::PacketMask()
+    {}
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N>::PacketMask(uint32_t bits)
+        : mBits(bits)
+    {}
+
+    template <int N>
+    FORCEINLINE
+    uint32_t PacketMask<N>::bits() const
+    {
+        return mBits;
+    }
+
+    template <int N>
+    FORCEINLINE
+    bool PacketMask<N>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < N);
+        return (mBits & (1u << i)) != 0;
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N>& PacketMask<N>::operator|=(PacketMask<N> rhs)
+    {
+        mBits |= rhs.mBits;
+        return *this;
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N>& PacketMask<N>::operator&=(PacketMask<N> rhs)
+    {
+        mBits &= rhs.mBits;
+        return *this;
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N>& PacketMask<N>::operator^=(PacketMask<N> rhs)
+    {
+        mBits ^= rhs.mBits;
+        return *this;
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N> operator~(PacketMask<N> a)
+    {
+        return PacketMask<N>(~a.bits() & ((1u << N) - 1));
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N> operator&(PacketMask<N> a, PacketMask<N> b)
+    {
+        return a &= b;
+    }
+
+    template <int N>
+    FORCEINLINE
+    PacketMask<N> operator|(PacketMask<N> a, PacketMask<N> b)
+    {
+        return a |= b;
+    }
+
+    template <int N>
+    FORCEINLINE
+    bool any(PacketMask<N> a)
+    {
+        return a.bits() != 0x0;
+    }
+
+    template <int N>
+    FORCEINLINE
+    bool all(PacketMask<N> a)
+    {
+        return a.bits() == (1u << N) - 1;
+    }
+
+    template <int N>
+    FORCEINLINE
+    bool none(PacketMask<N> a)
+    {
+        return a.bits() == 0x0;
+    }
+
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>::Packet()
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] = Scalar();
+        }
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>::Packet(Scalar s)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] = s;
+        }
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>::Packet(const Scalar* v)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] = v[i];
+        }
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar Packet<Scalar, N>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < N);
+        return mLane[i];
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar& Packet<Scalar, N>::operator[](int i)
+    {
+        ASSERT(0 <= i && i < N);
+        return mLane[i];
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>& Packet<Scalar, N>::operator+=(const Packet<Scalar, N>& a)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] += a[i];
+        }
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>& Packet<Scalar, N>::operator-=(const Packet<Scalar, N>& a)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] -= a[i];
+        }
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>& Packet<Scalar, N>::operator*=(const Packet<Scalar, N>& a)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] *= a[i];
+        }
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N>& Packet<Scalar, N>::operator/=(const Packet<Scalar, N>& a)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            mLane[i] /= a[i];
+        }
+        return *this;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    void store(Scalar* v, const Packet<Scalar, N>& a)
+    {
+        for (int i = 0; i != N; ++i)
+        {
+            v[i] = a[i];
+        }
+    }
+
+#define MT_PACKET_COMPARE(op)                                                                     \
+    template <typename Scalar, int N>                                                             \
+    FORCEINLINE                                                                                   \
+    PacketMask<N> operator op(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)             \
+    {                                                                                             \
+        uint32_t bits = 0;                                                                        \
+        for (int i = 0; i != N; ++i)                                                              \
+        {                                                                                         \
+            bits |= uint32_t(a[i] op b[i]) << i;                                                  \
+        }                                                                                         \
+        return PacketMask<N>(bits);                                                               \
+    }
+
+    MT_PACKET_COMPARE(==)
+    MT_PACKET_COMPARE(!=)
+    MT_PACKET_COMPARE(<)
+    MT_PACKET_COMPARE(<=)
+    MT_PACKET_COMPARE(>)
+    MT_PACKET_COMPARE(>=)
+
+#undef MT_PACKET_COMPARE
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator-(const Packet<Scalar, N>& a)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = -a[i];
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator+(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        Packet<Scalar, N> result(a);
+        return result += b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator-(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        Packet<Scalar, N> result(a);
+        return result -= b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator*(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        Packet<Scalar, N> result(a);
+        return result *= b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator/(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        Packet<Scalar, N> result(a);
+        return result /= b;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator+(const Packet<Scalar, N>& a, Scalar s)
+    {
+        return a + Packet<Scalar, N>(s);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator-(const Packet<Scalar, N>& a, Scalar s)
+    {
+        return a - Packet<Scalar, N>(s);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator*(const Packet<Scalar, N>& a, Scalar s)
+    {
+        return a * Packet<Scalar, N>(s);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator/(const Packet<Scalar, N>& a, Scalar s)
+    {
+        return a / Packet<Scalar, N>(s);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator+(Scalar s, const Packet<Scalar, N>& a)
+    {
+        return Packet<Scalar, N>(s) + a;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator-(Scalar s, const Packet<Scalar, N>& a)
+    {
+        return Packet<Scalar, N>(s) - a;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator*(Scalar s, const Packet<Scalar, N>& a)
+    {
+        return Packet<Scalar, N>(s) * a;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> operator/(Scalar s, const Packet<Scalar, N>& a)
+    {
+        return Packet<Scalar, N>(s) / a;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> select(PacketMask<N> mask, const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = mask[i] ? a[i] : b[i];
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    PacketMask<N> ispositive(const Packet<Scalar, N>& a)
+    {
+        return Packet<Scalar, N>() < a;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    PacketMask<N> isnegative(const Packet<Scalar, N>& a)
+    {
+        return a < Packet<Scalar, N>();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    PacketMask<N> iszero(const Packet<Scalar, N>& a)
+    {
+        return a == Packet<Scalar, N>();
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    PacketMask<N> isfinite(const Packet<Scalar, N>& a)
+    {
+        uint32_t bits = 0;
+        for (int i = 0; i != N; ++i)
+        {
+            bits |= uint32_t(isfinite(a[i])) << i;
+        }
+        return PacketMask<N>(bits);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> min(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        return select(b < a, b, a);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> max(const Packet<Scalar, N>& a, const Packet<Scalar, N>& b)
+    {
+        return select(a < b, b, a);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> abs(const Packet<Scalar, N>& a)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = abs(a[i]);
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> sqrt(const Packet<Scalar, N>& a)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = sqrt(a[i]);
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> rsqrt(const Packet<Scalar, N>& a)
+    {
+        ASSERT(all(ispositive(a)));
+        return Scalar(1) / sqrt(a);
+    }
+
+    template <typename Scalar, int N, typename Policy>
+    FORCEINLINE
+    Packet<Scalar, N> rcp(const Packet<Scalar, N>& a, Policy p)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = rcp(a[i], p);
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N, typename Policy>
+    FORCEINLINE
+    Packet<Scalar, N> rsqrt(const Packet<Scalar, N>& a, Policy p)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = rsqrt(a[i], p);
+        }
+        return result;
+    }
+
+    template <typename Element, typename Scalar, int N>
+    FORCEINLINE
+    Element div(const Element& e, const Packet<Scalar, N>& s, Exact)
+    {
+        ASSERT(none(iszero(s)));
+        return e / s;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Scalar hsum(const Packet<Scalar, N>& a)
+    {
+        Scalar result = a[0];
+        for (int i = 1; i != N; ++i)
+        {
+            result += a[i];
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> floor(const Packet<Scalar, N>& a)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = floor(a[i]);
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> ldexp(const Packet<Scalar, N>& a, const Packet<Scalar, N>& e)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = ldexp(a[i], int(e[i]));
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> frexp(const Packet<Scalar, N>& a, Packet<Scalar, N>* e)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            int exponent;
+            result[i] = frexp(a[i], &exponent);
+            (*e)[i] = Scalar(exponent);
+        }
+        return result;
+    }
+
+
+    template <typename Scalar, int N>
+    struct ScalarTraits<Packet<Scalar, N> >
+    {
+        static Packet<Scalar, N> pi()
+        {
+            return Packet<Scalar, N>(ScalarTraits<Scalar>::pi());
+        }
+
+        static Packet<Scalar, N> infinity()
+        {
+            return Packet<Scalar, N>(ScalarTraits<Scalar>::infinity());
+        }
+
+        static Packet<Scalar, N> epsilon()
+        {
+            return Packet<Scalar, N>(ScalarTraits<Scalar>::epsilon());
+        }
+
+        static Packet<Scalar, N> max()
+        {
+            return Packet<Scalar, N>(ScalarTraits<Scalar>::max());
+        }
+    };
+
+#ifndef HAVE_TYPEOF
+
+    // Mixing lanes with plain scalars yields lanes.
+
+    template <typename Scalar, int N>
+    struct Promote<Scalar, Packet<Scalar, N> >
+    {
+        typedef Packet<Scalar, N> RT;
+    };
+
+    template <typename Scalar, int N>
+    struct Promote<int, Packet<Scalar, N> >
+    {
+        typedef Packet<Scalar, N> RT;
+    };
+
+    template <int N>
+    struct Promote<int, Packet<int, N> >
+    {
+        typedef Packet<int, N> RT;
+    };
+
+#endif
+}
+
+#if USE_SSE
+#include <moto/Packet_SSE.hpp>
+#endif
+
+#if USE_AVX
+#include <moto/Packet_AVX.hpp>
+#endif
+
+#endif
@@ -0,0 +1,520 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PACKETMATH_HPP
+#define MT_PACKETMATH_HPP
+
+#include <moto/Packet.hpp>
+#include <moto/Vector3.hpp>
+#include <moto/Vector4.hpp>
+#include <moto/Metric.hpp>
+
+namespace mt
+{
+    // Lane-wise transcendental functions on packets. For float lanes, these are the single-precision
+    // polynomial approximations of Cephes, written in packet arithmetic plus the primitives floor,
+    // ldexp and frexp, so that Packet<float, 4> and Packet<float, 8> evaluate them in SSE and AVX
+    // registers. Other lane types call the C library per lane.
+    //
+    // Maximum error in units in the last place (ULP) with respect to the correctly rounded result:
+    //
+    //   sin, cos, sincos    2 ULP   for |x| <= 8192, except near the zeros of the functions, where the
+    //                               absolute error is below 1e-7 and the relative error may be large
+    //   asin                2 ULP   arguments are clamped to [-1, 1], as mt::asin and mt::acos do
+    //   acos                1 ULP
+    //   atan, atan2         3 ULP   atan2(0, 0) is 0, the sign of a zero y is ignored, and atan2 of
+    //                               two infinities is NaN
+    //   exp                 1 ULP   for normal results, overflows to infinity and underflows to zero
+    //   log                 1 ULP   log(0) is -infinity and log(x) for negative x is NaN
+    //
+    // NaNs propagate. Arguments beyond the stated ranges yield meaningless results. The batch forms at the end apply the widest float packet of the target to arrays.
+
+    template <typename Scalar, int N> void sincos(const Packet<Scalar, N>& x, Packet<Scalar, N>& s, Packet<Scalar, N>& c);
+    template <typename Scalar, int N> Packet<Scalar, N> sin(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> cos(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> asin(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> acos(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> atan(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> atan2(const Packet<Scalar, N>& y, const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> exp(const Packet<Scalar, N>& x);
+    template <typename Scalar, int N> Packet<Scalar, N> log(const Packet<Scalar, N>& x);
+
+    template <int N> void sincos(const Packet<float, N>& x, Packet<float, N>& s, Packet<float, N>& c);
+    template <int N> Packet<float, N> sin(const Packet<float, N>& x);
+    template <int N> Packet<float, N> cos(const Packet<float, N>& x);
+    template <int N> Packet<float, N> asin(const Packet<float, N>& x);
+    template <int N> Packet<float, N> acos(const Packet<float, N>& x);
+    template <int N> Packet<float, N> atan(const Packet<float, N>& x);
+    template <int N> Packet<float, N> atan2(const Packet<float, N>& y, const Packet<float, N>& x);
+    template <int N> Packet<float, N> exp(const Packet<float, N>& x);
+    template <int N> Packet<float, N> log(const Packet<float, N>& x);
+
+    // Lane-wise normalization of vectors of packets. The generic normalize branches on the length of
+    // the whole packet, so these select per lane instead, and pass lanes of zero length on unchanged.
+    template <typename Scalar, int N> Vector3<Packet<Scalar, N> > normalize(const Vector3<Packet<Scalar, N> >& v);
+    template <typename Scalar, int N> Vector4<Packet<Scalar, N> > normalize(const Vector4<Packet<Scalar, N> >& v);
+    template <typename Scalar, int N, typename Policy> Vector3<Packet<Scalar, N> > normalize(const Vector3<Packet<Scalar, N> >& v, Policy p);
+    template <typename Scalar, int N, typename Policy> Vector4<Packet<Scalar, N> > normalize(const Vector4<Packet<Scalar, N> >& v, Policy p);
+
+#if USE_AVX
+    typedef Packet<float, 8> FloatPacket;
+#else
+    typedef Packet<float, 4> FloatPacket;
+#endif
+
+    void sincos(const float* x, float* s, float* c, size_t n);
+    void sin(const float* x, float* y, size_t n);
+    void cos(const float* x, float* y, size_t n);
+    void asin(const float* x, float* y, size_t n);
+    void acos(const float* x, float* y, size_t n);
+    void atan(const float* x, float* y, size_t n);
+    void atan2(const float* y, const float* x, float* z, size_t n);
+    void exp(const float* x, float* y, size_t n);
+    void log(const float* x, float* y, size_t n);
+
+
+
+#define MT_PACKET_LANEWISE(name)                                                                  \
+    template <typename Scalar, int N>                                                             \
+    FORCEINLINE                                                                                   \
+    Packet<Scalar, N> name(const Packet<Scalar, N>& x)                                            \
+    {                                                                                             \
+        Packet<Scalar, N> result;                                                                 \
+        for (int i = 0; i != N; ++i)                                                              \
+        {                                                                                         \
+            result[i] = name(x[i]);                                                               \
+        }                                                                                         \
+        return result;                                                                            \
+    }
+
+    MT_PACKET_LANEWISE(sin)
+    MT_PACKET_LANEWISE(cos)
+    MT_PACKET_LANEWISE(asin)
+    MT_PACKET_LANEWISE(acos)
+    MT_PACKET_LANEWISE(atan)
+    MT_PACKET_LANEWISE(exp)
+    MT_PACKET_LANEWISE(log)
+
+#undef MT_PACKET_LANEWISE
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    void sincos(const Packet<Scalar, N>& x, Packet<Scalar, N>& s, Packet<Scalar, N>& c)
+    {
+        s = sin(x);
+        c = cos(x);
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Packet<Scalar, N> atan2(const Packet<Scalar, N>& y, const Packet<Scalar, N>& x)
+    {
+        Packet<Scalar, N> result;
+        for (int i = 0; i != N; ++i)
+        {
+            result[i] = atan2(y[i], x[i]);
+        }
+        return result;
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Vector3<Packet<Scalar, N> > normalize(const Vector3<Packet<Scalar, N> >& v)
+    {
+        Packet<Scalar, N> s = lengthSquared(v);
+        PacketMask<N> positive = ispositive(s);
+        return v * select(positive, rsqrt(select(positive, s, Packet<Scalar, N>(Scalar(1)))), Packet<Scalar, N>(Scalar(1)));
+    }
+
+    template <typename Scalar, int N>
+    FORCEINLINE
+    Vector4<Packet<Scalar, N> > normalize(const Vector4<Packet<Scalar, N> >& v)
+    {
+        Packet<Scalar, N> s = lengthSquared(v);
+        PacketMask<N> positive = ispositive(s);
+        return v * select(positive, rsqrt(select(positive, s, Packet<Scalar, N>(Scalar(1)))), Packet<Scalar, N>(Scalar(1)));
+    }
+
+    template <typename Scalar, int N, typename Policy>
+    FORCEINLINE
+    Vector3<Packet<Scalar, N> > normalize(const Vector3<Packet<Scalar, N> >& v, Policy p)
+    {
+        Packet<Scalar, N> s = lengthSquared(v);
+        PacketMask<N> positive = ispositive(s);
+        return v * select(positive, rsqrt(select(positive, s, Packet<Scalar, N>(Scalar(1))), p), Packet<Scalar, N>(Scalar(1)));
+    }
+
+    template <typename Scalar, int N, typename Policy>
+    FORCEINLINE
+    Vector4<Packet<Scalar, N> > normalize(const Vector4<Packet<Scalar, N> >& v, Policy p)
+    {
+        Packet<Scalar, N> s = lengthSquared(v);
+        PacketMask<N> positive = ispositive(s);
+        return v * select(positive, rsqrt(select(positive, s, Packet<Scalar, N>(Scalar(1))), p), Packet<Scalar, N>(Scalar(1)));
+    }
+
+
+    template <int N>
+    FORCEINLINE
+    void sincos(const Packet<float, N>& x, Packet<float, N>& s, Packet<float, N>& c)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Reduces x to r = x - q pi/2 in [-pi/4, pi/4]. The three parts of pi/2 are short enough
+        // for their products with q to be exact for |q| < 2^13 (Cody-Waite).
+        Lanes q = floor(x * 0.636619772367581343f + 0.5f);
+        Lanes r = x - q * 1.5703125f;
+        r -= q * 4.837512969970703125e-4f;
+        r -= q * 7.54978995489188216e-8f;
+
+        Lanes z = r * r;
+        Lanes sr = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+        Lanes cr = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+
+        // The quadrant q mod 4 selects and negates the results for r.
+        Lanes m = q - floor(q * 0.25f) * 4.0f;
+        PacketMask<N> odd = (m == Lanes(1.0f)) | (m == Lanes(3.0f));
+        s = select(odd, cr, sr);
+        c = select(odd, sr, cr);
+        s = select(m >= Lanes(2.0f), -s, s);
+        c = select((m == Lanes(1.0f)) | (m == Lanes(2.0f)), -c, c);
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> sin(const Packet<float, N>& x)
+    {
+        Packet<float, N> s, c;
+        sincos(x, s, c);
+        return s;
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> cos(const Packet<float, N>& x)
+    {
+        Packet<float, N> s, c;
+        sincos(x, s, c);
+        return c;
+    }
+
+    // asin(s) for s in [0, 1/2], where z = s^2
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> asinPolynomial(const Packet<float, N>& s, const Packet<float, N>& z)
+    {
+        return ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z + 7.4953002686e-2f) * z + 1.6666752422e-1f) * z * s + s;
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> asin(const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Beyond 1/2, asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)).
+        Lanes a = min(abs(x), Lanes(1.0f));
+        PacketMask<N> big = a > Lanes(0.5f);
+        Lanes z = select(big, (1.0f - a) * 0.5f, a * a);
+        Lanes p = asinPolynomial(select(big, sqrt(z), a), z);
+        p = select(big, 1.57079632679489662f - (p + p), p);
+        p = select(isnegative(x), -p, p);
+        return select(x != x, x, p);
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> acos(const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Up to 1/2, acos(x) = pi/2 - asin(x). Beyond, acos(a) = 2 asin(sqrt((1 - a) / 2)) and
+        // acos(-a) = pi - acos(a).
+        Lanes a = min(abs(x), Lanes(1.0f));
+        PacketMask<N> big = a > Lanes(0.5f);
+        PacketMask<N> negative = isnegative(x);
+        Lanes z = select(big, (1.0f - a) * 0.5f, a * a);
+        Lanes p = asinPolynomial(select(big, sqrt(z), a), z);
+        Lanes twice = p + p;
+        Lanes result = select(big, select(negative, 3.14159265358979324f - twice, twice),
+                              1.57079632679489662f - select(negative, -p, p));
+        return select(x != x, x, result);
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> atan(const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Reduces a = |x| to t in [-tan(pi/8), tan(pi/8)] by atan(a) = pi/4 + atan((a - 1) / (a + 1))
+        // and atan(a) = pi/2 + atan(-1 / a), using a single division.
+        Lanes a = abs(x);
+        PacketMask<N> big = a > Lanes(2.414213562373095f);
+        PacketMask<N> mid = a > Lanes(0.4142135623730950f);
+        Lanes num = select(big, Lanes(-1.0f), select(mid, a - 1.0f, a));
+        Lanes den = select(big, a, select(mid, a + 1.0f, Lanes(1.0f)));
+        Lanes y0 = select(big, Lanes(1.57079632679489662f), select(mid, Lanes(0.785398163397448310f), Lanes()));
+        Lanes t = num / den;
+        Lanes z = t * t;
+        Lanes y = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + t + y0;
+        return select(isnegative(x), -y, y);
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> atan2(const Packet<float, N>& y, const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // For negative x, atan(y / x) is off by pi. Zero x is handled apart, since y / -0 flips the sign.
+        Lanes result = atan(y / x);
+        Lanes offset = select(isnegative(y), Lanes(-3.14159265358979324f), Lanes(3.14159265358979324f));
+        result = select(isnegative(x), result + offset, result);
+        Lanes axis = select(isnegative(y), Lanes(-1.57079632679489662f), Lanes(1.57079632679489662f));
+        result = select(iszero(x), select(iszero(y), Lanes(), axis), result);
+        return select(y != y, y, result);
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> exp(const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Reduces x to r = x - q log(2) in [-log(2)/2, log(2)/2], and returns 2^q exp(r). Beyond the
+        // clamping bounds, the result overflows or underflows anyway.
+        Lanes a = min(max(x, Lanes(-104.0f)), Lanes(89.0f));
+        Lanes q = floor(a * 1.44269504088896341f + 0.5f);
+        Lanes r = a - q * 0.693359375f;
+        r -= q * -2.12194440e-4f;
+
+        Lanes y = (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1.0f;
+        return select(x != x, x, ldexp(y, q));
+    }
+
+    template <int N>
+    FORCEINLINE
+    Packet<float, N> log(const Packet<float, N>& x)
+    {
+        typedef Packet<float, N> Lanes;
+
+        // Subnormals are scaled by 2^25 first, since frexp reads the exponent field.
+        PacketMask<N> tiny = x < Lanes(1.17549435e-38f);
+        Lanes e;
+        Lanes m = frexp(select(tiny, x * 33554432.0f, x), &e);
+        e = select(tiny, e - 25.0f, e);
+
+        // Takes the mantissa to [sqrt(1/2), sqrt(2)), and evaluates log(1 + m) for the remainder m.
+        PacketMask<N> low = m < Lanes(0.707106781186547524f);
+        e = select(low, e - 1.0f, e);
+        m = select(low, m + m, m) - 1.0f;
+
+        Lanes z = m * m;
+        Lanes y = ((((((((7.0376836292e-2f * m - 1.1514610310e-1f) * m + 1.1676998740e-1f) * m - 1.2420140846e-1f) * m + 1.4249322787e-1f) * m - 1.6668057665e-1f) * m + 2.0000714765e-1f) * m - 2.4999993993e-1f) * m + 3.3333331174e-1f) * m * z;
+        y += e * -2.12194440e-4f;
+        y -= 0.5f * z;
+        Lanes result = m + y;
+        result += e * 0.693359375f;
+
+        result = select(x == Lanes(ScalarTraits<float>::infinity()), x, result);
+        result = select(iszero(x), Lanes(-ScalarTraits<float>::infinity()), result);
+        return select(isnegative(x) | (x != x), Lanes(std::numeric_limits<float>::quiet_NaN()), result);
+    }
+
+
+    namespace detail
+    {
+        // Runs f over whole packets, and over a last partial packet that is padded with a value in
+        // the domain of f.
+        FORCEINLINE
+        void apply(FloatPacket (*f)(const FloatPacket&), const float* x, float* y, size_t n, float pad)
+        {
+            const size_t N = FloatPacket::SIZE;
+            size_t i = 0;
+            for (; i + N <= n; i += N)
+            {
+                store(y + i, f(FloatPacket(x + i)));
+            }
+            if (i != n)
+            {
+                FloatPacket a(pad);
+                for (size_t k = 0; i + k != n; ++k)
+                {
+                    a[int(k)] = x[i + k];
+                }
+                FloatPacket b = f(a);
+                for (size_t k = 0; i + k != n; ++k)
+                {
+                    y[i + k] = b[int(k)];
+                }
+            }
+        }
+
+        // Lanes i to i + N of a stream, padded with the given value past n
+        FORCEINLINE
+        FloatPacket loadLanes(const float* t, size_t i, size_t n, float padding = 0.0f)
+        {
+            const size_t N = FloatPacket::SIZE;
+            if (i + N <= n)
+            {
+                return FloatPacket(t + i);
+            }
+            FloatPacket result(padding);
+            for (size_t k = 0; i + k < n; ++k)
+            {
+                result[int(k)] = t[i + k];
+            }
+            return result;
+        }
+
+        FORCEINLINE
+        void storeLanes(float* t, size_t i, size_t n, const FloatPacket& a)
+        {
+            const size_t N = FloatPacket::SIZE;
+            if (i + N <= n)
+            {
+                store(t + i, a);
+            }
+            else
+            {
+                for (size_t k = 0; i + k < n; ++k)
+                {
+                    t[i + k] = a[int(k)];
+                }
+            }
+        }
+
+        // Lanes i to i + N of four component streams, padded with the identity past n
+        FORCEINLINE
+        Vector4<FloatPacket> loadLanes(const float* const u[4], size_t i, size_t n)
+        {
+            const size_t N = FloatPacket::SIZE;
+            if (i + N <= n)
+            {
+                return Vector4<FloatPacket>(FloatPacket(u[0] + i), FloatPacket(u[1] + i), FloatPacket(u[2] + i), FloatPacket(u[3] + i));
+            }
+            Vector4<FloatPacket> result(FloatPacket(), FloatPacket(), FloatPacket(), FloatPacket(1.0f));
+            for (size_t k = 0; i + k < n; ++k)
+            {
+                for (int j = 0; j != 4; ++j)
+                {
+                    result[j][int(k)] = u[j][i + k];
+                }
+            }
+            return result;
+        }
+
+        FORCEINLINE
+        void storeLanes(float* const u[4], size_t i, size_t n, const Vector4<FloatPacket>& v)
+        {
+            for (int j = 0; j != 4; ++j)
+            {
+                storeLanes(u[j], i, n, v[j]);
+            }
+        }
+    }
+
+    inline
+    void sincos(const float* x, float* s, float* c, size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        size_t i = 0;
+        for (; i + N <= n; i += N)
+        {
+            FloatPacket ps, pc;
+            sincos(FloatPacket(x + i), ps, pc);
+            store(s + i, ps);
+            store(c + i, pc);
+        }
+        if (i != n)
+        {
+            FloatPacket a;
+            for (size_t k = 0; i + k != n; ++k)
+            {
+                a[int(k)] = x[i + k];
+            }
+            FloatPacket ps, pc;
+            sincos(a, ps, pc);
+            for (size_t k = 0; i + k != n; ++k)
+            {
+                s[i + k] = ps[int(k)];
+                c[i + k] = pc[int(k)];
+            }
+        }
+    }
+
+    inline
+    void sin(const float* x, float* y, size_t n)
+    {
+        detail::apply(sin, x, y, n, 0.0f);
+    }
+
+    inline
+    void cos(const float* x, float* y, size_t n)
+    {
+        detail::apply(cos, x, y, n, 0.0f);
+    }
+
+    inline
+    void asin(const float* x, float* y, size_t n)
+    {
+        detail::apply(asin, x, y, n, 0.0f);
+    }
+
+    inline
+    void acos(const float* x, float* y, size_t n)
+    {
+        detail::apply(acos, x, y, n, 0.0f);
+    }
+
+    inline
+    void atan(const float* x, float* y, size_t n)
+    {
+        detail::apply(atan, x, y, n, 0.0f);
+    }
+
+    inline
+    void atan2(const float* y, const float* x, float* z, size_t n)
+    {
+        const size_t N = FloatPacket::SIZE;
+        size_t i = 0;
+        for (; i + N <= n; i += N)
+        {
+            store(z + i, atan2(FloatPacket(y + i), FloatPacket(x + i)));
+        }
+        if (i != n)
+        {
+            FloatPacket a(1.0f), b(1.0f);
+            for (size_t k = 0; i + k != n; ++k)
+            {
+                a[int(k)] = y[i + k];
+                b[int(k)] = x[i + k];
+            }
+            FloatPacket c = atan2(a, b);
+            for (size_t k = 0; i + k != n; ++k)
+            {
+                z[i + k] = c[int(k)];
+            }
+        }
+    }
+
+    inline
+    void exp(const float* x, float* y, size_t n)
+    {
+        detail::apply(exp, x, y, n, 0.0f);
+    }
+
+    inline
+    void log(const float* x, float* y, size_t n)
+    {
+        detail::apply(log, x, y, n, 1.0f);
+    }
+}
+
+#endif
@@ -0,0 +1,536 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PACKET_HPP
+#error This header file should be included by Packet.hpp only.
+#endif
+
+#include <immintrin.h>
+
+namespace mt
+{
+    // As PacketMask<4>, a full lane mask in a register
+    template <>
+    class PacketMask<8>
+    {
+    public:
+        PacketMask();
+        explicit PacketMask(uint32_t bits);
+        explicit PacketMask(__m256 v);
+
+        uint32_t bits() const;
+        bool operator[](int i) const;
+
+        PacketMask<8>& operator|=(PacketMask<8> rhs);
+        PacketMask<8>& operator&=(PacketMask<8> rhs);
+        PacketMask<8>& operator^=(PacketMask<8> rhs);
+
+        __m256 vec;
+    };
+
+    PacketMask<8> operator~(PacketMask<8> a);
+    PacketMask<8> operator&(PacketMask<8> a, PacketMask<8> b);
+    PacketMask<8> operator|(PacketMask<8> a, PacketMask<8> b);
+
+
+    template <>
+    class Packet<float, 8>
+    {
+    public:
+        typedef float ScalarType;
+        typedef PacketMask<8> MaskType;
+
+        enum { SIZE = 8 };
+
+        Packet();
+        Packet(float s);
+        explicit Packet(__m256 v);
+        explicit Packet(const float* v);
+
+        float operator[](int i) const;
+        float& operator[](int i);
+
+        Packet<float, 8>& operator+=(const Packet<float, 8>& a);
+        Packet<float, 8>& operator-=(const Packet<float, 8>& a);
+        Packet<float, 8>& operator*=(const Packet<float, 8>& a);
+        Packet<float, 8>& operator/=(const Packet<float, 8>& a);
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4201)
+#endif
+
+        union
+        {
+            float lane[8];
+            __m256 vec;
+        };
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    };
+
+    void store(float* v, const Packet<float, 8>& a);
+
+    PacketMask<8> operator==(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    PacketMask<8> operator!=(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    PacketMask<8> operator<(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    PacketMask<8> operator<=(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    PacketMask<8> operator>(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    PacketMask<8> operator>=(const Packet<float, 8>& a, const Packet<float, 8>& b);
+
+    Packet<float, 8> operator-(const Packet<float, 8>& a);
+
+    Packet<float, 8> operator+(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    Packet<float, 8> operator-(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    Packet<float, 8> operator*(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    Packet<float, 8> operator/(const Packet<float, 8>& a, const Packet<float, 8>& b);
+
+    Packet<float, 8> operator+(const Packet<float, 8>& a, float s);
+    Packet<float, 8> operator-(const Packet<float, 8>& a, float s);
+    Packet<float, 8> operator*(const Packet<float, 8>& a, float s);
+    Packet<float, 8> operator/(const Packet<float, 8>& a, float s);
+
+    Packet<float, 8> operator+(float s, const Packet<float, 8>& a);
+    Packet<float, 8> operator-(float s, const Packet<float, 8>& a);
+    Packet<float, 8> operator*(float s, const Packet<float, 8>& a);
+    Packet<float, 8> operator/(float s, const Packet<float, 8>& a);
+
+    Packet<float, 8> select(PacketMask<8> mask, const Packet<float, 8>& a, const Packet<float, 8>& b);
+
+    PacketMask<8> ispositive(const Packet<float, 8>& a);
+    PacketMask<8> isnegative(const Packet<float, 8>& a);
+    PacketMask<8> iszero(const Packet<float, 8>& a);
+    PacketMask<8> isfinite(const Packet<float, 8>& a);
+
+    Packet<float, 8> min(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    Packet<float, 8> max(const Packet<float, 8>& a, const Packet<float, 8>& b);
+    Packet<float, 8> abs(const Packet<float, 8>& a);
+    Packet<float, 8> sqrt(const Packet<float, 8>& a);
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a);
+    Packet<float, 8> rcp(const Packet<float, 8>& a, Exact);
+    Packet<float, 8> rcp(const Packet<float, 8>& a, Fast);
+    Packet<float, 8> rcp(const Packet<float, 8>& a, FastRefined);
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, Exact);
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, Fast);
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, FastRefined);
+
+    float hsum(const Packet<float, 8>& a);
+
+    Packet<float, 8> floor(const Packet<float, 8>& a);
+    Packet<float, 8> ldexp(const Packet<float, 8>& a, const Packet<float, 8>& e);
+    Packet<float, 8> frexp(const Packet<float, 8>& a, Packet<float, 8>* e);
+
+
+    FORCEINLINE
+    PacketMask<8>::PacketMask()
+    {}
+
+    // AVX has no 256-bit integer compare, so the halves are expanded separately.
+    FORCEINLINE
+    PacketMask<8>::PacketMask(uint32_t bits)
+    {
+        __m128i flags = _mm_setr_epi32(1, 2, 4, 8);
+        __m128i lo = _mm_set1_epi32(int(bits & 0xf));
+        __m128i hi = _mm_set1_epi32(int(bits >> 4));
+        vec = _mm256_castps128_ps256(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(lo, flags), flags)));
+        vec = _mm256_insertf128_ps(vec, _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hi, flags), flags)), 1);
+    }
+
+    FORCEINLINE
+    PacketMask<8>::PacketMask(__m256 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    uint32_t PacketMask<8>::bits() const
+    {
+        return uint32_t(_mm256_movemask_ps(vec));
+    }
+
+    FORCEINLINE
+    bool PacketMask<8>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < 8);
+        return (bits() & (1u << i)) != 0;
+    }
+
+    FORCEINLINE
+    PacketMask<8>& PacketMask<8>::operator|=(PacketMask<8> rhs)
+    {
+        vec = _mm256_or_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<8>& PacketMask<8>::operator&=(PacketMask<8> rhs)
+    {
+        vec = _mm256_and_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<8>& PacketMask<8>::operator^=(PacketMask<8> rhs)
+    {
+        vec = _mm256_xor_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator~(PacketMask<8> a)
+    {
+        return PacketMask<8>(_mm256_xor_ps(a.vec, _mm256_castsi256_ps(_mm256_set1_epi32(-1))));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator&(PacketMask<8> a, PacketMask<8> b)
+    {
+        return a &= b;
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator|(PacketMask<8> a, PacketMask<8> b)
+    {
+        return a |= b;
+    }
+
+
+    FORCEINLINE
+    Packet<float, 8>::Packet()
+        : vec(_mm256_setzero_ps())
+    {}
+
+    FORCEINLINE
+    Packet<float, 8>::Packet(float s)
+        : vec(_mm256_set1_ps(s))
+    {}
+
+    FORCEINLINE
+    Packet<float, 8>::Packet(__m256 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    Packet<float, 8>::Packet(const float* v)
+        : vec(_mm256_loadu_ps(v))
+    {}
+
+    FORCEINLINE
+    float Packet<float, 8>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < 8);
+        return lane[i];
+    }
+
+    FORCEINLINE
+    float& Packet<float, 8>::operator[](int i)
+    {
+        ASSERT(0 <= i && i < 8);
+        return lane[i];
+    }
+
+    FORCEINLINE
+    Packet<float, 8>& Packet<float, 8>::operator+=(const Packet<float, 8>& a)
+    {
+        vec = _mm256_add_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 8>& Packet<float, 8>::operator-=(const Packet<float, 8>& a)
+    {
+        vec = _mm256_sub_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 8>& Packet<float, 8>::operator*=(const Packet<float, 8>& a)
+    {
+        vec = _mm256_mul_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 8>& Packet<float, 8>::operator/=(const Packet<float, 8>& a)
+    {
+        vec = _mm256_div_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    void store(float* v, const Packet<float, 8>& a)
+    {
+        _mm256_storeu_ps(v, a.vec);
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator==(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_EQ_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator!=(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_NEQ_UQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator<(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_LT_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator<=(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_LE_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator>(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_GT_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> operator>=(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, b.vec, _CMP_GE_OQ));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator-(const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_sub_ps(_mm256_setzero_ps(), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator+(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_add_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator-(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_sub_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator*(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_mul_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator/(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_div_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator+(const Packet<float, 8>& a, float s)
+    {
+        return Packet<float, 8>(_mm256_add_ps(a.vec, _mm256_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator-(const Packet<float, 8>& a, float s)
+    {
+        return Packet<float, 8>(_mm256_sub_ps(a.vec, _mm256_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator*(const Packet<float, 8>& a, float s)
+    {
+        return Packet<float, 8>(_mm256_mul_ps(a.vec, _mm256_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator/(const Packet<float, 8>& a, float s)
+    {
+        return Packet<float, 8>(_mm256_div_ps(a.vec, _mm256_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator+(float s, const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_add_ps(_mm256_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator-(float s, const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_sub_ps(_mm256_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator*(float s, const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_mul_ps(_mm256_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> operator/(float s, const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_div_ps(_mm256_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> select(PacketMask<8> mask, const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_blendv_ps(b.vec, a.vec, mask.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<8> ispositive(const Packet<float, 8>& a)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, _mm256_setzero_ps(), _CMP_GT_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> isnegative(const Packet<float, 8>& a)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> iszero(const Packet<float, 8>& a)
+    {
+        return PacketMask<8>(_mm256_cmp_ps(a.vec, _mm256_setzero_ps(), _CMP_EQ_OQ));
+    }
+
+    FORCEINLINE
+    PacketMask<8> isfinite(const Packet<float, 8>& a)
+    {
+        __m256 mag = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.vec);
+        return PacketMask<8>(_mm256_cmp_ps(mag, _mm256_set1_ps(ScalarTraits<float>::infinity()), _CMP_LT_OQ));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> min(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_min_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> max(const Packet<float, 8>& a, const Packet<float, 8>& b)
+    {
+        return Packet<float, 8>(_mm256_max_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> abs(const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> sqrt(const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_sqrt_ps(a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a)
+    {
+        ASSERT(all(ispositive(a)));
+        return Packet<float, 8>(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(a.vec)));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rcp(const Packet<float, 8>& a, Exact)
+    {
+        return Packet<float, 8>(_mm256_div_ps(_mm256_set1_ps(1.0f), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rcp(const Packet<float, 8>& a, Fast)
+    {
+        return Packet<float, 8>(_mm256_rcp_ps(a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rcp(const Packet<float, 8>& a, FastRefined)
+    {
+        __m256 r = _mm256_rcp_ps(a.vec);
+        return Packet<float, 8>(_mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_mul_ps(a.vec, r))));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, Exact)
+    {
+        return rsqrt(a);
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, Fast)
+    {
+        ASSERT(all(ispositive(a)));
+        return Packet<float, 8>(_mm256_rsqrt_ps(a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> rsqrt(const Packet<float, 8>& a, FastRefined)
+    {
+        ASSERT(all(ispositive(a)));
+        __m256 r = _mm256_rsqrt_ps(a.vec);
+        __m256 h = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), a.vec), _mm256_mul_ps(r, r));
+        return Packet<float, 8>(_mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.5f), h)));
+    }
+
+    FORCEINLINE
+    float hsum(const Packet<float, 8>& a)
+    {
+        __m128 tmp = _mm_add_ps(_mm256_castps256_ps128(a.vec), _mm256_extractf128_ps(a.vec, 1));
+        tmp = _mm_add_ps(tmp, _mm_movehl_ps(tmp, tmp));
+        tmp = _mm_add_ss(tmp, _mm_shuffle_ps(tmp, tmp, 1));
+        return _mm_cvtss_f32(tmp);
+    }
+
+    FORCEINLINE
+    Packet<float, 8> floor(const Packet<float, 8>& a)
+    {
+        return Packet<float, 8>(_mm256_floor_ps(a.vec));
+    }
+
+    namespace detail
+    {
+        // 2^e for integral e in [-126, 127]. AVX has no 256-bit integer shifts, so the exponent field
+        // is computed as the float (e + 127) * 2^23 and converted to its integer bits.
+        FORCEINLINE
+        __m256 pow2(__m256 e)
+        {
+            __m256 bits = _mm256_mul_ps(_mm256_add_ps(e, _mm256_set1_ps(127.0f)), _mm256_set1_ps(8388608.0f));
+            return _mm256_castsi256_ps(_mm256_cvtps_epi32(bits));
+        }
+    }
+
+    FORCEINLINE
+    Packet<float, 8> ldexp(const Packet<float, 8>& a, const Packet<float, 8>& e)
+    {
+        // Scales in two steps, so that e may range over [-252, 254] and results may be subnormal.
+        __m256 e1 = _mm256_floor_ps(_mm256_mul_ps(e.vec, _mm256_set1_ps(0.5f)));
+        return Packet<float, 8>(_mm256_mul_ps(_mm256_mul_ps(a.vec, detail::pow2(e1)), detail::pow2(_mm256_sub_ps(e.vec, e1))));
+    }
+
+    FORCEINLINE
+    Packet<float, 8> frexp(const Packet<float, 8>& a, Packet<float, 8>* e)
+    {
+        // Reads the exponent field, so a must be a normal number. The masked field converts to the
+        // float E * 2^23 exactly.
+        __m256 bits = _mm256_and_ps(a.vec, _mm256_castsi256_ps(_mm256_set1_epi32(0x7f800000)));
+        __m256 field = _mm256_cvtepi32_ps(_mm256_castps_si256(bits));
+        e->vec = _mm256_sub_ps(_mm256_mul_ps(field, _mm256_set1_ps(1.0f / 8388608.0f)), _mm256_set1_ps(126.0f));
+        __m256 mantissa = _mm256_and_ps(a.vec, _mm256_castsi256_ps(_mm256_set1_epi32(int(0x807fffff))));
+        return Packet<float, 8>(_mm256_or_ps(mantissa, _mm256_set1_ps(0.5f)));
+    }
+}
@@ -0,0 +1,506 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PACKET_HPP
+#error This header file should be included by Packet.hpp only.
+#endif
+
+#include <moto/SSE.hpp>
+
+#include <emmintrin.h>
+
+namespace mt
+{
+    // The mask of Packet<float, 4> holds all ones or all zeros in each lane. It is also the mask of
+    // the generic four-lane packets, which construct it from bits.
+    template <>
+    class PacketMask<4>
+    {
+    public:
+        PacketMask();
+        explicit PacketMask(uint32_t bits);
+        explicit PacketMask(__m128 v);
+
+        uint32_t bits() const;
+        bool operator[](int i) const;
+
+        PacketMask<4>& operator|=(PacketMask<4> rhs);
+        PacketMask<4>& operator&=(PacketMask<4> rhs);
+        PacketMask<4>& operator^=(PacketMask<4> rhs);
+
+        __m128 vec;
+    };
+
+    PacketMask<4> operator~(PacketMask<4> a);
+    PacketMask<4> operator&(PacketMask<4> a, PacketMask<4> b);
+    PacketMask<4> operator|(PacketMask<4> a, PacketMask<4> b);
+
+
+    template <>
+    class Packet<float, 4>
+    {
+    public:
+        typedef float ScalarType;
+        typedef PacketMask<4> MaskType;
+
+        enum { SIZE = 4 };
+
+        Packet();
+        Packet(float s);
+        explicit Packet(__m128 v);
+        explicit Packet(const float* v);
+
+        float operator[](int i) const;
+        float& operator[](int i);
+
+        Packet<float, 4>& operator+=(const Packet<float, 4>& a);
+        Packet<float, 4>& operator-=(const Packet<float, 4>& a);
+        Packet<float, 4>& operator*=(const Packet<float, 4>& a);
+        Packet<float, 4>& operator/=(const Packet<float, 4>& a);
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4201)
+#endif
+
+        union
+        {
+            float lane[4];
+            __m128 vec;
+        };
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    };
+
+    void store(float* v, const Packet<float, 4>& a);
+
+    PacketMask<4> operator==(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    PacketMask<4> operator!=(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    PacketMask<4> operator<(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    PacketMask<4> operator<=(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    PacketMask<4> operator>(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    PacketMask<4> operator>=(const Packet<float, 4>& a, const Packet<float, 4>& b);
+
+    Packet<float, 4> operator-(const Packet<float, 4>& a);
+
+    Packet<float, 4> operator+(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    Packet<float, 4> operator-(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    Packet<float, 4> operator*(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    Packet<float, 4> operator/(const Packet<float, 4>& a, const Packet<float, 4>& b);
+
+    Packet<float, 4> operator+(const Packet<float, 4>& a, float s);
+    Packet<float, 4> operator-(const Packet<float, 4>& a, float s);
+    Packet<float, 4> operator*(const Packet<float, 4>& a, float s);
+    Packet<float, 4> operator/(const Packet<float, 4>& a, float s);
+
+    Packet<float, 4> operator+(float s, const Packet<float, 4>& a);
+    Packet<float, 4> operator-(float s, const Packet<float, 4>& a);
+    Packet<float, 4> operator*(float s, const Packet<float, 4>& a);
+    Packet<float, 4> operator/(float s, const Packet<float, 4>& a);
+
+    Packet<float, 4> select(PacketMask<4> mask, const Packet<float, 4>& a, const Packet<float, 4>& b);
+
+    PacketMask<4> ispositive(const Packet<float, 4>& a);
+    PacketMask<4> isnegative(const Packet<float, 4>& a);
+    PacketMask<4> iszero(const Packet<float, 4>& a);
+    PacketMask<4> isfinite(const Packet<float, 4>& a);
+
+    Packet<float, 4> min(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    Packet<float, 4> max(const Packet<float, 4>& a, const Packet<float, 4>& b);
+    Packet<float, 4> abs(const Packet<float, 4>& a);
+    Packet<float, 4> sqrt(const Packet<float, 4>& a);
+    Packet<float, 4> rsqrt(const Packet<float, 4>& a);
+    template <typename Policy> Packet<float, 4> rcp(const Packet<float, 4>& a, Policy p);
+    template <typename Policy> Packet<float, 4> rsqrt(const Packet<float, 4>& a, Policy p);
+
+    float hsum(const Packet<float, 4>& a);
+
+    Packet<float, 4> floor(const Packet<float, 4>& a);
+    Packet<float, 4> ldexp(const Packet<float, 4>& a, const Packet<float, 4>& e);
+    Packet<float, 4> frexp(const Packet<float, 4>& a, Packet<float, 4>* e);
+
+
+    FORCEINLINE
+    PacketMask<4>::PacketMask()
+    {}
+
+    FORCEINLINE
+    PacketMask<4>::PacketMask(uint32_t bits)
+    {
+        __m128i flags = _mm_setr_epi32(1, 2, 4, 8);
+        vec = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int(bits)), flags), flags));
+    }
+
+    FORCEINLINE
+    PacketMask<4>::PacketMask(__m128 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    uint32_t PacketMask<4>::bits() const
+    {
+        return uint32_t(_mm_movemask_ps(vec));
+    }
+
+    FORCEINLINE
+    bool PacketMask<4>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < 4);
+        return (bits() & (1u << i)) != 0;
+    }
+
+    FORCEINLINE
+    PacketMask<4>& PacketMask<4>::operator|=(PacketMask<4> rhs)
+    {
+        vec = _mm_or_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<4>& PacketMask<4>::operator&=(PacketMask<4> rhs)
+    {
+        vec = _mm_and_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<4>& PacketMask<4>::operator^=(PacketMask<4> rhs)
+    {
+        vec = _mm_xor_ps(vec, rhs.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator~(PacketMask<4> a)
+    {
+        return PacketMask<4>(_mm_xor_ps(a.vec, _mm_castsi128_ps(_mm_set1_epi32(-1))));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator&(PacketMask<4> a, PacketMask<4> b)
+    {
+        return a &= b;
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator|(PacketMask<4> a, PacketMask<4> b)
+    {
+        return a |= b;
+    }
+
+
+    FORCEINLINE
+    Packet<float, 4>::Packet()
+        : vec(_mm_setzero_ps())
+    {}
+
+    FORCEINLINE
+    Packet<float, 4>::Packet(float s)
+        : vec(_mm_set1_ps(s))
+    {}
+
+    FORCEINLINE
+    Packet<float, 4>::Packet(__m128 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    Packet<float, 4>::Packet(const float* v)
+        : vec(_mm_loadu_ps(v))
+    {}
+
+    FORCEINLINE
+    float Packet<float, 4>::operator[](int i) const
+    {
+        ASSERT(0 <= i && i < 4);
+        return lane[i];
+    }
+
+    FORCEINLINE
+    float& Packet<float, 4>::operator[](int i)
+    {
+        ASSERT(0 <= i && i < 4);
+        return lane[i];
+    }
+
+    FORCEINLINE
+    Packet<float, 4>& Packet<float, 4>::operator+=(const Packet<float, 4>& a)
+    {
+        vec = _mm_add_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 4>& Packet<float, 4>::operator-=(const Packet<float, 4>& a)
+    {
+        vec = _mm_sub_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 4>& Packet<float, 4>::operator*=(const Packet<float, 4>& a)
+    {
+        vec = _mm_mul_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    Packet<float, 4>& Packet<float, 4>::operator/=(const Packet<float, 4>& a)
+    {
+        vec = _mm_div_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    void store(float* v, const Packet<float, 4>& a)
+    {
+        _mm_storeu_ps(v, a.vec);
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator==(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmpeq_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator!=(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmpneq_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator<(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmplt_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator<=(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmple_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator>(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmpgt_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PacketMask<4> operator>=(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return PacketMask<4>(_mm_cmpge_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator-(const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_sub_ps(_mm_setzero_ps(), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator+(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_add_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator-(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_sub_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator*(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_mul_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator/(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_div_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator+(const Packet<float, 4>& a, float s)
+    {
+        return Packet<float, 4>(_mm_add_ps(a.vec, _mm_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator-(const Packet<float, 4>& a, float s)
+    {
+        return Packet<float, 4>(_mm_sub_ps(a.vec, _mm_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator*(const Packet<float, 4>& a, float s)
+    {
+        return Packet<float, 4>(_mm_mul_ps(a.vec, _mm_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator/(const Packet<float, 4>& a, float s)
+    {
+        return Packet<float, 4>(div(a.vec, s));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator+(float s, const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_add_ps(_mm_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator-(float s, const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_sub_ps(_mm_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator*(float s, const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_mul_ps(_mm_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> operator/(float s, const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_div_ps(_mm_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> select(PacketMask<4> mask, const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_or_ps(_mm_and_ps(mask.vec, a.vec), _mm_andnot_ps(mask.vec, b.vec)));
+    }
+
+    FORCEINLINE
+    PacketMask<4> ispositive(const Packet<float, 4>& a)
+    {
+        return PacketMask<4>(_mm_cmpgt_ps(a.vec, _mm_setzero_ps()));
+    }
+
+    FORCEINLINE
+    PacketMask<4> isnegative(const Packet<float, 4>& a)
+    {
+        return PacketMask<4>(_mm_cmplt_ps(a.vec, _mm_setzero_ps()));
+    }
+
+    FORCEINLINE
+    PacketMask<4> iszero(const Packet<float, 4>& a)
+    {
+        return PacketMask<4>(_mm_cmpeq_ps(a.vec, _mm_setzero_ps()));
+    }
+
+    FORCEINLINE
+    PacketMask<4> isfinite(const Packet<float, 4>& a)
+    {
+        __m128 mag = _mm_andnot_ps(_mm_set1_ps(-0.0f), a.vec);
+        return PacketMask<4>(_mm_cmplt_ps(mag, _mm_set1_ps(ScalarTraits<float>::infinity())));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> min(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_min_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> max(const Packet<float, 4>& a, const Packet<float, 4>& b)
+    {
+        return Packet<float, 4>(_mm_max_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> abs(const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> sqrt(const Packet<float, 4>& a)
+    {
+        return Packet<float, 4>(_mm_sqrt_ps(a.vec));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> rsqrt(const Packet<float, 4>& a)
+    {
+        ASSERT(all(ispositive(a)));
+        return Packet<float, 4>(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.vec)));
+    }
+
+    template <typename Policy>
+    FORCEINLINE
+    Packet<float, 4> rcp(const Packet<float, 4>& a, Policy p)
+    {
+        return Packet<float, 4>(rcp(a.vec, p));
+    }
+
+    template <typename Policy>
+    FORCEINLINE
+    Packet<float, 4> rsqrt(const Packet<float, 4>& a, Policy p)
+    {
+        ASSERT(all(ispositive(a)));
+        return Packet<float, 4>(rsqrt(a.vec, p));
+    }
+
+    FORCEINLINE
+    float hsum(const Packet<float, 4>& a)
+    {
+        __m128 tmp = _mm_add_ps(a.vec, _mm_movehl_ps(a.vec, a.vec));
+        tmp = _mm_add_ss(tmp, _mm_shuffle_ps(tmp, tmp, 1));
+        return _mm_cvtss_f32(tmp);
+    }
+
+    FORCEINLINE
+    Packet<float, 4> floor(const Packet<float, 4>& a)
+    {
+        // Truncates and corrects the lanes that were rounded up. Magnitudes from 2^23 on are
+        // integral already and are passed on, as are NaNs.
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.vec));
+        t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.vec), _mm_set1_ps(1.0f)));
+        __m128 small = _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.vec), _mm_set1_ps(8388608.0f));
+        return Packet<float, 4>(_mm_or_ps(_mm_and_ps(small, t), _mm_andnot_ps(small, a.vec)));
+    }
+
+    namespace detail
+    {
+        // 2^e for integral e in [-126, 127]
+        FORCEINLINE
+        __m128 pow2(__m128i e)
+        {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23));
+        }
+    }
+
+    FORCEINLINE
+    Packet<float, 4> ldexp(const Packet<float, 4>& a, const Packet<float, 4>& e)
+    {
+        // Scales in two steps, so that e may range over [-252, 254] and results may be subnormal.
+        __m128i e0 = _mm_cvtps_epi32(e.vec);
+        __m128i e1 = _mm_srai_epi32(e0, 1);
+        return Packet<float, 4>(_mm_mul_ps(_mm_mul_ps(a.vec, detail::pow2(e1)), detail::pow2(_mm_sub_epi32(e0, e1))));
+    }
+
+    FORCEINLINE
+    Packet<float, 4> frexp(const Packet<float, 4>& a, Packet<float, 4>* e)
+    {
+        // Reads the exponent field, so a must be a normal number.
+        __m128i bits = _mm_and_si128(_mm_castps_si128(a.vec), _mm_set1_epi32(0x7f800000));
+        e->vec = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+        __m128 mantissa = _mm_and_ps(a.vec, _mm_castsi128_ps(_mm_set1_epi32(int(0x807fffff))));
+        return Packet<float, 4>(_mm_or_ps(mantissa, _mm_set1_ps(0.5f)));
+    }
+}
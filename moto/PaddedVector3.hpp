@@ -0,0 +1,384 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PADDEDVECTOR3_HPP
+#define MT_PADDEDVECTOR3_HPP
+
+#include <moto/Vector3.hpp>
+
+// PaddedVector3 is a three-element float vector that occupies 16 bytes, so that its arithmetic
+// can use SSE. The fourth element is ignored, so operations may leave any value in it. Vector3<float>
+// keeps its packed 12-byte layout. The two convert into each other, and convert() and the pointer
+// constructor store to and load from packed 12-byte arrays. Without SSE, PaddedVector3 is Vector3<float>.
+
+#if USE_SSE
+
+#include <moto/SSE.hpp>
+
+namespace mt
+{
+    class PaddedVector3
+    {
+    public:
+        typedef float ScalarType;
+
+        PaddedVector3();
+        PaddedVector3(float x, float y, float z);
+        explicit PaddedVector3(__m128 v);
+
+        PaddedVector3(Zero);
+        template <int I> PaddedVector3(Unit<I>);
+        template <typename Scalar2> explicit PaddedVector3(const Scalar2* v);
+        template <typename Scalar2> explicit PaddedVector3(const Vector3<Scalar2>& a);
+
+        operator const float*() const;
+        operator float*();
+        operator Vector3<float>() const;
+
+        PaddedVector3& operator=(Zero);
+        PaddedVector3& operator+=(Zero);
+        PaddedVector3& operator-=(Zero);
+        PaddedVector3& operator*=(Zero);
+
+        template <int I> PaddedVector3& operator=(Unit<I>);
+
+        template <typename Scalar2> PaddedVector3& operator=(const Scalar2* v);
+        template <typename Scalar2> PaddedVector3& operator=(const Vector3<Scalar2>& a);
+        template <typename Scalar2> PaddedVector3& operator+=(const Vector3<Scalar2>& a);
+        template <typename Scalar2> PaddedVector3& operator-=(const Vector3<Scalar2>& a);
+        template <typename Scalar2> PaddedVector3& operator*=(const Vector3<Scalar2>& a);
+
+        PaddedVector3& operator=(__m128 v);
+
+        PaddedVector3& operator=(const PaddedVector3& a);
+        PaddedVector3& operator+=(const PaddedVector3& a);
+        PaddedVector3& operator-=(const PaddedVector3& a);
+        PaddedVector3& operator*=(const PaddedVector3& a);
+
+        PaddedVector3& operator*=(float s);
+        PaddedVector3& operator/=(float s);
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4201)
+#endif
+
+        union
+        {
+            struct { float x, y, z; };
+            __m128 vec;
+        };
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    };
+
+    PaddedVector3 operator-(const PaddedVector3& a);
+
+    PaddedVector3 operator+(const PaddedVector3& a, const PaddedVector3& b);
+    PaddedVector3 operator-(const PaddedVector3& a, const PaddedVector3& b);
+    PaddedVector3 operator*(const PaddedVector3& a, const PaddedVector3& b);
+
+    PaddedVector3 operator*(const PaddedVector3& a, float s);
+    PaddedVector3 operator*(float s, const PaddedVector3& a);
+    PaddedVector3 operator/(const PaddedVector3& a, float s);
+
+    float dot(const PaddedVector3& a, const PaddedVector3& b);
+    PaddedVector3 cross(const PaddedVector3& a, const PaddedVector3& b);
+    PaddedVector3 normalize(const PaddedVector3& a);
+
+    PaddedVector3 abs(const PaddedVector3& a);
+    PaddedVector3 min(const PaddedVector3& a, const PaddedVector3& b);
+    PaddedVector3 max(const PaddedVector3& a, const PaddedVector3& b);
+
+    void convert(float* v, const PaddedVector3& a);
+
+
+    FORCEINLINE
+    PaddedVector3::PaddedVector3()
+    {}
+
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(float x, float y, float z)
+        : vec(_mm_setr_ps(x, y, z, 0.0f))
+    {}
+
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(__m128 v)
+        : vec(v)
+    {}
+
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(Zero)
+        : vec(_mm_setzero_ps())
+    {}
+
+    template <int I>
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(Unit<I>)
+        : vec(_mm_setr_ps(float(I == 0), float(I == 1), float(I == 2), 0.0f))
+    {}
+
+    // Reads three elements only, so v may point to packed storage.
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(const Scalar2* v)
+        : vec(_mm_setr_ps(float(v[0]), float(v[1]), float(v[2]), 0.0f))
+    {}
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3::PaddedVector3(const Vector3<Scalar2>& a)
+        : vec(_mm_setr_ps(float(a.x), float(a.y), float(a.z), 0.0f))
+    {}
+
+    FORCEINLINE
+    PaddedVector3::operator const float*() const
+    {
+        return &x;
+    }
+
+    FORCEINLINE
+    PaddedVector3::operator float*()
+    {
+        return &x;
+    }
+
+    FORCEINLINE
+    PaddedVector3::operator Vector3<float>() const
+    {
+        return Vector3<float>(x, y, z);
+    }
+
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(Zero)
+    {
+        vec = _mm_setzero_ps();
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator+=(Zero)
+    {
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator-=(Zero)
+    {
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator*=(Zero)
+    {
+        return *this = Zero();
+    }
+
+    template <int I>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(Unit<I>)
+    {
+        vec = _mm_setr_ps(float(I == 0), float(I == 1), float(I == 2), 0.0f);
+        return *this;
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(const Scalar2* v)
+    {
+        vec = _mm_setr_ps(float(v[0]), float(v[1]), float(v[2]), 0.0f);
+        return *this;
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(const Vector3<Scalar2>& a)
+    {
+        vec = _mm_setr_ps(float(a.x), float(a.y), float(a.z), 0.0f);
+        return *this;
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator+=(const Vector3<Scalar2>& a)
+    {
+        return *this += PaddedVector3(a);
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator-=(const Vector3<Scalar2>& a)
+    {
+        return *this -= PaddedVector3(a);
+    }
+
+    template <typename Scalar2>
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator*=(const Vector3<Scalar2>& a)
+    {
+        return *this *= PaddedVector3(a);
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(__m128 v)
+    {
+        vec = v;
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator=(const PaddedVector3& a)
+    {
+        vec = a.vec;
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator+=(const PaddedVector3& a)
+    {
+        vec = _mm_add_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator-=(const PaddedVector3& a)
+    {
+        vec = _mm_sub_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator*=(const PaddedVector3& a)
+    {
+        vec = _mm_mul_ps(vec, a.vec);
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator*=(float s)
+    {
+        vec = _mm_mul_ps(vec, _mm_set1_ps(s));
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3& PaddedVector3::operator/=(float s)
+    {
+        vec = div(vec, s);
+        return *this;
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator-(const PaddedVector3& a)
+    {
+        return PaddedVector3(_mm_sub_ps(_mm_setzero_ps(), a.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator+(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(_mm_add_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator-(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(_mm_sub_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator*(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(_mm_mul_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator*(const PaddedVector3& a, float s)
+    {
+        return PaddedVector3(_mm_mul_ps(a.vec, _mm_set1_ps(s)));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator*(float s, const PaddedVector3& a)
+    {
+        return PaddedVector3(_mm_mul_ps(_mm_set1_ps(s), a.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 operator/(const PaddedVector3& a, float s)
+    {
+        return PaddedVector3(div(a.vec, s));
+    }
+
+    FORCEINLINE
+    float dot(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        __m128 tmp = _mm_mul_ps(a.vec, b.vec);
+        tmp = _mm_add_ss(_mm_add_ss(tmp, _mm_shuffle_ps(tmp, tmp, 1)), _mm_movehl_ps(tmp, tmp));
+        return _mm_cvtss_f32(tmp);
+    }
+
+    FORCEINLINE
+    PaddedVector3 cross(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(cross3(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 normalize(const PaddedVector3& a)
+    {
+        return PaddedVector3(normalize3(a.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 abs(const PaddedVector3& a)
+    {
+        return PaddedVector3(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 min(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(_mm_min_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    PaddedVector3 max(const PaddedVector3& a, const PaddedVector3& b)
+    {
+        return PaddedVector3(_mm_max_ps(a.vec, b.vec));
+    }
+
+    FORCEINLINE
+    void convert(float* v, const PaddedVector3& a)
+    {
+        v[0] = a.x;
+        v[1] = a.y;
+        v[2] = a.z;
+    }
+}
+
+namespace guts
+{
+    // Arrays of padded vectors are laid out as four-element records.
+    template <> struct TypeTraits<mt::PaddedVector3> { enum { ID = TT_FLOAT4 }; };
+}
+
+#else
+
+namespace mt
+{
+    typedef Vector3<float> PaddedVector3;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,332 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PHILOX_HPP
+#define MT_PHILOX_HPP
+
+#include <moto/PacketMath.hpp>
+#include <moto/ScalarTraits.hpp>
+
+#if USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace mt
+{
+    // Philox4x32-10, the counter-based generator from "Parallel Random Numbers: As Easy as 1, 2, 3",
+    // John K. Salmon et al., SC 2011. Each output block of four 32-bit words is a keyed bijection of a
+    // 128-bit counter, so there is no state to carry from one number to the next. The counter holds the
+    // block index in the low 64 bits and a stream number in the high 64 bits, and the key is the seed.
+    // Generators with the same seed and different streams are independent, so give each thread its own
+    // stream, and a stream can be read from any position with setCounter.
+    //
+    // Numbers are generated sixteen at a time, from four consecutive counters evaluated in the lanes of
+    // SSE registers. bits[4 * w + b] is word w of block counter() + b. The fill routines consume the
+    // sixteen numbers in order, and discard the numbers left over at the end of the array, so that
+    // each call starts on a fresh group and the result does not depend on the packet width.
+    //
+    // The routines for vectors take structure-of-arrays input, one float array per coordinate.
+
+    void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+    class Philox
+    {
+    public:
+        Philox(uint64_t seed = 12345UL, uint64_t stream = 0);
+
+        uint64_t seed() const;
+        uint64_t stream() const;
+        void setSeed(uint64_t seed, uint64_t stream = 0);
+
+        uint64_t counter() const;
+        void setCounter(uint64_t counter);
+
+        void next(uint32_t bits[16]);
+
+        void uniform(float* x, size_t n);
+        void uniform(float* x, size_t n, float a, float b);
+        void angle(float* x, size_t n);
+        void uniformVector3(float* const v[3], size_t n);
+        void uniformVector3(float* const v[3], size_t n, float a, float b);
+        void direction(float* const v[3], size_t n);
+        void rotation(float* const q[4], size_t n);
+
+    private:
+        void uniform16(float x[16], float a, float b);
+
+        uint32_t mKey[2];
+        uint64_t mStream;
+        uint64_t mCounter;
+    };
+
+
+    namespace detail
+    {
+        FORCEINLINE
+        uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t& hi)
+        {
+            uint64_t product = uint64_t(a) * uint64_t(b);
+            hi = uint32_t(product >> 32);
+            return uint32_t(product);
+        }
+    }
+
+    inline
+    void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+    {
+        uint32_t c0 = counter[0];
+        uint32_t c1 = counter[1];
+        uint32_t c2 = counter[2];
+        uint32_t c3 = counter[3];
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+        for (int round = 0; round != 10; ++round)
+        {
+            if (round != 0)
+            {
+                k0 += 0x9E3779B9UL;
+                k1 += 0xBB67AE85UL;
+            }
+            uint32_t hi0;
+            uint32_t hi1;
+            uint32_t lo0 = detail::mulhilo(0xD2511F53UL, c0, hi0);
+            uint32_t lo1 = detail::mulhilo(0xCD9E8D57UL, c2, hi1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+        }
+        result[0] = c0;
+        result[1] = c1;
+        result[2] = c2;
+        result[3] = c3;
+    }
+
+    inline
+    Philox::Philox(uint64_t seed, uint64_t stream)
+    {
+        setSeed(seed, stream);
+    }
+
+    inline
+    uint64_t Philox::seed() const
+    {
+        return uint64_t(mKey[0]) | (uint64_t(mKey[1]) << 32);
+    }
+
+    inline
+    uint64_t Philox::stream() const
+    {
+        return mStream;
+    }
+
+    inline
+    void Philox::setSeed(uint64_t seed, uint64_t stream)
+    {
+        mKey[0] = uint32_t(seed);
+        mKey[1] = uint32_t(seed >> 32);
+        mStream = stream;
+        mCounter = 0;
+    }
+
+    inline
+    uint64_t Philox::counter() const
+    {
+        return mCounter;
+    }
+
+    inline
+    void Philox::setCounter(uint64_t counter)
+    {
+        mCounter = counter;
+    }
+
+#if USE_SSE
+
+    namespace detail
+    {
+        // Multiplies the four lanes of a by m, and returns the low halves of the products in lo and the
+        // high halves in hi. SSE2 multiplies the even lanes only, so the odd lanes are shifted down.
+        FORCEINLINE
+        void mulhilo(__m128i a, uint32_t m, __m128i& lo, __m128i& hi)
+        {
+            __m128i b = _mm_set1_epi32(int(m));
+            __m128i even = _mm_mul_epu32(a, b);
+            __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+            lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+        }
+    }
+
+    inline
+    void Philox::next(uint32_t bits[16])
+    {
+        __m128i c0 = _mm_setr_epi32(int(uint32_t(mCounter)), int(uint32_t(mCounter + 1)), int(uint32_t(mCounter + 2)), int(uint32_t(mCounter + 3)));
+        __m128i c1 = _mm_setr_epi32(int(uint32_t(mCounter >> 32)), int(uint32_t((mCounter + 1) >> 32)), int(uint32_t((mCounter + 2) >> 32)), int(uint32_t((mCounter + 3) >> 32)));
+        __m128i c2 = _mm_set1_epi32(int(uint32_t(mStream)));
+        __m128i c3 = _mm_set1_epi32(int(uint32_t(mStream >> 32)));
+        __m128i k0 = _mm_set1_epi32(int(mKey[0]));
+        __m128i k1 = _mm_set1_epi32(int(mKey[1]));
+        for (int round = 0; round != 10; ++round)
+        {
+            if (round != 0)
+            {
+                k0 = _mm_add_epi32(k0, _mm_set1_epi32(int(0x9E3779B9UL)));
+                k1 = _mm_add_epi32(k1, _mm_set1_epi32(int(0xBB67AE85UL)));
+            }
+            __m128i lo0, hi0, lo1, hi1;
+            detail::mulhilo(c0, 0xD2511F53UL, lo0, hi0);
+            detail::mulhilo(c2, 0xCD9E8D57UL, lo1, hi1);
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), k0);
+            c1 = lo1;
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), k1);
+            c3 = lo0;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits), c0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits + 4), c1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits + 8), c2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits + 12), c3);
+        mCounter += 4;
+    }
+
+    inline
+    void Philox::uniform16(float x[16], float a, float b)
+    {
+        // The upper 24 bits of a word, times 2^-24, are exact floats in [0, 1).
+        uint32_t bits[16];
+        next(bits);
+        __m128 scale = _mm_set1_ps((b - a) * (1.0f / 16777216.0f));
+        __m128 offset = _mm_set1_ps(a);
+        for (int i = 0; i != 16; i += 4)
+        {
+            __m128i v = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i)), 8);
+            _mm_storeu_ps(x + i, _mm_add_ps(offset, _mm_mul_ps(_mm_cvtepi32_ps(v), scale)));
+        }
+    }
+
+#else
+
+    inline
+    void Philox::next(uint32_t bits[16])
+    {
+        for (int b = 0; b != 4; ++b)
+        {
+            uint64_t index = mCounter + b;
+            uint32_t counter[4] = { uint32_t(index), uint32_t(index >> 32), uint32_t(mStream), uint32_t(mStream >> 32) };
+            uint32_t result[4];
+            philox4x32(counter, mKey, result);
+            for (int w = 0; w != 4; ++w)
+            {
+                bits[4 * w + b] = result[w];
+            }
+        }
+        mCounter += 4;
+    }
+
+    inline
+    void Philox::uniform16(float x[16], float a, float b)
+    {
+        uint32_t bits[16];
+        next(bits);
+        float scale = (b - a) * (1.0f / 16777216.0f);
+        for (int i = 0; i != 16; ++i)
+        {
+            x[i] = a + float(int32_t(bits[i] >> 8)) * scale;
+        }
+    }
+
+#endif
+
+    inline
+    void Philox::uniform(float* x, size_t n)
+    {
+        uniform(x, n, 0.0f, 1.0f);
+    }
+
+    inline
+    void Philox::uniform(float* x, size_t n, float a, float b)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uniform16(x + i, a, b);
+        }
+        if (i != n)
+        {
+            float tail[16];
+            uniform16(tail, a, b);
+            for (size_t k = 0; i + k < n; ++k)
+            {
+                x[i + k] = tail[k];
+            }
+        }
+    }
+
+    inline
+    void Philox::angle(float* x, size_t n)
+    {
+        uniform(x, n, -ScalarTraits<float>::pi(), ScalarTraits<float>::pi());
+    }
+
+    inline
+    void Philox::uniformVector3(float* const v[3], size_t n)
+    {
+        uniformVector3(v, n, 0.0f, 1.0f);
+    }
+
+    inline
+    void Philox::uniformVector3(float* const v[3], size_t n, float a, float b)
+    {
+        uniform(v[0], n, a, b);
+        uniform(v[1], n, a, b);
+        uniform(v[2], n, a, b);
+    }
+
+    inline
+    void Philox::direction(float* const v[3], size_t n)
+    {
+        // As Random::direction, with the angle drawn into the x array and the sines and cosines taken
+        // a packet at a time.
+        angle(v[0], n);
+        uniform(v[2], n, -1.0f, 1.0f);
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            FloatPacket z = detail::loadLanes(v[2], i, n);
+            FloatPacket r = sqrt(max(FloatPacket(1.0f) - z * z, FloatPacket(0.0f)));
+            FloatPacket s, c;
+            sincos(detail::loadLanes(v[0], i, n), s, c);
+            detail::storeLanes(v[0], i, n, r * c);
+            detail::storeLanes(v[1], i, n, r * s);
+        }
+    }
+
+    inline
+    void Philox::rotation(float* const q[4], size_t n)
+    {
+        // From: "Uniform Random Rotations", Ken Shoemake, Graphics Gems III,
+        //       pg. 124-132
+        uniform(q[0], n);
+        angle(q[1], n);
+        angle(q[2], n);
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            FloatPacket x0 = detail::loadLanes(q[0], i, n);
+            FloatPacket r1 = sqrt(FloatPacket(1.0f) - x0);
+            FloatPacket r2 = sqrt(x0);
+            FloatPacket s1, c1, s2, c2;
+            sincos(detail::loadLanes(q[1], i, n), s1, c1);
+            sincos(detail::loadLanes(q[2], i, n), s2, c2);
+            detail::storeLanes(q[0], i, n, r1 * s1);
+            detail::storeLanes(q[1], i, n, r1 * c1);
+            detail::storeLanes(q[2], i, n, r2 * s2);
+            detail::storeLanes(q[3], i, n, r2 * c2);
+        }
+    }
+}
+
+#endif
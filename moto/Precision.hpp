@@ -0,0 +1,115 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_PRECISION_HPP
+#define MT_PRECISION_HPP
+
+#include <moto/Scalar.hpp>
+
+#if USE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace mt
+{
+    // Precision policies for reciprocals and reciprocal square roots, passed as the last argument of
+    // rcp, rsqrt, div, normalize, nlerp and inverse, so that each call site picks its own precision:
+    //
+    //   Exact         IEEE division and square root
+    //   Fast          hardware estimate (rcpps, rsqrtps), relative error below 1.5 * 2^-12
+    //   FastRefined   estimate plus one Newton-Raphson step, relative error below 2^-20
+    //
+    // The estimates exist for float under SSE only. Other scalar types are exact under every policy.
+    // The overloads without a policy argument keep using the compile-time defaults (USE_APPROX et al.).
+
+    struct Exact {};
+    struct Fast {};
+    struct FastRefined {};
+
+    template <typename Scalar, typename Policy> Scalar rcp(Scalar a, Policy);
+    template <typename Scalar, typename Policy> Scalar rsqrt(Scalar a, Policy);
+
+    float rcp(float a, Fast);
+    float rcp(float a, FastRefined);
+    float rsqrt(float a, Fast);
+    float rsqrt(float a, FastRefined);
+
+    template <typename Element, typename Scalar, typename Policy> Element div(const Element& e, Scalar s, Policy p);
+    template <typename Element, typename Scalar> Element div(const Element& e, Scalar s, Exact);
+
+
+
+    template <typename Scalar, typename Policy>
+    FORCEINLINE
+    Scalar rcp(Scalar a, Policy)
+    {
+        ASSERT(!iszero(a));
+        return Scalar(1) / a;
+    }
+
+    template <typename Scalar, typename Policy>
+    FORCEINLINE
+    Scalar rsqrt(Scalar a, Policy)
+    {
+        ASSERT(ispositive(a));
+        return Scalar(1) / sqrt(a);
+    }
+
+    FORCEINLINE
+    float rcp(float a, Fast)
+    {
+        ASSERT(!iszero(a));
+#if USE_SSE
+        return _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(a)));
+#else
+        return 1.0f / a;
+#endif
+    }
+
+    FORCEINLINE
+    float rcp(float a, FastRefined)
+    {
+        float r = rcp(a, Fast());
+        return r * (2.0f - a * r);
+    }
+
+    FORCEINLINE
+    float rsqrt(float a, Fast)
+    {
+        ASSERT(ispositive(a));
+#if USE_SSE
+        return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(a)));
+#else
+        return 1.0f / sqrt(a);
+#endif
+    }
+
+    FORCEINLINE
+    float rsqrt(float a, FastRefined)
+    {
+        float r = rsqrt(a, Fast());
+        return r * (1.5f - 0.5f * a * r * r);
+    }
+
+    template <typename Element, typename Scalar, typename Policy>
+    FORCEINLINE
+    Element div(const Element& e, Scalar s, Policy p)
+    {
+        return e * rcp(s, p);
+    }
+
+    template <typename Element, typename Scalar>
+    FORCEINLINE
+    Element div(const Element& e, Scalar s, Exact)
+    {
+        ASSERT(!iszero(s));
+        return e / s;
+    }
+}
+
+#endif
@@ -0,0 +1,719 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_REVERSE_HPP
+#define MT_REVERSE_HPP
+
+#ifdef USE_OSTREAM
+#include <ostream>
+#endif
+
+#include <moto/Promote.hpp>
+#include <moto/Scalar.hpp>
+#include <moto/ScalarTraits.hpp>
+#include <guts/Arena.hpp>
+
+namespace mt
+{
+    // Reverse-mode automatic differentiation. Arithmetic on Reverse numbers records each operation with
+    // its local partial derivatives on a Tape, and Tape::gradient accumulates the adjoints of all inputs
+    // in one backward sweep. A gradient therefore costs a small multiple of one evaluation regardless of
+    // the number of inputs, where forward-mode Dual numbers need one evaluation per input.
+    //
+    //   Tape<float> tape;
+    //   Reverse<float> x = tape.variable(1.0f);
+    //   Reverse<float> y = tape.variable(2.0f);
+    //   Reverse<float> f = sin(x * y);
+    //   tape.gradient(f);   // adjoint(x) == df/dx, adjoint(y) == df/dy
+    //   tape.clear();       // the next evaluation reuses the tape's memory
+    //
+    // Numbers without a tape are constants. A Reverse number refers to its tape, and must not be used after
+    // the tape is cleared.
+
+    template <typename Scalar> class Tape;
+
+    template <typename Scalar>
+    struct TapeNode
+    {
+        TapeNode<Scalar>* prev;
+        TapeNode<Scalar>* parent[2];
+        Scalar partial[2];
+        Scalar adjoint;
+    };
+
+    template <typename Scalar>
+    class Reverse
+    {
+    public:
+        typedef Scalar ScalarType;
+
+        Reverse(Scalar value = Scalar());
+        Reverse(Scalar value, Tape<Scalar>* tape, TapeNode<Scalar>* node);
+
+        Scalar value() const;
+        Scalar adjoint() const;
+
+        Tape<Scalar>* tape() const;
+        TapeNode<Scalar>* node() const;
+
+        Reverse<Scalar>& operator=(Scalar rhs);
+        Reverse<Scalar>& operator+=(Scalar rhs);
+        Reverse<Scalar>& operator-=(Scalar rhs);
+        Reverse<Scalar>& operator*=(Scalar rhs);
+        Reverse<Scalar>& operator/=(Scalar rhs);
+
+        Reverse<Scalar>& operator+=(const Reverse<Scalar>& rhs);
+        Reverse<Scalar>& operator-=(const Reverse<Scalar>& rhs);
+        Reverse<Scalar>& operator*=(const Reverse<Scalar>& rhs);
+        Reverse<Scalar>& operator/=(const Reverse<Scalar>& rhs);
+
+    private:
+        Scalar mValue;
+        Tape<Scalar>* mTape;
+        TapeNode<Scalar>* mNode;
+    };
+
+    template <typename Scalar>
+    class Tape
+    {
+    public:
+        explicit Tape(size_t blockSize = 64 * 1024);
+
+        // A new input
+        Reverse<Scalar> variable(Scalar x);
+
+        // Records a result with local partial derivatives da and db with respect to a and b. Either parent may be null.
+        TapeNode<Scalar>* push(TapeNode<Scalar>* a, Scalar da, TapeNode<Scalar>* b = NULLPTR, Scalar db = Scalar());
+
+        // Sets the adjoint of every recorded number to its partial derivative of y. May be called for several outputs in turn.
+        void gradient(const Reverse<Scalar>& y);
+
+        // Forgets all recorded operations but keeps the memory.
+        void clear();
+
+        size_t size() const;
+        size_t capacity() const;
+
+    private:
+        Tape(const Tape<Scalar>&);
+        Tape<Scalar>& operator=(const Tape<Scalar>&);
+
+        guts::Arena mArena;
+        TapeNode<Scalar>* mLast;
+        size_t mSize;
+    };
+
+#ifdef USE_OSTREAM
+
+    template <typename CharT, typename Traits, typename Scalar>
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const Reverse<Scalar>& rhs);
+
+#endif
+
+    template <typename Scalar> bool operator==(const Reverse<Scalar>& a, Scalar b);
+    template <typename Scalar> bool operator==(Scalar a, const Reverse<Scalar>& b);
+    template <typename Scalar> bool operator==(const Reverse<Scalar>& a, const Reverse<Scalar>& b);
+
+    template <typename Scalar> bool operator<(const Reverse<Scalar>& a, Scalar b);
+    template <typename Scalar> bool operator<(Scalar a, const Reverse<Scalar>& b);
+    template <typename Scalar> bool operator<(const Reverse<Scalar>& a, const Reverse<Scalar>& b);
+
+    template <typename Scalar> Reverse<Scalar> operator-(const Reverse<Scalar>& rhs);
+
+    template <typename Scalar> Reverse<Scalar> operator+(const Reverse<Scalar>& lhs, Scalar rhs);
+    template <typename Scalar> Reverse<Scalar> operator-(const Reverse<Scalar>& lhs, Scalar rhs);
+    template <typename Scalar> Reverse<Scalar> operator*(const Reverse<Scalar>& lhs, Scalar rhs);
+    template <typename Scalar> Reverse<Scalar> operator/(const Reverse<Scalar>& lhs, Scalar rhs);
+
+    template <typename Scalar> Reverse<Scalar> operator+(Scalar lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator-(Scalar lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator*(Scalar lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator/(Scalar lhs, const Reverse<Scalar>& rhs);
+
+    template <typename Scalar> Reverse<Scalar> operator+(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator-(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator*(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs);
+    template <typename Scalar> Reverse<Scalar> operator/(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs);
+
+    template <typename Scalar> Scalar value(const Reverse<Scalar>& z);
+    template <typename Scalar> Scalar adjoint(const Reverse<Scalar>& z);
+
+    template <typename Scalar> Reverse<Scalar> acos(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> asin(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> atan(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> atan2(const Reverse<Scalar>& y, const Reverse<Scalar>& x);
+    template <typename Scalar> Reverse<Scalar> cos(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> cosh(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> exp(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> log(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> log10(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> pow(const Reverse<Scalar>& x, const Reverse<Scalar>& y);
+    template <typename Scalar> Reverse<Scalar> sin(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> sinh(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> sqrt(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> tan(const Reverse<Scalar>& z);
+    template <typename Scalar> Reverse<Scalar> tanh(const Reverse<Scalar>& z);
+
+    template <typename Scalar> bool isfinite(const Reverse<Scalar>& z);
+
+
+    // Member functions
+
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>::Reverse(Scalar value)
+        : mValue(value)
+        , mTape(NULLPTR)
+        , mNode(NULLPTR)
+    {}
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>::Reverse(Scalar value, Tape<Scalar>* tape, TapeNode<Scalar>* node)
+        : mValue(value)
+        , mTape(tape)
+        , mNode(node)
+    {}
+
+    template <typename Scalar>
+    FORCEINLINE
+    Scalar Reverse<Scalar>::value() const
+    {
+        return mValue;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Scalar Reverse<Scalar>::adjoint() const
+    {
+        return mNode != NULLPTR ? mNode->adjoint : Scalar();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Tape<Scalar>* Reverse<Scalar>::tape() const
+    {
+        return mTape;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    TapeNode<Scalar>* Reverse<Scalar>::node() const
+    {
+        return mNode;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator=(Scalar rhs)
+    {
+        return *this = Reverse<Scalar>(rhs);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator+=(Scalar rhs)
+    {
+        return *this = *this + rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator-=(Scalar rhs)
+    {
+        return *this = *this - rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator*=(Scalar rhs)
+    {
+        return *this = *this * rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator/=(Scalar rhs)
+    {
+        return *this = *this / rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator+=(const Reverse<Scalar>& rhs)
+    {
+        return *this = *this + rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator-=(const Reverse<Scalar>& rhs)
+    {
+        return *this = *this - rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator*=(const Reverse<Scalar>& rhs)
+    {
+        return *this = *this * rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar>& Reverse<Scalar>::operator/=(const Reverse<Scalar>& rhs)
+    {
+        return *this = *this / rhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Tape<Scalar>::Tape(size_t blockSize)
+        : mArena(blockSize)
+        , mLast(NULLPTR)
+        , mSize(0)
+    {}
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> Tape<Scalar>::variable(Scalar x)
+    {
+        return Reverse<Scalar>(x, this, push(NULLPTR, Scalar()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    TapeNode<Scalar>* Tape<Scalar>::push(TapeNode<Scalar>* a, Scalar da, TapeNode<Scalar>* b, Scalar db)
+    {
+        TapeNode<Scalar>* node = mArena.template allocate<TapeNode<Scalar> >();
+        node->prev = mLast;
+        node->parent[0] = a;
+        node->parent[1] = b;
+        node->partial[0] = da;
+        node->partial[1] = db;
+        node->adjoint = Scalar();
+        mLast = node;
+        ++mSize;
+        return node;
+    }
+
+    template <typename Scalar>
+    void Tape<Scalar>::gradient(const Reverse<Scalar>& y)
+    {
+        ASSERT(y.tape() == NULLPTR || y.tape() == this);
+        for (TapeNode<Scalar>* node = mLast; node != NULLPTR; node = node->prev)
+        {
+            node->adjoint = Scalar();
+        }
+        if (y.node() == NULLPTR)
+        {
+            return;
+        }
+
+        // Nodes are recorded after their parents, so walking back from y visits each node after all its uses.
+        y.node()->adjoint = Scalar(1);
+        for (TapeNode<Scalar>* node = y.node(); node != NULLPTR; node = node->prev)
+        {
+            Scalar adjoint = node->adjoint;
+            if (adjoint != Scalar())
+            {
+                if (node->parent[0] != NULLPTR)
+                {
+                    node->parent[0]->adjoint += node->partial[0] * adjoint;
+                }
+                if (node->parent[1] != NULLPTR)
+                {
+                    node->parent[1]->adjoint += node->partial[1] * adjoint;
+                }
+            }
+        }
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    void Tape<Scalar>::clear()
+    {
+        mArena.clear();
+        mLast = NULLPTR;
+        mSize = 0;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    size_t Tape<Scalar>::size() const
+    {
+        return mSize;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    size_t Tape<Scalar>::capacity() const
+    {
+        return mArena.capacity();
+    }
+
+
+    // Non-member functions
+
+
+    namespace detail
+    {
+        // The result of a unary operation on z with local derivative dz.
+        template <typename Scalar>
+        FORCEINLINE
+        Reverse<Scalar> unary(const Reverse<Scalar>& z, Scalar value, Scalar dz)
+        {
+            if (z.tape() == NULLPTR)
+            {
+                return Reverse<Scalar>(value);
+            }
+            return Reverse<Scalar>(value, z.tape(), z.tape()->push(z.node(), dz));
+        }
+
+        // The result of a binary operation on a and b with local derivatives da and db.
+        template <typename Scalar>
+        FORCEINLINE
+        Reverse<Scalar> binary(const Reverse<Scalar>& a, const Reverse<Scalar>& b, Scalar value, Scalar da, Scalar db)
+        {
+            ASSERT(a.tape() == NULLPTR || b.tape() == NULLPTR || a.tape() == b.tape());
+            Tape<Scalar>* tape = a.tape() != NULLPTR ? a.tape() : b.tape();
+            if (tape == NULLPTR)
+            {
+                return Reverse<Scalar>(value);
+            }
+            return Reverse<Scalar>(value, tape, tape->push(a.node(), da, b.node(), db));
+        }
+    }
+
+#ifdef USE_OSTREAM
+
+    template <typename CharT, typename Traits, typename Scalar>
+    FORCEINLINE
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const Reverse<Scalar>& rhs)
+    {
+        return os << rhs.value();
+    }
+
+#endif
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator==(const Reverse<Scalar>& a, Scalar b)
+    {
+        return a.value() == b;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator==(Scalar a, const Reverse<Scalar>& b)
+    {
+        return a == b.value();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator==(const Reverse<Scalar>& a, const Reverse<Scalar>& b)
+    {
+        return a.value() == b.value();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator<(const Reverse<Scalar>& a, Scalar b)
+    {
+        return a.value() < b;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator<(Scalar a, const Reverse<Scalar>& b)
+    {
+        return a < b.value();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    bool operator<(const Reverse<Scalar>& a, const Reverse<Scalar>& b)
+    {
+        return a.value() < b.value();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator-(const Reverse<Scalar>& rhs)
+    {
+        return detail::unary(rhs, -rhs.value(), Scalar(-1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator+(const Reverse<Scalar>& lhs, Scalar rhs)
+    {
+        return detail::unary(lhs, lhs.value() + rhs, Scalar(1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator-(const Reverse<Scalar>& lhs, Scalar rhs)
+    {
+        return detail::unary(lhs, lhs.value() - rhs, Scalar(1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator*(const Reverse<Scalar>& lhs, Scalar rhs)
+    {
+        return detail::unary(lhs, lhs.value() * rhs, rhs);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator/(const Reverse<Scalar>& lhs, Scalar rhs)
+    {
+        Scalar r = Scalar(1) / rhs;
+        return detail::unary(lhs, lhs.value() * r, r);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator+(Scalar lhs, const Reverse<Scalar>& rhs)
+    {
+        return rhs + lhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator-(Scalar lhs, const Reverse<Scalar>& rhs)
+    {
+        return detail::unary(rhs, lhs - rhs.value(), Scalar(-1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator*(Scalar lhs, const Reverse<Scalar>& rhs)
+    {
+        return rhs * lhs;
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator/(Scalar lhs, const Reverse<Scalar>& rhs)
+    {
+        Scalar r = Scalar(1) / rhs.value();
+        Scalar x = lhs * r;
+        return detail::unary(rhs, x, -x * r);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator+(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs)
+    {
+        return detail::binary(lhs, rhs, lhs.value() + rhs.value(), Scalar(1), Scalar(1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator-(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs)
+    {
+        return detail::binary(lhs, rhs, lhs.value() - rhs.value(), Scalar(1), Scalar(-1));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator*(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs)
+    {
+        return detail::binary(lhs, rhs, lhs.value() * rhs.value(), rhs.value(), lhs.value());
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> operator/(const Reverse<Scalar>& lhs, const Reverse<Scalar>& rhs)
+    {
+        Scalar r = Scalar(1) / rhs.value();
+        Scalar x = lhs.value() * r;
+        return detail::binary(lhs, rhs, x, r, -x * r);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Scalar value(const Reverse<Scalar>& z)
+    {
+        return z.value();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Scalar adjoint(const Reverse<Scalar>& z)
+    {
+        return z.adjoint();
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> acos(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, acos(z.value()), Scalar(-1) / sqrt(Scalar(1) - z.value() * z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> asin(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, asin(z.value()), Scalar(1) / sqrt(Scalar(1) - z.value() * z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> atan(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, atan(z.value()), Scalar(1) / (Scalar(1) + z.value() * z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> atan2(const Reverse<Scalar>& y, const Reverse<Scalar>& x)
+    {
+        Scalar r = Scalar(1) / (x.value() * x.value() + y.value() * y.value());
+        return detail::binary(y, x, atan2(y.value(), x.value()), x.value() * r, -y.value() * r);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> cos(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, cos(z.value()), -sin(z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> cosh(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, cosh(z.value()), sinh(z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> exp(const Reverse<Scalar>& z)
+    {
+        Scalar x = exp(z.value());
+        return detail::unary(z, x, x);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> log(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, log(z.value()), Scalar(1) / z.value());
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> log10(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, log10(z.value()), Scalar(1) / (z.value() * log(Scalar(10))));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> pow(const Reverse<Scalar>& x, const Reverse<Scalar>& y)
+    {
+        Scalar p = pow(x.value(), y.value());
+        return detail::binary(x, y, p, y.value() * pow(x.value(), y.value() - Scalar(1)), p * log(x.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> sin(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, sin(z.value()), cos(z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> sinh(const Reverse<Scalar>& z)
+    {
+        return detail::unary(z, sinh(z.value()), cosh(z.value()));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> sqrt(const Reverse<Scalar>& z)
+    {
+        Scalar x = sqrt(z.value());
+        return detail::unary(z, x, Scalar(0.5) / x);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> tan(const Reverse<Scalar>& z)
+    {
+        Scalar x = tan(z.value());
+        return detail::unary(z, x, Scalar(1) + x * x);
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Reverse<Scalar> tanh(const Reverse<Scalar>& z)
+    {
+        Scalar x = tanh(z.value());
+        return detail::unary(z, x, Scalar(1) - x * x);
+    }
+
+
+#ifndef HAVE_TYPEOF
+
+    template <typename Scalar1, typename Scalar2>
+    struct Promote<Scalar1, Reverse<Scalar2> >
+    {
+        typedef Reverse<typename Promote<Scalar1, Scalar2>::RT> RT;
+    };
+
+    template <typename Scalar1, typename Scalar2>
+    struct Promote<Reverse<Scalar1>, Reverse<Scalar2> >
+    {
+        typedef Reverse<typename Promote<Scalar1, Scalar2>::RT> RT;
+    };
+
+#endif
+
+    template <typename Scalar>
+    struct ScalarTraits<Reverse<Scalar> >
+    {
+
+        // These are all constants and thus are not recorded.
+
+        static Reverse<Scalar> pi()
+        {
+            return Reverse<Scalar>(ScalarTraits<Scalar>::pi());
+        }
+
+        static Reverse<Scalar> infinity()
+        {
+            return Reverse<Scalar>(ScalarTraits<Scalar>::infinity());
+        }
+
+        static Reverse<Scalar> epsilon()
+        {
+            return Reverse<Scalar>(ScalarTraits<Scalar>::epsilon());
+        }
+
+        static Reverse<Scalar> max()
+        {
+            return Reverse<Scalar>(ScalarTraits<Scalar>::max());
+        }
+    };
+
+    template <typename Scalar>
+    bool isfinite(const Reverse<Scalar>& z)
+    {
+        return isfinite(z.value());
+    }
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_SSE_HPP
+#define MT_SSE_HPP
+
+#include <consolid/consolid.h>
+#include <moto/Precision.hpp>
+
+#include <xmmintrin.h>
+
+// Helpers on raw __m128 registers shared by the SSE specializations
+
+#define USE_FDIV 1
+#define USE_APPROX 0
+
+
+#define MT_SPLAT(a, i) _mm_shuffle_ps((a), (a), _MM_SHUFFLE((i), (i), (i), (i)))
+
+namespace mt
+{ 
+    FORCEINLINE
+    __m128 div(__m128 a, __m128 b)
+    {
+#if USE_APPROX
+        return _mm_mul_ps(a, _mm_rcp_ps(b));
+#else
+        return _mm_div_ps(a, b);
+#endif 
+    }
+    
+    FORCEINLINE
+    __m128 div(__m128 a, float s)
+    {
+        ASSERT(s != 0.0f);
+        
+#if USE_FDIV
+        return _mm_mul_ps(a, _mm_set1_ps(1.0f / s));
+#else
+        return div(a, _mm_set1_ps(1));
+#endif
+    }
+
+    // Per-call-site precision, see Precision.hpp
+
+    FORCEINLINE
+    __m128 rcp(__m128 a, Exact)
+    {
+        return _mm_div_ps(_mm_set1_ps(1.0f), a);
+    }
+
+    FORCEINLINE
+    __m128 rcp(__m128 a, Fast)
+    {
+        return _mm_rcp_ps(a);
+    }
+
+    FORCEINLINE
+    __m128 rcp(__m128 a, FastRefined)
+    {
+        // r (2 - a r)
+        __m128 r = _mm_rcp_ps(a);
+        return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(a, r)));
+    }
+
+    FORCEINLINE
+    __m128 rsqrt(__m128 a, Exact)
+    {
+        return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a));
+    }
+
+    FORCEINLINE
+    __m128 rsqrt(__m128 a, Fast)
+    {
+        return _mm_rsqrt_ps(a);
+    }
+
+    FORCEINLINE
+    __m128 rsqrt(__m128 a, FastRefined)
+    {
+        // r (1.5 - 0.5 a r^2)
+        __m128 r = _mm_rsqrt_ps(a);
+        __m128 h = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), a), _mm_mul_ps(r, r));
+        return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), h));
+    }
+
+#if WASTE_CYCLES
+
+    // This one taken straight from xmmintrin.h is more expensive than the one below. No BS.
+
+    FORCEINLINE
+    void transpose(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+#else
+
+    FORCEINLINE
+    void transpose(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
+    { 
+        __m128 lo01 = _mm_unpacklo_ps(r0, r1); 
+        __m128 lo23 = _mm_unpacklo_ps(r2, r3); 
+        __m128 hi01 = _mm_unpackhi_ps(r0, r1);
+        __m128 hi23 = _mm_unpackhi_ps(r2, r3);
+        r0 = _mm_movelh_ps(lo01, lo23);
+        r1 = _mm_movehl_ps(lo23, lo01);
+        r2 = _mm_movelh_ps(hi01, hi23);
+        r3 = _mm_movehl_ps(hi23, hi01);
+    }
+
+#endif
+
+    FORCEINLINE
+    bool isaligned(const void* p)
+    {
+        return (reinterpret_cast<size_t>(p) & 15) == 0;
+    }
+
+    // Linear combination of c0, c1 and c2 with the first three elements of v
+    FORCEINLINE
+    __m128 combine3(__m128 v, __m128 c0, __m128 c1, __m128 c2)
+    {
+        __m128 result = _mm_mul_ps(MT_SPLAT(v, 0), c0);
+        result = _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 1), c1));
+        return _mm_add_ps(result, _mm_mul_ps(MT_SPLAT(v, 2), c2));
+    }
+
+    // Unaligned store, or non-temporal store to 16-byte aligned storage
+    FORCEINLINE
+    void store(float* p, __m128 v, bool nonTemporal)
+    {
+        if (nonTemporal)
+        {
+            ASSERT(isaligned(p));
+            _mm_stream_ps(p, v);
+        }
+        else
+        {
+            _mm_storeu_ps(p, v);
+        }
+    }
+
+    // Cross product of the first three elements. The fourth element of the result is zero.
+    FORCEINLINE
+    __m128 cross3(__m128 a, __m128 b)
+    {
+        __m128 a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 a2 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        __m128 b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 b2 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+        return _mm_sub_ps(_mm_mul_ps(a1, b2), _mm_mul_ps(a2, b1));
+    }
+
+    // Normalizes the first three elements, or returns a if they are zero. The squared length is
+    // broadcast to all elements, so that the division needs no shuffle.
+    FORCEINLINE
+    __m128 normalize3(__m128 a)
+    {
+        __m128 tmp = _mm_mul_ps(a, a);
+        __m128 s = _mm_add_ps(_mm_add_ps(MT_SPLAT(tmp, 0), MT_SPLAT(tmp, 1)), MT_SPLAT(tmp, 2));
+        return ispositive(_mm_cvtss_f32(s)) ? _mm_div_ps(a, _mm_sqrt_ps(s)) : a;
+    }
+}
+
+#endif
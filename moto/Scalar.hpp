@@ -55,6 +55,9 @@ namespace mt
     Element lerp(const Element& a, const Element& b, Scalar t);   
 
     template <typename Scalar> Scalar sign(Scalar x);
+
+    // The scalar counterpart of the lane-wise select in Packet.hpp, for code that is generic over both
+    template <typename Scalar> Scalar select(bool condition, Scalar a, Scalar b);
     template <typename Scalar> Scalar rsqrt(Scalar a);
 
     template <typename Scalar> Scalar square(Scalar x);
@@ -260,6 +263,13 @@ namespace mt
         return ispositive(x) ? Scalar(1) : iszero(x) ? Scalar() : Scalar(-1);
     }
 
+    template <typename Scalar>
+    FORCEINLINE
+    Scalar select(bool condition, Scalar a, Scalar b)
+    {
+        return condition ? a : b;
+    }
+
     template <typename Scalar>
     FORCEINLINE
     Scalar rsqrt(Scalar a) 
@@ -0,0 +1,249 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_SOBOL_HPP
+#define MT_SOBOL_HPP
+
+#include <moto/Philox.hpp>
+
+namespace mt
+{
+    // The first four dimensions of the Sobol sequence, with the direction numbers of S. Joe and F. Y. Kuo,
+    // "Constructing Sobol sequences with better two-dimensional projections", SIAM J. Sci. Comput. 30,
+    // 2008. Points are enumerated in Gray code order, so that each next point flips a single direction
+    // number per dimension. The first 2^m points are the same set as in the natural order, and for the
+    // first two dimensions any 2^m consecutive points starting at a multiple of 2^m have exactly one
+    // point in each box of area 2^-m of the form [i 2^-p, (i + 1) 2^-p) x [j 2^-q, (j + 1) 2^-q).
+    //
+    // A nonzero scramble XORs each dimension with a pseudo-random word (a digital shift). This keeps
+    // the stratification, but removes the point at the origin, and gives independent sequences for
+    // randomized quasi-Monte Carlo error estimates.
+    //
+    // The fill routines take the next n points of the sequence. uniform uses the first dimension,
+    // direction maps the first two dimensions onto the sphere and rotation the first three onto the
+    // unit quaternions, both through area-preserving maps, as Random::direction and Random::rotation.
+    // Sample counts that are powers of two cover the domain best.
+
+    class Sobol
+    {
+    public:
+        enum { DIMENSIONS = 4 };
+
+        Sobol(uint32_t scramble = 0);
+
+        uint32_t index() const;
+        void setIndex(uint32_t index);
+
+        void next(uint32_t x[DIMENSIONS]);
+
+        void uniform(float* x, size_t n);
+        void uniform(float* x, size_t n, float a, float b);
+        void uniformVector2(float* const v[2], size_t n);
+        void uniformVector2(float* const v[2], size_t n, float a, float b);
+        void uniformVector3(float* const v[3], size_t n);
+        void uniformVector3(float* const v[3], size_t n, float a, float b);
+        void direction(float* const v[3], size_t n);
+        void rotation(float* const q[4], size_t n);
+
+    private:
+        void sample(float* const x[], int dimensions, size_t n, float a, float b);
+
+        uint32_t mDirections[DIMENSIONS][32];
+        uint32_t mShift[DIMENSIONS];
+        uint32_t mPoint[DIMENSIONS];
+        uint32_t mIndex;
+    };
+
+
+    inline
+    Sobol::Sobol(uint32_t scramble)
+    {
+        // Degree s, coefficients a and initial numbers m of the primitive polynomials, from new-joe-kuo-6.21201.
+        // The first dimension is the van der Corput sequence.
+        static const int s[DIMENSIONS] = { 0, 1, 2, 3 };
+        static const uint32_t a[DIMENSIONS] = { 0, 0, 1, 1 };
+        static const uint32_t m[DIMENSIONS][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+
+        for (int k = 0; k != 32; ++k)
+        {
+            mDirections[0][k] = 1UL << (31 - k);
+        }
+        for (int d = 1; d != DIMENSIONS; ++d)
+        {
+            uint32_t* v = mDirections[d];
+            for (int k = 0; k != s[d]; ++k)
+            {
+                v[k] = m[d][k] << (31 - k);
+            }
+            for (int k = s[d]; k != 32; ++k)
+            {
+                v[k] = v[k - s[d]] ^ (v[k - s[d]] >> s[d]);
+                for (int j = 1; j != s[d]; ++j)
+                {
+                    if ((a[d] >> (s[d] - 1 - j)) & 1)
+                    {
+                        v[k] ^= v[k - j];
+                    }
+                }
+            }
+        }
+
+        if (scramble != 0)
+        {
+            const uint32_t counter[4] = { 0, 0, 0, 0 };
+            const uint32_t key[2] = { scramble, 0 };
+            philox4x32(counter, key, mShift);
+        }
+        else
+        {
+            for (int d = 0; d != DIMENSIONS; ++d)
+            {
+                mShift[d] = 0;
+            }
+        }
+
+        setIndex(0);
+    }
+
+    inline
+    uint32_t Sobol::index() const
+    {
+        return mIndex;
+    }
+
+    inline
+    void Sobol::setIndex(uint32_t index)
+    {
+        // Point i is the XOR of the direction numbers selected by the bits of the Gray code of i.
+        uint32_t gray = index ^ (index >> 1);
+        for (int d = 0; d != DIMENSIONS; ++d)
+        {
+            mPoint[d] = mShift[d];
+            for (int k = 0; k != 32; ++k)
+            {
+                if ((gray >> k) & 1)
+                {
+                    mPoint[d] ^= mDirections[d][k];
+                }
+            }
+        }
+        mIndex = index;
+    }
+
+    FORCEINLINE
+    void Sobol::next(uint32_t x[DIMENSIONS])
+    {
+        // The Gray codes of i and i + 1 differ in the bit of the lowest zero of i. The last index has no
+        // zero bit, and wraps around to the first point by flipping the top direction number.
+        int k = 0;
+        while (k != 31 && ((mIndex >> k) & 1))
+        {
+            ++k;
+        }
+        for (int d = 0; d != DIMENSIONS; ++d)
+        {
+            x[d] = mPoint[d];
+            mPoint[d] ^= mDirections[d][k];
+        }
+        ++mIndex;
+    }
+
+    inline
+    void Sobol::sample(float* const x[], int dimensions, size_t n, float a, float b)
+    {
+        // The upper 24 bits of a word, times 2^-24, are exact floats in [0, 1).
+        float scale = (b - a) * (1.0f / 16777216.0f);
+        for (size_t i = 0; i != n; ++i)
+        {
+            uint32_t point[DIMENSIONS];
+            next(point);
+            for (int d = 0; d != dimensions; ++d)
+            {
+                x[d][i] = a + float(int32_t(point[d] >> 8)) * scale;
+            }
+        }
+    }
+
+    inline
+    void Sobol::uniform(float* x, size_t n)
+    {
+        uniform(x, n, 0.0f, 1.0f);
+    }
+
+    inline
+    void Sobol::uniform(float* x, size_t n, float a, float b)
+    {
+        float* const v[1] = { x };
+        sample(v, 1, n, a, b);
+    }
+
+    inline
+    void Sobol::uniformVector2(float* const v[2], size_t n)
+    {
+        sample(v, 2, n, 0.0f, 1.0f);
+    }
+
+    inline
+    void Sobol::uniformVector2(float* const v[2], size_t n, float a, float b)
+    {
+        sample(v, 2, n, a, b);
+    }
+
+    inline
+    void Sobol::uniformVector3(float* const v[3], size_t n)
+    {
+        sample(v, 3, n, 0.0f, 1.0f);
+    }
+
+    inline
+    void Sobol::uniformVector3(float* const v[3], size_t n, float a, float b)
+    {
+        sample(v, 3, n, a, b);
+    }
+
+    inline
+    void Sobol::direction(float* const v[3], size_t n)
+    {
+        // z = 1 - 2u and the angle 2 pi w map the unit square onto the sphere with uniform density.
+        float* const uv[2] = { v[2], v[0] };
+        sample(uv, 2, n, 0.0f, 1.0f);
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            FloatPacket z = FloatPacket(1.0f) - FloatPacket(2.0f) * detail::loadLanes(v[2], i, n);
+            FloatPacket r = sqrt(max(FloatPacket(1.0f) - z * z, FloatPacket(0.0f)));
+            FloatPacket s, c;
+            sincos(FloatPacket(2.0f * ScalarTraits<float>::pi()) * detail::loadLanes(v[0], i, n), s, c);
+            detail::storeLanes(v[0], i, n, r * c);
+            detail::storeLanes(v[1], i, n, r * s);
+            detail::storeLanes(v[2], i, n, z);
+        }
+    }
+
+    inline
+    void Sobol::rotation(float* const q[4], size_t n)
+    {
+        // From: "Uniform Random Rotations", Ken Shoemake, Graphics Gems III,
+        //       pg. 124-132
+        sample(q, 3, n, 0.0f, 1.0f);
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            FloatPacket x0 = detail::loadLanes(q[0], i, n);
+            FloatPacket r1 = sqrt(FloatPacket(1.0f) - x0);
+            FloatPacket r2 = sqrt(x0);
+            FloatPacket s1, c1, s2, c2;
+            sincos(FloatPacket(2.0f * ScalarTraits<float>::pi()) * detail::loadLanes(q[1], i, n), s1, c1);
+            sincos(FloatPacket(2.0f * ScalarTraits<float>::pi()) * detail::loadLanes(q[2], i, n), s2, c2);
+            detail::storeLanes(q[0], i, n, r1 * s1);
+            detail::storeLanes(q[1], i, n, r1 * c1);
+            detail::storeLanes(q[2], i, n, r2 * s2);
+            detail::storeLanes(q[3], i, n, r2 * c2);
+        }
+    }
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include <moto/ScalarTraits.hpp>
 #include <moto/Vector4.hpp>
 #include <moto/ScalarTraits.hpp>
+#include <moto/PacketMath.hpp>
 
 namespace mt
 {
@@ -31,6 +32,41 @@ namespace mt
     template <typename Vector, typename Scalar> 
     Vector slerp3(const Vector& u1, const Vector& u2, typename Vector::ScalarType t); 
 
+    // Interpolation of unit quaternions in structure-of-arrays layout, e.g. for blending the bones of
+    // many poses. Unlike slerp and nlerp, these take the shortest arc, i.e. u2 is negated where it lies
+    // in the opposite hemisphere of u1. The approximate slerp is an nlerp with a cubic correction of t,
+    // fitted to the angle of the two quaternions. Its rotation is off by at most 8e-4 radians. The
+    // array forms read and write the x, y, z and w components from four separate streams.
+
+    template <typename Scalar, int N> 
+    Vector4<Packet<Scalar, N> > slerpBatch(const Vector4<Packet<Scalar, N> >& u1, const Vector4<Packet<Scalar, N> >& u2, 
+                                           const Packet<Scalar, N>& t, bool approximate = false);
+    template <typename Scalar, int N> 
+    Vector4<Packet<Scalar, N> > nlerpBatch(const Vector4<Packet<Scalar, N> >& u1, const Vector4<Packet<Scalar, N> >& u2, 
+                                           const Packet<Scalar, N>& t);
+
+    void slerpBatch(const float* const u1[4], const float* const u2[4], const float* t, float* const u[4], size_t n, 
+                    bool approximate = false);
+    void nlerpBatch(const float* const u1[4], const float* const u2[4], const float* t, float* const u[4], size_t n);
+
+    // Weighted average of m unit quaternions per lane, e.g. for blending m poses in one pass. Each
+    // quaternion is taken in the hemisphere of the first one, and the weighted sum is normalized. This
+    // does not depend on the order of the inputs other than the first, and for m = 2 it is nlerpBatch.
+    // The weights need not sum to one, but should be nonnegative with a positive sum. Each iteration
+    // refines the average by a power iteration step towards the eigenvector of the largest eigenvalue
+    // of sum(weights[k] u[k] u[k]^T), which is the average that minimizes the weighted sum of squared
+    // chordal distances ("Averaging Quaternions", F. Landis Markley et al., J. Guidance, Control, and
+    // Dynamics 30(4), 2007). The array form reads the four component streams of pose k from u[k].
+
+    template <typename Scalar, int N>
+    Vector4<Packet<Scalar, N> > averageBatch(const Vector4<Packet<Scalar, N> >* u, const Scalar* weights, int m, int iterations = 0);
+
+    void averageBatch(const float* const u[][4], const float* weights, int m, float* const v[4], size_t n, int iterations = 0);
+
+    // The exponential map of exp(const Vector3<Scalar>&) evaluated in the lanes of packets, e.g. for
+    // sampling rotation splines at many parameters at once.
+    template <typename Scalar, int N> Vector4<Packet<Scalar, N> > exp(const Vector3<Packet<Scalar, N> >& v);
+
 
     template <typename Scalar> std::complex<Scalar> euler(Scalar theta);
 
@@ -50,6 +86,26 @@ namespace mt
 
     template <typename Scalar> Vector3<Scalar> dihedral(const Vector3<Scalar>& u1, const Vector3<Scalar>& u2);
 
+#if USE_FAST_MATH
+
+    // Float overloads that evaluate their sines, cosines and arctangents with the polynomials of
+    // PacketMath.hpp. Independent angles share a single packet.
+
+    std::complex<float> euler(float theta);
+
+    namespace detail
+    {
+        bool slerpWeights(float costheta, float t, float& s0, float& s1);
+    }
+
+    void toAxisAngle(Vector3<float>& axis, float& theta, const Vector4<float>& u);
+    Vector3<float> logUnit(const Vector4<float>& u);
+    void toEuler(float& theta, float& phi, const Vector3<float>& u);
+    Vector4<float> fromEuler(float yaw, float pitch, float roll);
+    void toEuler(float& yaw, float& pitch, float& roll, const Vector4<float>& q);
+
+#endif
+
 
     template <typename Scalar>
     Scalar radians(Scalar degs)
@@ -71,17 +127,31 @@ namespace mt
         return acos(dot(v1, v2) * rsqrt(lengthSquared(v1) * lengthSquared(v2)));
     }
 
+    namespace detail
+    {
+        // The weights of u1 and u2 in slerp. Returns false if the angle is zero.
+        template <typename Scalar>
+        bool slerpWeights(Scalar costheta, Scalar t, Scalar& s0, Scalar& s1)
+        {
+            Scalar theta = acos(costheta);
+            if (iszero(theta))
+            {
+                return false;
+            }
+            Scalar r = rsqrt(Scalar(1) - square(costheta));
+            s0 = sin((Scalar(1) - t) * theta) * r;
+            s1 = sin(t * theta) * r;   
+            return true;
+        }
+    }
+
     template <typename Vector>
     Vector slerp(const Vector& u1, const Vector& u2, typename Vector::ScalarType t)
     {
         typedef typename Vector::ScalarType Scalar;
-        Scalar costheta = dot(u1, u2);
-        Scalar theta = acos(costheta);
-        if (!iszero(theta))
+        Scalar s0, s1;
+        if (detail::slerpWeights(dot(u1, u2), t, s0, s1))
         {
-            Scalar r = rsqrt(Scalar(1) - square(costheta));
-            Scalar s0 = sin((Scalar(1) - t) * theta) * r;
-            Scalar s1 = sin(t * theta) * r;   
             return u1 * s0 + u2 * s1;
         }
         else
@@ -115,6 +185,140 @@ namespace mt
         }
     } 
 
+    template <typename Scalar, int N> 
+    Vector4<Packet<Scalar, N> > slerpBatch(const Vector4<Packet<Scalar, N> >& u1, const Vector4<Packet<Scalar, N> >& u2, 
+                                           const Packet<Scalar, N>& t, bool approximate)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        Lanes d = dot(u1, u2);
+        Vector4<Lanes> v2 = u2 * select(isnegative(d), Lanes(Scalar(-1)), Lanes(Scalar(1)));
+        d = min(abs(d), Lanes(Scalar(1)));
+
+        if (approximate)
+        {
+            // Corrects the speed of nlerp, which is too slow at the ends and too fast in the middle.
+            Lanes a = ((Scalar(-1.43519) * d + Scalar(3.55645)) * d - Scalar(3.2452)) * d + Scalar(1.0904);
+            Lanes b = (Scalar(0.215638) * d - Scalar(1.06021)) * d + Scalar(0.848013);
+            Lanes h = t - Scalar(0.5);
+            Lanes k = a * h * h + b;
+            return normalize(lerp(u1, v2, t + t * h * (t - Scalar(1)) * k));
+        }
+
+        // Below the threshold, the weights sin((1 - t) theta) / sin(theta) and sin(t theta) / sin(theta)
+        // are 1 - t and t up to rounding.
+        Lanes theta = acos(d);
+        Lanes s, c, s0, s1;
+        sincos(theta, s, c);
+        sincos((Scalar(1) - t) * theta, s0, c);
+        sincos(t * theta, s1, c);
+        PacketMask<N> small = theta < Lanes(Scalar(1e-4));
+        s = select(small, Lanes(Scalar(1)), s);
+        Lanes w0 = select(small, Scalar(1) - t, s0 / s);
+        Lanes w1 = select(small, t, s1 / s);
+        return u1 * w0 + v2 * w1;
+    }
+
+    template <typename Scalar, int N> 
+    FORCEINLINE
+    Vector4<Packet<Scalar, N> > nlerpBatch(const Vector4<Packet<Scalar, N> >& u1, const Vector4<Packet<Scalar, N> >& u2, 
+                                           const Packet<Scalar, N>& t)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        Lanes sign = select(isnegative(dot(u1, u2)), Lanes(Scalar(-1)), Lanes(Scalar(1)));
+        return normalize(lerp(u1, u2 * sign, t));
+    }
+
+    inline
+    void slerpBatch(const float* const u1[4], const float* const u2[4], const float* t, float* const u[4], size_t n, 
+                    bool approximate)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            detail::storeLanes(u, i, n, slerpBatch(detail::loadLanes(u1, i, n), detail::loadLanes(u2, i, n), detail::loadLanes(t, i, n), approximate));
+        }
+    }
+
+    inline
+    void nlerpBatch(const float* const u1[4], const float* const u2[4], const float* t, float* const u[4], size_t n)
+    {
+        for (size_t i = 0; i < n; i += FloatPacket::SIZE)
+        {
+            detail::storeLanes(u, i, n, nlerpBatch(detail::loadLanes(u1, i, n), detail::loadLanes(u2, i, n), detail::loadLanes(t, i, n)));
+        }
+    }
+
+    template <typename Scalar, int N>
+    Vector4<Packet<Scalar, N> > averageBatch(const Vector4<Packet<Scalar, N> >* u, const Scalar* weights, int m, int iterations)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        ASSERT(m > 0);
+        Vector4<Lanes> sum = u[0] * Lanes(weights[0]);
+        for (int k = 1; k < m; ++k)
+        {
+            sum += u[k] * select(isnegative(dot(u[k], u[0])), Lanes(-weights[k]), Lanes(weights[k]));
+        }
+        Vector4<Lanes> v = normalize(sum);
+        for (int i = 0; i < iterations; ++i)
+        {
+            // The sign of u[k] cancels out in u[k] u[k]^T v.
+            sum = u[0] * (dot(u[0], v) * weights[0]);
+            for (int k = 1; k < m; ++k)
+            {
+                sum += u[k] * (dot(u[k], v) * weights[k]);
+            }
+            v = normalize(sum);
+        }
+        return v;
+    }
+
+    inline
+    void averageBatch(const float* const u[][4], const float* weights, int m, float* const v[4], size_t n, int iterations)
+    {
+        // The inputs are loaded anew for each iteration, rather than being kept in a buffer of m packets.
+        typedef FloatPacket Lanes;
+
+        ASSERT(m > 0);
+        for (size_t i = 0; i < n; i += Lanes::SIZE)
+        {
+            Vector4<Lanes> pivot = detail::loadLanes(u[0], i, n);
+            Vector4<Lanes> sum = pivot * Lanes(weights[0]);
+            for (int k = 1; k < m; ++k)
+            {
+                Vector4<Lanes> uk = detail::loadLanes(u[k], i, n);
+                sum += uk * select(isnegative(dot(uk, pivot)), Lanes(-weights[k]), Lanes(weights[k]));
+            }
+            Vector4<Lanes> average = normalize(sum);
+            for (int j = 0; j < iterations; ++j)
+            {
+                sum = pivot * (dot(pivot, average) * weights[0]);
+                for (int k = 1; k < m; ++k)
+                {
+                    Vector4<Lanes> uk = detail::loadLanes(u[k], i, n);
+                    sum += uk * (dot(uk, average) * weights[k]);
+                }
+                average = normalize(sum);
+            }
+            detail::storeLanes(v, i, n, average);
+        }
+    }
+
+    template <typename Scalar, int N>
+    Vector4<Packet<Scalar, N> > exp(const Vector3<Packet<Scalar, N> >& v)
+    {
+        typedef Packet<Scalar, N> Lanes;
+
+        // Below the threshold, sin(theta) / theta is 1 up to rounding.
+        Lanes theta = length(v);
+        Lanes s, c;
+        sincos(theta, s, c);
+        PacketMask<N> small = theta < Lanes(Scalar(1e-4));
+        Lanes r = select(small, Lanes(Scalar(1)), s / select(small, Lanes(Scalar(1)), theta));
+        return Vector4<Lanes>(v * r, c);
+    }
+
     template <typename Scalar>
     FORCEINLINE 
     std::complex<Scalar> euler(Scalar theta)
@@ -124,6 +328,8 @@ namespace mt
 
 #if HAVE_SINCOS
 
+#if !USE_FAST_MATH
+
     FORCEINLINE 
     std::complex<float> euler(float angle)
     {
@@ -132,6 +338,8 @@ namespace mt
         return std::complex<float>(cosine, sine);
     }
 
+#endif
+
     FORCEINLINE 
     std::complex<double> euler(double angle)
     {
@@ -319,6 +527,90 @@ namespace mt
         roll  = atan2(Scalar(2) * (q.w * q.z + q.x * q.y), Scalar(1) - Scalar(2) * (q.z * q.z + q.x * q.x));
     }
 
+#if USE_FAST_MATH
+
+    FORCEINLINE 
+    std::complex<float> euler(float theta)
+    {
+        Packet<float, 4> s, c;
+        sincos(Packet<float, 4>(theta), s, c);
+        return std::complex<float>(c[0], s[0]);
+    }
+
+    namespace detail
+    {
+        // The weights of u1 and u2 in slerp, with both sines in one packet. Returns false if the angle is zero.
+        FORCEINLINE
+        bool slerpWeights(float costheta, float t, float& s0, float& s1)
+        {
+            float theta = acos(Packet<float, 4>(costheta))[0];
+            if (mt::iszero(theta))
+            {
+                return false;
+            }
+            const float angles[4] = { (1.0f - t) * theta, t * theta, 0.0f, 0.0f };
+            Packet<float, 4> s = sin(Packet<float, 4>(angles));
+            float r = rsqrt(1.0f - square(costheta));
+            s0 = s[0] * r;
+            s1 = s[1] * r;
+            return true;
+        }
+    }
+
+    FORCEINLINE
+    void toAxisAngle(Vector3<float>& axis, float& theta, const Vector4<float>& u)
+    {
+        float s = length3(u);
+        if (!mt::iszero(s))
+        {
+            theta = atan2(Packet<float, 4>(s), Packet<float, 4>(u.w))[0] * 2.0f;
+            axis = xyz(u) / s;
+        }
+        else
+        {
+            theta = 0.0f;
+            axis = Unit<0>();
+        }
+    }
+
+    FORCEINLINE
+    Vector3<float> logUnit(const Vector4<float>& u)
+    {
+        float s = length3(u);
+        return mt::ispositive(s) ? xyz(u) * (atan2(Packet<float, 4>(s), Packet<float, 4>(u.w))[0] / s) : xyz(u);
+    }
+
+    FORCEINLINE 
+    void toEuler(float& theta, float& phi, const Vector3<float>& u)
+    { 
+        phi = asin(Packet<float, 4>(u.z))[0];
+        theta = !mt::iszero(u.y) || !mt::iszero(u.x) ? atan2(Packet<float, 4>(u.y), Packet<float, 4>(u.x))[0] : 0.0f;
+    } 
+
+    FORCEINLINE
+    Vector4<float> fromEuler(float yaw, float pitch, float roll)
+    {
+        const float halves[4] = { yaw * 0.5f, pitch * 0.5f, roll * 0.5f, 0.0f };
+        Packet<float, 4> s, c;
+        sincos(Packet<float, 4>(halves), s, c);
+        return mul(Vector4<float>(0.0f, s[0], 0.0f, c[0]),
+                   Vector4<float>(s[1], 0.0f, 0.0f, c[1]),
+                   Vector4<float>(0.0f, 0.0f, s[2], c[2]));
+    }
+
+    FORCEINLINE
+    void toEuler(float& yaw, float& pitch, float& roll, const Vector4<float>& q)
+    {
+        const float y[4] = { 2.0f * (q.w * q.y + q.z * q.x), 2.0f * (q.w * q.z + q.x * q.y), 0.0f, 0.0f };
+        const float x[4] = { 1.0f - 2.0f * (q.x * q.x + q.y * q.y), 1.0f - 2.0f * (q.z * q.z + q.x * q.x), 1.0f, 1.0f };
+        Packet<float, 4> angles = atan2(Packet<float, 4>(y), Packet<float, 4>(x));
+        yaw   = angles[0];
+        pitch = asin(Packet<float, 4>(2.0f * (q.w * q.x - q.y * q.z)))[0];
+        roll  = angles[1];
+    }
+
+#endif
+
 
 
 }
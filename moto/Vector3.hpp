@@ -111,6 +111,9 @@ namespace mt
 
     template <typename Scalar> Vector3<Scalar> abs(const Vector3<Scalar>& a);
 
+    template <typename Scalar> Vector3<Scalar> min(const Vector3<Scalar>& a, const Vector3<Scalar>& b);
+    template <typename Scalar> Vector3<Scalar> max(const Vector3<Scalar>& a, const Vector3<Scalar>& b);
+
     template <typename Scalar> int maxAxis(const Vector3<Scalar>& a);
     template <typename Scalar> int minAxis(const Vector3<Scalar>& a);
   
@@ -482,6 +485,24 @@ namespace mt
                                abs(a.y),
                                abs(a.z));
     }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Vector3<Scalar> min(const Vector3<Scalar>& a, const Vector3<Scalar>& b)
+    {
+        return Vector3<Scalar>(min(a.x, b.x),
+                               min(a.y, b.y),
+                               min(a.z, b.z));
+    }
+
+    template <typename Scalar>
+    FORCEINLINE
+    Vector3<Scalar> max(const Vector3<Scalar>& a, const Vector3<Scalar>& b)
+    {
+        return Vector3<Scalar>(max(a.x, b.x),
+                               max(a.y, b.y),
+                               max(a.z, b.z));
+    }
     
     template <typename Scalar>
     FORCEINLINE 
@@ -20,6 +20,7 @@
 #include <guts/TypeTraits.hpp>
 
 #include <moto/Vector3.hpp>
+#include <moto/Precision.hpp>
 #include <moto/Promote.hpp>
 #include <moto/Scalar.hpp>
 #include <moto/Algebra.hpp>
@@ -170,6 +171,7 @@ namespace mt
 
     template <typename Scalar> Vector4<Scalar> conjugate(const Vector4<Scalar>& a);
     template <typename Scalar> Vector4<Scalar> inverse(const Vector4<Scalar>& a);
+    template <typename Scalar, typename Policy> Vector4<Scalar> inverse(const Vector4<Scalar>& a, Policy p);
 
     // Plane ops
 
@@ -772,6 +774,13 @@ namespace mt
         return conjugate(a) / dot(a, a);
     }
 
+    template <typename Scalar, typename Policy>
+    FORCEINLINE 
+    Vector4<Scalar> inverse(const Vector4<Scalar>& a, Policy p)
+    {
+        return div(conjugate(a), dot(a, a), p);
+    }
+
     template <typename Scalar> 
     FORCEINLINE
     Vector4<Scalar> plane(const Vector3<Scalar>& normal, const Vector3<Scalar>& point)
@@ -10,65 +10,10 @@
 #error This header file should be included by Vector4.hpp only.
 #endif
 
-#include <xmmintrin.h>
-
-#define USE_FDIV 1
-#define USE_APPROX 0
-
-
-#define MT_SPLAT(a, i) _mm_shuffle_ps((a), (a), _MM_SHUFFLE((i), (i), (i), (i)))
+#include <moto/SSE.hpp>
 
 namespace mt
 { 
-    FORCEINLINE
-    __m128 div(__m128 a, __m128 b)
-    {
-#if USE_APPROX
-        return _mm_mul_ps(a, _mm_rcp_ps(b));
-#else
-        return _mm_div_ps(a, b);
-#endif 
-    }
-    
-    FORCEINLINE
-    __m128 div(__m128 a, float s)
-    {
-        ASSERT(s != 0.0f);
-        
-#if USE_FDIV
-        return _mm_mul_ps(a, _mm_set1_ps(1.0f / s));
-#else
-        return div(a, _mm_set1_ps(1));
-#endif
-    }
-
-#if WASTE_CYCLES
-
-    // This one taken straight from xmmintrin.h is more expensive than the one below. No BS.
-
-    FORCEINLINE
-    void transpose(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
-    {
-        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
-    }
-
-#else
-
-    FORCEINLINE
-    void transpose(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
-    { 
-        __m128 lo01 = _mm_unpacklo_ps(r0, r1); 
-        __m128 lo23 = _mm_unpacklo_ps(r2, r3); 
-        __m128 hi01 = _mm_unpackhi_ps(r0, r1);
-        __m128 hi23 = _mm_unpackhi_ps(r2, r3);
-        r0 = _mm_movelh_ps(lo01, lo23);
-        r1 = _mm_movehl_ps(lo23, lo01);
-        r2 = _mm_movelh_ps(hi01, hi23);
-        r3 = _mm_movehl_ps(hi23, hi01);
-    }
-
-#endif
-
     template <>
     class Vector4<float>
     {
@@ -166,6 +111,16 @@ namespace mt
    
     template <int X, int Y, int Z, int W> 
     Vector4<float> swizzle(const Vector4<float>& a);
+
+    // Register loads and stores of the packed 12-byte Vector3<float>. load3 does not read past the vector, 
+    // and the fourth element of a loaded register is undefined. The groups of four move four consecutive 
+    // vectors as three registers and need no alignment, except for stream4, which performs non-temporal 
+    // stores to a 16-byte aligned destination.
+    __m128 load3(const Vector3<float>& a);
+    void store3(Vector3<float>& a, __m128 v);
+    void load4(const Vector3<float>* a, __m128& v0, __m128& v1, __m128& v2, __m128& v3);
+    void store4(Vector3<float>* a, __m128 v0, __m128 v1, __m128 v2, __m128 v3);
+    void stream4(Vector3<float>* a, __m128 v0, __m128 v1, __m128 v2, __m128 v3);
     
 
     FORCEINLINE
@@ -517,4 +472,69 @@ namespace mt
         ASSERT(!iszero(a.w));
         return Vector4<float>(div(a.vec, MT_SPLAT(a.vec, 3)));
     }
+
+    FORCEINLINE
+    __m128 load3(const Vector3<float>& a)
+    {
+        return _mm_setr_ps(a.x, a.y, a.z, 0.0f);
+    }
+
+    FORCEINLINE
+    void store3(Vector3<float>& a, __m128 v)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(&a.x), v);
+        _mm_store_ss(&a.z, _mm_movehl_ps(v, v));
+    }
+
+    // Four packed vectors occupy three registers: (x0, y0, z0, x1), (y1, z1, x2, y2), (z2, x3, y3, z3).
+
+    FORCEINLINE
+    void unpack3(__m128 a0, __m128 a1, __m128 a2, __m128& v0, __m128& v1, __m128& v2, __m128& v3)
+    {
+        __m128 tmp = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 0, 3, 3));
+        v0 = a0;
+        v1 = _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(3, 3, 2, 0));
+        v2 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(0, 0, 3, 2));
+        v3 = _mm_shuffle_ps(a2, a2, _MM_SHUFFLE(3, 3, 2, 1));
+    }
+
+    FORCEINLINE
+    void pack3(__m128 v0, __m128 v1, __m128 v2, __m128 v3, __m128& a0, __m128& a1, __m128& a2)
+    {
+        __m128 tmp = _mm_shuffle_ps(v1, v0, _MM_SHUFFLE(2, 2, 0, 0));
+        a0 = _mm_shuffle_ps(v0, tmp, _MM_SHUFFLE(0, 2, 1, 0));
+        a1 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 0, 2, 1));
+        tmp = _mm_shuffle_ps(v2, v3, _MM_SHUFFLE(0, 0, 2, 2));
+        a2 = _mm_shuffle_ps(tmp, v3, _MM_SHUFFLE(2, 1, 2, 0));
+    }
+
+    FORCEINLINE
+    void load4(const Vector3<float>* a, __m128& v0, __m128& v1, __m128& v2, __m128& v3)
+    {
+        const float* p = &a[0].x;
+        unpack3(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), v0, v1, v2, v3);
+    }
+
+    FORCEINLINE
+    void store4(Vector3<float>* a, __m128 v0, __m128 v1, __m128 v2, __m128 v3)
+    {
+        float* p = &a[0].x;
+        __m128 a0, a1, a2;
+        pack3(v0, v1, v2, v3, a0, a1, a2);
+        _mm_storeu_ps(p, a0);
+        _mm_storeu_ps(p + 4, a1);
+        _mm_storeu_ps(p + 8, a2);
+    }
+
+    FORCEINLINE
+    void stream4(Vector3<float>* a, __m128 v0, __m128 v1, __m128 v2, __m128 v3)
+    {
+        float* p = &a[0].x;
+        ASSERT(isaligned(p));
+        __m128 a0, a1, a2;
+        pack3(v0, v1, v2, v3, a0, a1, a2);
+        _mm_stream_ps(p, a0);
+        _mm_stream_ps(p + 4, a1);
+        _mm_stream_ps(p + 8, a2);
+    }
 }
@@ -0,0 +1,482 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include "curve/CubicBezierSplineCurve.hpp"
+#include "curve/CurveFitter.hpp"
+#include "curve/Flattener.hpp"
+#include "curve/SquadCurve.hpp"
+#include "curve/QuaternionBSplineCurve.hpp"
+#include "curve/DualQuaternionBSplineCurve.hpp"
+#include "curve/Extruder.hpp"
+#include "curve/MappedFile.hpp"
+#include "curve/SplineCurveView.hpp"
+#include "curve/TessellationView.hpp"
+#include "curve/TessellationCache.hpp"
+#include "curve/CircleCurve.hpp"
+#include "curve/BinaryFormat.hpp"
+
+#include <guts/Serialization.hpp>
+
+using namespace cv;
+
+#include "gtest/gtest.h"
+#include <moto/Random.hpp>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+
+
+Scalar closestDistance(const Curve& curve, const Vector3& point, int steps)
+{
+    Scalar result = ScalarTraits::infinity();
+    for (int i = 0; i <= steps; ++i)
+    {
+        result = mt::min(result, distance(real(curve.eval(Scalar(i) / Scalar(steps))), point));
+    }
+    return result;
+}
+
+TEST(Curve, CurveFitter)
+{
+    const int COUNT = 1000;
+    const Scalar TOLERANCE = Scalar(0.01);
+
+    std::vector<Vector3> points;
+    for (int i = 0; i != COUNT; ++i)
+    {
+        Scalar t = Scalar(i) / Scalar(COUNT - 1) * Scalar(12);
+        points.push_back(Vector3(cos(t), sin(t), t * Scalar(0.1)));
+    }
+
+    CubicBezierSplineCurve curve;
+    CurveFitter fitter(TOLERANCE);
+    size_t segmentCount = fitter.fit(curve, &points[0], points.size());
+
+    EXPECT_EQ(segmentCount * 3 + 1, curve.pointCount());
+    EXPECT_LE(curve.pointCount() * 10, points.size());
+
+    EXPECT_EQ(points.front(), curve.point(0));
+    EXPECT_EQ(points.back(), curve.point(curve.pointCount() - 1));
+     
+    for (int i = 0; i < COUNT; i += 7)
+    {
+        EXPECT_LE(closestDistance(curve, points[i], 4000), TOLERANCE * Scalar(1.01));
+    }
+}
+
+TEST(Curve, CurveFitterDegenerate)
+{
+    std::vector<Vector3> points(3, Vector3(Scalar(1), Scalar(2), Scalar(3)));
+    points.push_back(Vector3(Scalar(2), Scalar(2), Scalar(3)));
+
+    CubicBezierSplineCurve curve;
+    CurveFitter fitter(Scalar(0.01));
+    fitter.fit(curve, &points[0], points.size());
+
+    for (size_t i = 0; i != curve.pointCount(); ++i)
+    {
+        EXPECT_FALSE(mt::isnan(curve.point(i).x));
+    }
+}
+
+Scalar segmentDistance(const Vector2& p, const Vector2& a, const Vector2& b)
+{
+    Vector2 ab = b - a;
+    Scalar t = mt::saturate(dot(p - a, ab) / lengthSquared(ab));
+    return distance(p, a + ab * t);
+}
+
+TEST(Curve, Flattener)
+{
+    const Scalar TOLERANCE = Scalar(0.1);
+
+    Vector2 p0(Scalar(0), Scalar(0));
+    Vector2 p1(Scalar(10), Scalar(40));
+    Vector2 p2(Scalar(50), Scalar(-30));
+    Vector2 p3(Scalar(60), Scalar(10));
+
+    Flattener flattener(TOLERANCE);
+    flattener.moveTo(p0);
+    flattener.cubicTo(p1, p2, p3);
+
+    int n = Flattener::cubicSegmentCount(p0, p1, p2, p3, TOLERANCE);
+    ASSERT_EQ(size_t(n + 1), flattener.pointCount());
+    EXPECT_EQ(p3, flattener.point(n));
+
+    for (int i = 0; i != n; ++i)
+    {
+        for (int j = 0; j <= 10; ++j)
+        {
+            Scalar t = (Scalar(i) + Scalar(j) / Scalar(10)) / Scalar(n);
+            Scalar s = Scalar(1) - t;
+            Vector2 p = p0 * (s * s * s) + p1 * (Scalar(3) * s * s * t) + p2 * (Scalar(3) * s * t * t) + p3 * (t * t * t);
+            EXPECT_LE(segmentDistance(p, flattener.point(i), flattener.point(i + 1)), TOLERANCE);
+        }
+    }
+
+    flattener.clear();
+    flattener.moveTo(p0);
+    flattener.quadraticTo(p1, p2);
+    EXPECT_EQ(size_t(Flattener::quadraticSegmentCount(p0, p1, p2, TOLERANCE) + 1), flattener.pointCount());
+    EXPECT_EQ(p2, flattener.point(flattener.pointCount() - 1));
+}
+
+TEST(Curve, FlattenerContours)
+{
+    Flattener flattener(Scalar(0.1));
+    
+    // An outer square and an inner quadratic contour, as in the outline of a glyph with a hole
+    flattener.moveTo(Vector2(Scalar(0), Scalar(0)));
+    flattener.lineTo(Vector2(Scalar(10), Scalar(0)));
+    flattener.lineTo(Vector2(Scalar(10), Scalar(10)));
+    flattener.lineTo(Vector2(Scalar(0), Scalar(10)));
+    flattener.lineTo(Vector2(Scalar(0), Scalar(0)));
+
+    Vector2 p0(Scalar(2), Scalar(2));
+    Vector2 p1(Scalar(5), Scalar(8));
+    Vector2 p2(Scalar(8), Scalar(2));
+    flattener.moveTo(p0);
+    flattener.quadraticTo(p1, p2);
+    flattener.lineTo(p0);
+
+    ASSERT_EQ(size_t(2), flattener.contourCount());
+    EXPECT_EQ(size_t(0), flattener.contourOffset(0));
+    EXPECT_EQ(size_t(5), flattener.contourPointCount(0));
+    EXPECT_EQ(size_t(5), flattener.contourOffset(1));
+    EXPECT_EQ(size_t(Flattener::quadraticSegmentCount(p0, p1, p2, Scalar(0.1)) + 2), flattener.contourPointCount(1));
+    EXPECT_EQ(flattener.pointCount(), flattener.contourOffset(1) + flattener.contourPointCount(1));
+    EXPECT_EQ(p0, flattener.point(flattener.contourOffset(1)));
+    EXPECT_EQ(Vector2(Scalar(0), Scalar(0)), flattener.point(flattener.contourOffset(1) - 1));
+
+    flattener.clear();
+    EXPECT_EQ(size_t(0), flattener.contourCount());
+}
+
+Scalar norm(const Quaternion& q)
+{
+    return length(q);
+}
+
+Scalar norm(const DualQuaternion& q)
+{
+    return mt::max(length(real(q)), length(dual(q)));
+}
+
+// Third-order one-sided difference at param, from the left for side = -1 and from the right for 
+// side = 1. Order 1 is the first derivative and order 2 the second.
+template <typename Value, typename Curve>
+Value difference(const Curve& curve, Scalar param, Scalar side, Scalar h, int order)
+{
+    Value f[5];
+    for (int i = 0; i != 5; ++i)
+    {
+        f[i] = curve.eval(param + side * h * Scalar(i));
+    }
+    if (order == 1)
+    {
+        return (f[1] * Scalar(18) - f[0] * Scalar(11) - f[2] * Scalar(9) + f[3] * Scalar(2)) * (side / (Scalar(6) * h));
+    }
+    return (f[0] * Scalar(35) - f[1] * Scalar(104) + f[2] * Scalar(114) - f[3] * Scalar(56) + f[4] * Scalar(11)) * (Scalar(1) / (Scalar(12) * h * h));
+}
+
+// Checks that the value and the derivatives up to the given order agree from both sides of each 
+// knot, and that the batched evaluation matches the scalar one.
+template <typename Value, typename Curve>
+void testContinuity(const Curve& curve, int segmentCount, int order)
+{
+    for (int i = 1; i != segmentCount; ++i)
+    {
+        Scalar knot = Scalar(i) / Scalar(segmentCount);
+        Scalar h = Scalar(1e-5);
+        EXPECT_LE(norm(curve.eval(knot + h) - curve.eval(knot - h)), Scalar(2e-5));
+        if (order >= 1)
+        {
+            h = Scalar(1e-2);
+            Value left = difference<Value>(curve, knot, Scalar(-1), h, 1);
+            Value right = difference<Value>(curve, knot, Scalar(1), h, 1);
+            EXPECT_LE(norm(left - right), Scalar(5e-4) * mt::max(norm(right), Scalar(1)));
+        }
+        if (order >= 2)
+        {
+            h = Scalar(3e-2);
+            Value left = difference<Value>(curve, knot, Scalar(-1), h, 2);
+            Value right = difference<Value>(curve, knot, Scalar(1), h, 2);
+            EXPECT_LE(norm(left - right), Scalar(1e-2) * mt::max(norm(right), Scalar(1)));
+        }
+    }
+
+    const size_t COUNT = 37;
+    Scalar params[COUNT];
+    Value result[COUNT];
+    for (size_t i = 0; i != COUNT; ++i)
+    {
+        params[i] = Scalar(i) / Scalar(COUNT - 1);
+    }
+    curve.eval(params, result, COUNT);
+    for (size_t i = 0; i != COUNT; ++i)
+    {
+        EXPECT_LE(norm(curve.eval(params[i]) - result[i]), Scalar(2e-6));
+    }
+}
+
+// Keys that turn by 0.3 radians about random axes, so that the derivatives are of the order of one
+Quaternion nextKey(mt::Random<Scalar>& random, const Quaternion& key)
+{
+    return mul(key, mt::exp(random.direction() * Scalar(0.15)));
+}
+
+TEST(Curve, SquadCurve)
+{
+    mt::Random<Scalar> random;
+
+    SquadCurve curve;
+    Quaternion key = random.rotation();
+    for (int i = 0; i != 6; ++i)
+    {
+        curve.addKey(key);
+        key = nextKey(random, key);
+    }
+
+    for (size_t i = 0; i != curve.keyCount(); ++i)
+    {
+        Quaternion q = curve.eval(Scalar(i) / Scalar(curve.keyCount() - 1));
+        EXPECT_LE(distance(q, curve.key(i)), Scalar(1e-6));
+    }
+
+    testContinuity<Quaternion>(curve, 5, 1);
+
+    // Repeated and nearly repeated keys, whose dot products may round to just above one
+    curve.clear();
+    Quaternion q = random.rotation();
+    curve.addKey(q);
+    curve.addKey(q);
+    curve.addKey(normalize(q + Quaternion(Scalar(1e-6), Scalar(), Scalar(), Scalar())));
+    curve.addKey(q);
+    for (int i = 0; i <= 30; ++i)
+    {
+        Quaternion r = curve.eval(Scalar(i) / Scalar(30));
+        EXPECT_FALSE(mt::isnan(r.x) || mt::isnan(r.y) || mt::isnan(r.z) || mt::isnan(r.w));
+        EXPECT_NEAR(dot(r, q), Scalar(1), Scalar(1e-5));
+    }
+}
+
+TEST(Curve, QuaternionBSplineCurve)
+{
+    mt::Random<Scalar> random;
+
+    QuaternionBSplineCurve curve;
+    Quaternion key = random.rotation();
+    for (int i = 0; i != 6; ++i)
+    {
+        curve.addKey(key);
+        key = nextKey(random, key);
+    }
+
+    for (int i = 0; i <= 30; ++i)
+    {
+        EXPECT_NEAR(length(curve.eval(Scalar(i) / Scalar(30))), Scalar(1), Scalar(1e-6));
+    }
+
+    testContinuity<Quaternion>(curve, 3, 2);
+}
+
+TEST(Curve, DualQuaternionBSplineCurve)
+{
+    mt::Random<Scalar> random;
+
+    // Without rotation, the translations are the cubic B-spline of the key translations, which is 
+    // (t[i] + 4 t[i + 1] + t[i + 2]) / 6 at the start of segment i.
+    DualQuaternionBSplineCurve curve;
+    Vector3 t[6];
+    for (int i = 0; i != 6; ++i)
+    {
+        t[i] = Vector3(Scalar(i), Scalar(i * i) * Scalar(0.1), Scalar());
+        curve.addKey(mt::rigid(Quaternion(Identity()), t[i]));
+    }
+    for (int i = 0; i != 4; ++i)
+    {
+        Vector3 expected = (t[i] + t[i + 1] * Scalar(4) + t[i + 2]) / Scalar(6);
+        EXPECT_LE(distance(translation(curve.eval(Scalar(i) / Scalar(3))), expected), Scalar(1e-5));
+    }
+
+    curve.clear();
+    Quaternion key = random.rotation();
+    for (int i = 0; i != 6; ++i)
+    {
+        curve.addKey(mt::rigid(key, random.direction() * Scalar(0.3) + Vector3(Scalar(i) * Scalar(0.3), Scalar(), Scalar())));
+        key = nextKey(random, key);
+    }
+
+    for (int i = 0; i <= 30; ++i)
+    {
+        DualQuaternion q = curve.eval(Scalar(i) / Scalar(30));
+        EXPECT_NEAR(length(real(q)), Scalar(1), Scalar(1e-6));
+        EXPECT_NEAR(dot(real(q), dual(q)), Scalar(), Scalar(1e-6));
+    }
+
+    testContinuity<DualQuaternion>(curve, 3, 2);
+}
+
+TEST(Curve, Serialization)
+{
+    CubicBezierSplineCurve curve;
+    curve.addPoint(Vector3(Scalar(0), Scalar(0), Scalar(0)));
+    curve.addPoint(Vector3(Scalar(1), Scalar(2), Scalar(0)));
+    curve.addPoint(Vector3(Scalar(3), Scalar(2), Scalar(1)));
+    curve.addPoint(Vector3(Scalar(4), Scalar(0), Scalar(1)));
+
+    std::stringstream ss;
+    ASSERT_TRUE(guts::serialize(curve, ss));
+
+    CubicBezierSplineCurve copy;
+    ASSERT_TRUE(guts::deserialize(copy, ss));
+    ASSERT_EQ(curve.pointCount(), copy.pointCount());
+    for (size_t i = 0; i != curve.pointCount(); ++i)
+    {
+        EXPECT_EQ(curve.point(i), copy.point(i));
+    }
+
+    Extruder extruder(Scalar(0.01));
+    extruder.tesselate(curve);
+
+    const char* path = "test_curve_tessellation.bin";
+    {
+        std::ofstream os(path, std::ios::binary);
+        ASSERT_TRUE(guts::serialize(extruder, os));
+    }
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+
+    TessellationView view;
+    ASSERT_TRUE(view.map(file.data(), file.size()));
+    EXPECT_FLOAT_EQ(extruder.tolerance(), view.tolerance());
+    ASSERT_EQ(extruder.sampleCount(), view.sampleCount());
+    for (size_t i = 0; i != view.sampleCount(); ++i)
+    {
+        EXPECT_EQ(extruder.sample(i).arcLength, view.sample(i).arcLength);
+        EXPECT_EQ(extruder.sample(i).xform[3], view.sample(i).xform[3]);
+    }
+
+    // A tessellation is not a spline curve
+    SplineCurveView curveView;
+    EXPECT_FALSE(curveView.map(file.data(), file.size()));
+
+    file.close();
+    std::remove(path);
+
+    // The padding of the samples is written as zeros.
+    std::stringstream ts;
+    ASSERT_TRUE(guts::serialize(extruder, ts));
+    std::string bytes = ts.str();
+    size_t offset = headerSize<Extruder>() + sizeof(Scalar) + sizeof(uint32_t);
+    offset += paddingSize(offset);
+    ASSERT_EQ(offset + extruder.sampleCount() * sizeof(Sample), bytes.size());
+    for (size_t i = 0; i != extruder.sampleCount(); ++i)
+    {
+        for (size_t j = sizeof(Matrix4x4) + sizeof(Scalar); j != sizeof(Sample); ++j)
+        {
+            EXPECT_EQ(0, bytes[offset + i * sizeof(Sample) + j]);
+        }
+    }
+}
+
+TEST(Curve, SerializationCorruptCount)
+{
+    CubicBezierSplineCurve curve;
+    for (int i = 0; i != 4; ++i)
+    {
+        curve.addPoint(Vector3(Scalar(i), Scalar(), Scalar()));
+    }
+
+    std::stringstream ss;
+    ASSERT_TRUE(guts::serialize(curve, ss));
+    std::string bytes = ss.str();
+
+    // A point count far beyond the end of the data must fail rather than allocate.
+    uint32_t count = 0x7fffffff;
+    std::memcpy(&bytes[headerSize<SplineCurve>()], &count, sizeof(uint32_t));
+
+    std::stringstream corrupt(bytes);
+    CubicBezierSplineCurve copy;
+    EXPECT_FALSE(guts::deserialize(copy, corrupt));
+
+    std::vector<char> buffer(bytes.size() + CV_FILE_ALIGNMENT);
+    char* data = &buffer[0] + paddingSize(reinterpret_cast<uintptr_t>(&buffer[0]));
+    std::memcpy(data, bytes.data(), bytes.size());
+    SplineCurveView view;
+    EXPECT_FALSE(view.map(data, bytes.size()));
+
+    // A view needs the header to be aligned.
+    count = 4;
+    std::memcpy(data + headerSize<SplineCurve>(), &count, sizeof(uint32_t));
+    EXPECT_TRUE(view.map(data, bytes.size()));
+    std::memmove(data + 4, data, bytes.size());
+    EXPECT_FALSE(view.map(data + 4, bytes.size()));
+}
+
+TEST(Curve, TessellationCache)
+{
+    CircleCurve circle1(Vector3(Zero()), Scalar(1));
+    CircleCurve circle2(Vector3(Zero()), Scalar(2));
+    CircleCurve circle3(Vector3(Zero()), Scalar(0.5));
+
+    Scalar levels[] = { Scalar(0.1), Scalar(0.001), Scalar(0.01) };
+    TessellationCache cache;
+    cache.setLevels(levels, 3);
+
+    const Extruder& fine = cache.tessellation(circle1, Scalar(0.001));
+    size_t fineCount = fine.sampleCount();
+    EXPECT_FLOAT_EQ(Scalar(0.001), fine.tolerance());
+
+    const Extruder& coarse = cache.tessellation(circle1, Scalar(0.05));
+    EXPECT_FLOAT_EQ(Scalar(0.01), coarse.tolerance());
+    EXPECT_LT(coarse.sampleCount(), fineCount);
+    EXPECT_EQ(real(circle1.eval(Scalar(1))), xyz(column(coarse.sample(coarse.sampleCount() - 1).xform, 3)));
+
+    // Decimated samples stay within tolerance of the fine samples.
+    for (size_t i = 0, j = 0; i + 1 < coarse.sampleCount(); ++i)
+    {
+        Vector3 from = xyz(column(coarse.sample(i).xform, 3));
+        Vector3 to = xyz(column(coarse.sample(i + 1).xform, 3));
+        while (j != fineCount && fine.sample(j).arcLength < coarse.sample(i + 1).arcLength)
+        {
+            Vector3 p = xyz(column(fine.sample(j).xform, 3));
+            EXPECT_LE(length(cross(p - from, p - to)) / distance(from, to), Scalar(0.01) * Scalar(1.001));
+            ++j;
+        }
+    }
+
+    EXPECT_EQ(size_t(1), cache.hitCount());
+    EXPECT_EQ(size_t(1), cache.missCount());
+
+    // The larger circle alone exceeds the bound, so it is not cached and nothing is evicted for it.
+    cache.setMaxSampleCount(cache.sampleCount());
+    const Extruder& large = cache.tessellation(circle2, Scalar(1));
+    EXPECT_FLOAT_EQ(Scalar(0.1), large.tolerance());
+    EXPECT_LT(size_t(1), large.sampleCount());
+    EXPECT_EQ(size_t(1), cache.curveCount());
+    EXPECT_LE(cache.sampleCount(), cache.maxSampleCount());
+    cache.tessellation(circle1, Scalar(1));
+    EXPECT_EQ(size_t(2), cache.missCount());
+    EXPECT_FLOAT_EQ(Scalar(0.5), cache.hitRate());
+
+    // Too small to hold both of the smaller circles
+    cache.tessellation(circle3, Scalar(1));
+    EXPECT_EQ(size_t(1), cache.curveCount());
+    EXPECT_LE(cache.sampleCount(), cache.maxSampleCount());
+    cache.tessellation(circle1, Scalar(1));
+    EXPECT_EQ(size_t(4), cache.missCount());
+    EXPECT_FLOAT_EQ(Scalar(1) / Scalar(3), cache.hitRate());
+
+    cache.invalidate(circle1);
+    EXPECT_EQ(size_t(0), cache.curveCount());
+    EXPECT_EQ(size_t(0), cache.sampleCount());
+}
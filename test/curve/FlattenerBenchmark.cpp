@@ -0,0 +1,52 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2016 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the number of glyph-like outlines flattened per second. Usage: bench_flattener [outlines]
+
+#include "curve/Flattener.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace cv;
+
+int main(int argc, char** argv)
+{
+    int outlineCount = argc > 1 ? atoi(argv[1]) : 100000;
+
+    // A glyph-like outline of two quadratic and two cubic arcs, in font units
+    Vector2 points[] = 
+    {
+        Vector2(Scalar(0), Scalar(0)),
+        Vector2(Scalar(300), Scalar(-20)), Vector2(Scalar(600), Scalar(0)),
+        Vector2(Scalar(700), Scalar(300)), Vector2(Scalar(650), Scalar(600)), Vector2(Scalar(500), Scalar(700)),
+        Vector2(Scalar(250), Scalar(750)), Vector2(Scalar(50), Scalar(600)),
+        Vector2(Scalar(-50), Scalar(400)), Vector2(Scalar(-30), Scalar(200)), Vector2(Scalar(0), Scalar(0))
+    };
+
+    Flattener flattener(Scalar(0.5));
+    size_t pointCount = 0;
+
+    int64_t start = getPerformanceCounter();
+    for (int i = 0; i != outlineCount; ++i)
+    {
+        flattener.clear();
+        flattener.moveTo(points[0]);
+        flattener.quadraticTo(points[1], points[2]);
+        flattener.cubicTo(points[3], points[4], points[5]);
+        flattener.quadraticTo(points[6], points[7]);
+        flattener.cubicTo(points[8], points[9], points[10]);
+        pointCount += flattener.pointCount();
+    }
+    int64_t stop = getPerformanceCounter();
+
+    double seconds = double(stop - start) / double(getPerformanceFrequency());
+    printf("Flattened %.0f outlines per second (%d points per outline)\n", seconds > 0.0 ? outlineCount / seconds : 0.0, outlineCount != 0 ? int(pointCount / outlineCount) : 0);
+
+    return 0;
+}
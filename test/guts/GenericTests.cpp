@@ -6,6 +6,7 @@
     http://opensource.org/licenses/MIT
 */
 
+#include "guts/Arena.hpp"
 #include "guts/Vector.hpp"
 #include "guts/Set.hpp"
 #include "guts/HashTable.hpp"
@@ -114,3 +115,36 @@ TEST(Generic, HashTable)
         }
     }
 }
+
+TEST(Generic, Arena)
+{
+    guts::Arena arena(256);
+
+    for (int k = 0; k != 3; ++k)
+    {
+        arena.clear();
+        char* last = 0;
+        for (int i = 0; i != 100; ++i)
+        {
+            // Allocations are aligned, and do not overlap within a block.
+            char* p = static_cast<char*>(arena.allocate(24));
+            EXPECT_EQ(size_t(p) & 0xf, size_t(0));
+            EXPECT_TRUE(last == 0 || p >= last + 24 || p < last);
+            last = p;
+        }
+        EXPECT_EQ(arena.size(), size_t(2400));
+
+        // Oversized requests get their own block.
+        arena.allocate(1000, 64);
+    }
+
+    // After the first round the blocks are reused.
+    size_t capacity = arena.capacity();
+    arena.clear();
+    for (int i = 0; i != 100; ++i)
+    {
+        arena.allocate(24);
+    }
+    arena.allocate(1000, 64);
+    EXPECT_EQ(arena.capacity(), capacity);
+}
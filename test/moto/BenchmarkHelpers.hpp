@@ -0,0 +1,48 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#ifndef MT_BENCHMARKHELPERS_HPP
+#define MT_BENCHMARKHELPERS_HPP
+
+#include <consolid/consolid.h>
+
+#include <cstdlib>
+#include <ctime>
+
+#if USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// Buffers are aligned for the widest packet, so that the benchmarks can stream to them.
+inline
+void* alignedAlloc(size_t size)
+{
+#if USE_SSE
+    return _mm_malloc(size, 32);
+#else
+    return malloc(size);
+#endif
+}
+
+inline
+void alignedFree(void* p)
+{
+#if USE_SSE
+    _mm_free(p);
+#else
+    free(p);
+#endif
+}
+
+inline
+double seconds(clock_t start)
+{
+    return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+#endif
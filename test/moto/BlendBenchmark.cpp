@@ -0,0 +1,97 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the throughput of blending four poses of a skeleton, as three chained slerpBatch calls and
+// as one averageBatch with and without refinement, in millions of bones per second.
+// Usage: bench_blend [bones] [repeats]
+
+#include <moto/Trigonometric.hpp>
+#include <moto/Philox.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkHelpers.hpp"
+
+const int POSES = 4;
+
+void report(const char* name, double count, double time)
+{
+    printf("%-26s %10.2f M/s\n", name, time > 0.0 ? count / time : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? size_t(atol(argv[1])) : size_t(1) << 12;
+    int repeats = argc > 2 ? atoi(argv[2]) : 1000;
+
+    std::vector<float> poses(POSES * 4 * n);
+    float* pose[POSES][4];
+    const float* in[POSES][4];
+    for (int k = 0; k != POSES; ++k)
+    {
+        for (int j = 0; j != 4; ++j)
+        {
+            pose[k][j] = &poses[(4 * k + j) * n];
+            in[k][j] = pose[k][j];
+        }
+    }
+    std::vector<float> blended(4 * n);
+    float* const out[4] = { &blended[0], &blended[n], &blended[2 * n], &blended[3 * n] };
+
+    mt::Philox philox;
+    for (int k = 0; k != POSES; ++k)
+    {
+        philox.rotation(pose[k], n);
+    }
+
+    // Chained slerps take pose k with weight w_k relative to the sum of the weights so far.
+    const float weights[POSES] = { 0.4f, 0.3f, 0.2f, 0.1f };
+    std::vector<float> t[POSES];
+    float sum = weights[0];
+    for (int k = 1; k != POSES; ++k)
+    {
+        sum += weights[k];
+        t[k].assign(n, weights[k] / sum);
+    }
+
+    double count = double(n) * repeats * 1e-6;
+    float sink = 0.0f;
+
+    clock_t start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        mt::slerpBatch(in[0], in[1], &t[1][0], out, n);
+        for (int k = 2; k != POSES; ++k)
+        {
+            mt::slerpBatch(out, in[k], &t[k][0], out, n);
+        }
+        sink += out[3][r % n];
+    }
+    report("chained slerpBatch", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        mt::averageBatch(in, weights, POSES, out, n);
+        sink += out[3][r % n];
+    }
+    report("averageBatch", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        mt::averageBatch(in, weights, POSES, out, n, 2);
+        sink += out[3][r % n];
+    }
+    report("with 2 refinement steps", count, seconds(start));
+
+    printf("(%g)\n", double(sink));
+
+    return 0;
+}
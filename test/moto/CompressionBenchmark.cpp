@@ -0,0 +1,84 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the throughput of the single and batch forms of the quaternion and half-float codecs, in
+// millions of values per second. Usage: bench_compression [values] [repeats]
+
+#include <moto/Compression.hpp>
+#include <moto/Philox.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkHelpers.hpp"
+
+void report(const char* name, double count, double time)
+{
+    printf("%-26s %10.2f M/s\n", name, time > 0.0 ? count / time : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? size_t(atol(argv[1])) : size_t(1) << 16;
+    int repeats = argc > 2 ? atoi(argv[2]) : 100;
+
+    std::vector<float> v[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+    float* const q[4] = { &v[0][0], &v[1][0], &v[2][0], &v[3][0] };
+    std::vector<float> x(n);
+    std::vector<uint32_t> code32(n);
+    std::vector<uint16_t> half(n);
+
+    mt::Philox philox;
+    philox.rotation(q, n);
+    philox.uniform(&x[0], n, -1000.0f, 1000.0f);
+
+    double count = double(n) * repeats * 1e-6;
+    uint32_t sink = 0;
+
+    clock_t start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            code32[i] = mt::packQuaternion32(mt::Vector4<float>(v[0][i], v[1][i], v[2][i], v[3][i]));
+        }
+        sink += code32[r % n];
+    }
+    report("packQuaternion32 single", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        mt::packQuaternion32(q, &code32[0], n);
+        sink += code32[r % n];
+    }
+    report("packQuaternion32 batch", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            half[i] = mt::packHalf(x[i]);
+        }
+        sink += half[r % n];
+    }
+    report("packHalf single", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        mt::packHalf(&x[0], &half[0], n);
+        sink += half[r % n];
+    }
+    report("packHalf batch", count, seconds(start));
+
+    printf("(%u)\n", unsigned(sink));
+
+    return 0;
+}
@@ -317,3 +317,274 @@ TEST(DualNumber, DualQuaternionLogarithm)
         theta *= Scalar(0.5);
     }
 }
+
+TEST(DualNumber, DualQuaternionSkinning)
+{
+    const int numBones = 8;
+    const int influences = 3;
+    const size_t n = 37;
+
+    Random random;
+
+    DualQuaternion bones[numBones];
+    for (int k = 0; k != numBones - 1; ++k)
+    {
+        bones[k] = rigid(random.rotation(), random.uniformVector3(-2, 2));
+    }
+    // The same transformation as the first bone, from the opposite hemisphere
+    bones[numBones - 1] = mt::makeDual(-real(bones[0]), -dual(bones[0]));
+
+    int indices[n * influences];
+    Scalar weights[n * influences];
+    Vector3 positions[n];
+    Vector3 normals[n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        for (int k = 0; k != influences; ++k)
+        {
+            indices[i * influences + k] = int(random.uniform() * numBones) % numBones;
+            weights[i * influences + k] = random.uniform() + Scalar(0.1);
+        }
+        positions[i] = random.uniformVector3(-1, 1);
+        normals[i] = random.direction();
+    }
+
+    // A 16-byte aligned output stream takes the streaming path, the one after it may not.
+    Vector3 buffer[2][n + 2];
+    Vector3* outPositions = reinterpret_cast<Vector3*>((reinterpret_cast<size_t>(buffer[0]) + 15) & ~size_t(15));
+    Vector3* outNormals = reinterpret_cast<Vector3*>((reinterpret_cast<size_t>(buffer[1]) + 15) & ~size_t(15));
+
+    for (int offset = 0; offset != 2; ++offset)
+    {
+        skin(bones, indices, weights, influences, positions, normals, outPositions + offset, outNormals + offset, n);
+
+        for (size_t i = 0; i != n; ++i)
+        {
+            DualQuaternion q = mt::blend(bones, indices + i * influences, weights + i * influences, influences);
+            testFuzzyEqual(outPositions[offset + i], rigidTransform(q, positions[i]));
+            testFuzzyEqual(outNormals[offset + i], rotation(q)(normals[i]));
+        }
+    }
+
+    // A single influence reproduces the bone's transformation, regardless of its sign or weight. 
+    for (int k = 0; k != 2; ++k)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            indices[i] = k == 0 ? 0 : numBones - 1;
+            weights[i] = k == 0 ? Scalar(0.5) : Scalar(2);
+        }
+        skin(bones, indices, weights, 1, positions, static_cast<const Vector3*>(0), outPositions, static_cast<Vector3*>(0), n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            testFuzzyEqual(outPositions[i], rigidTransform(bones[0], positions[i]));
+        }
+    }
+
+    // Opposite hemispheres do not cancel out.
+    int pair[2] = { 0, numBones - 1 };
+    Scalar halves[2] = { Scalar(0.5), Scalar(0.5) };
+    skin(bones, pair, halves, 2, positions, normals, outPositions, outNormals, 1);
+    testFuzzyEqual(outPositions[0], rigidTransform(bones[0], positions[0]));
+    testFuzzyEqual(outNormals[0], rotation(bones[0])(normals[0]));
+}
+
+TEST(DualNumber, BlendBatches)
+{
+    const int m = 4;
+    const size_t n = 37;
+
+    Random random;
+
+    // The last pose has the transformations of the first one, from the opposite hemisphere.
+    DualQuaternion poses[m][n];
+    Scalar streams[m][8][n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        for (int k = 0; k != m; ++k)
+        {
+            poses[k][i] = k != m - 1 ? rigid(random.rotation(), random.uniformVector3(-2, 2)) : mt::makeDual(-real(poses[0][i]), -dual(poses[0][i]));
+            for (int j = 0; j != 4; ++j)
+            {
+                streams[k][j][i] = real(poses[k][i])[j];
+                streams[k][j + 4][i] = dual(poses[k][i])[j];
+            }
+        }
+    }
+    Scalar weights[m];
+    for (int k = 0; k != m; ++k)
+    {
+        weights[k] = random.uniform() + Scalar(0.1);
+    }
+
+    const Scalar* in[m][8];
+    for (int k = 0; k != m; ++k)
+    {
+        for (int j = 0; j != 8; ++j)
+        {
+            in[k][j] = streams[k][j];
+        }
+    }
+    Scalar blended[8][n];
+    Scalar* out[8];
+    for (int j = 0; j != 8; ++j)
+    {
+        out[j] = blended[j];
+    }
+
+    // Each lane is the blend of the bones with the same index in the poses.
+    mt::blendBatch(in, weights, m, out, n);
+    const int indices[m] = { 0, 1, 2, 3 };
+    for (size_t i = 0; i != n; ++i)
+    {
+        DualQuaternion bones[m];
+        for (int k = 0; k != m; ++k)
+        {
+            bones[k] = poses[k][i];
+        }
+        DualQuaternion q = mt::blend(bones, indices, weights, m);
+        testFuzzyEqual(real(q), Quaternion(blended[0][i], blended[1][i], blended[2][i], blended[3][i]));
+        testFuzzyEqual(dual(q), Quaternion(blended[4][i], blended[5][i], blended[6][i], blended[7][i]));
+    }
+
+    // Blending a pose with its negation reproduces it.
+    const Scalar halves[2] = { Scalar(0.5), Scalar(0.5) };
+    const Scalar* pair[2][8];
+    for (int j = 0; j != 8; ++j)
+    {
+        pair[0][j] = streams[0][j];
+        pair[1][j] = streams[m - 1][j];
+    }
+    mt::blendBatch(pair, halves, 2, out, n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        testFuzzyEqual(real(poses[0][i]), Quaternion(blended[0][i], blended[1][i], blended[2][i], blended[3][i]));
+        testFuzzyEqual(dual(poses[0][i]), Quaternion(blended[4][i], blended[5][i], blended[6][i], blended[7][i]));
+    }
+
+    // The packet form agrees with the array form.
+    mt::Vector4<mt::Dual<Packet4> > p[m];
+    for (int k = 0; k != m; ++k)
+    {
+        p[k] = mt::makeDual(PacketQuaternion(Packet4(streams[k][0]), Packet4(streams[k][1]), Packet4(streams[k][2]), Packet4(streams[k][3])),
+                            PacketQuaternion(Packet4(streams[k][4]), Packet4(streams[k][5]), Packet4(streams[k][6]), Packet4(streams[k][7])));
+    }
+    mt::blendBatch(in, weights, m, out, n);
+    mt::Vector4<mt::Dual<Packet4> > b = mt::blendBatch(p, weights, m);
+    for (int i = 0; i != 4; ++i)
+    {
+        PacketQuaternion u = real(b);
+        PacketQuaternion v = dual(b);
+        testFuzzyEqual(Quaternion(u.x[i], u.y[i], u.z[i], u.w[i]), Quaternion(blended[0][i], blended[1][i], blended[2][i], blended[3][i]));
+        testFuzzyEqual(Quaternion(v.x[i], v.y[i], v.z[i], v.w[i]), Quaternion(blended[4][i], blended[5][i], blended[6][i], blended[7][i]));
+    }
+}
+
+// A function of four inputs that exercises the elementary functions.
+template <typename T>
+T field(const T& x, const T& y, const T& z, const T& w)
+{
+    return sin(x * y) + cos(z) / (T(2) + tanh(w)) + atan2(y, x) * sqrt(z * z + T(1)) + exp(w * T(0.5f)) * log(T(2) + x * x) - pow(T(1.5f) + y * y, w);
+}
+
+TEST(DualNumber, Gradient)
+{
+    Random rnd;
+
+    for (int k = 0; k != 100; ++k)
+    {
+        Scalar x = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar y = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar z = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar w = rnd.uniform(Scalar(-1), Scalar(1));
+
+        // One pass with DualN4 yields the same gradient as four passes with Dual.
+        DualN4 f = field(mt::variable<4>(x, 0), mt::variable<4>(y, 1), mt::variable<4>(z, 2), mt::variable<4>(w, 3));
+
+        EXPECT_NEAR(f.real(), field(x, y, z, w), Scalar(1e-5));
+        EXPECT_NEAR(f.dual(0), dual(field(Dual(x, 1), Dual(y), Dual(z), Dual(w))), Scalar(1e-5));
+        EXPECT_NEAR(f.dual(1), dual(field(Dual(x), Dual(y, 1), Dual(z), Dual(w))), Scalar(1e-5));
+        EXPECT_NEAR(f.dual(2), dual(field(Dual(x), Dual(y), Dual(z, 1), Dual(w))), Scalar(1e-5));
+        EXPECT_NEAR(f.dual(3), dual(field(Dual(x), Dual(y), Dual(z), Dual(w, 1))), Scalar(1e-5));
+
+        // Unused inputs have zero partial derivatives.
+        DualN8 g = field(mt::variable<8>(x, 0), mt::variable<8>(y, 1), mt::variable<8>(z, 2), mt::variable<8>(w, 3));
+        for (int i = 0; i != 4; ++i)
+        {
+            EXPECT_NEAR(g.dual(i), f.dual(i), Scalar(1e-5));
+            EXPECT_EQ(g.dual(4 + i), Scalar());
+        }
+    }
+
+    // The Jacobian of a vector function is the dual parts of its elements. For v -> q v q*, it is the rotation matrix.
+    for (int k = 0; k != 10; ++k)
+    {
+        Quaternion q = rnd.rotation();
+        Vector3 v = rnd.uniformVector3(Scalar(-1), Scalar(1));
+
+        mt::Vector3<DualN3> u(mt::variable<3>(v.x, 0), mt::variable<3>(v.y, 1), mt::variable<3>(v.z, 2));
+        mt::Vector4<DualN3> p(DualN3(q.x), DualN3(q.y), DualN3(q.z), DualN3(q.w));
+        mt::Vector3<DualN3> r = mul(mt::Matrix3x3<DualN3>(p), u);
+
+        Matrix3x3 m(q);
+        testFuzzyEqual(Vector3(r.x.real(), r.y.real(), r.z.real()), mul(m, v));
+        for (int i = 0; i != 3; ++i)
+        {
+            testFuzzyEqual(Vector3(r[i].dual(0), r[i].dual(1), r[i].dual(2)), m[i]);
+        }
+    }
+}
+
+TEST(DualNumber, ReverseMode)
+{
+    Random rnd;
+    Tape tape(1024);
+    size_t capacity = 0;
+
+    for (int k = 0; k != 100; ++k)
+    {
+        Scalar x = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar y = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar z = rnd.uniform(Scalar(-1), Scalar(1));
+        Scalar w = rnd.uniform(Scalar(-1), Scalar(1));
+
+        // One backward sweep yields the same gradient as a forward pass with DualN4.
+        tape.clear();
+        Reverse a = tape.variable(x);
+        Reverse b = tape.variable(y);
+        Reverse c = tape.variable(z);
+        Reverse d = tape.variable(w);
+        Reverse f = field(a, b, c, d);
+        tape.gradient(f);
+
+        DualN4 g = field(mt::variable<4>(x, 0), mt::variable<4>(y, 1), mt::variable<4>(z, 2), mt::variable<4>(w, 3));
+
+        EXPECT_NEAR(f.value(), g.real(), Scalar(1e-5));
+        EXPECT_NEAR(adjoint(a), g.dual(0), Scalar(1e-5));
+        EXPECT_NEAR(adjoint(b), g.dual(1), Scalar(1e-5));
+        EXPECT_NEAR(adjoint(c), g.dual(2), Scalar(1e-5));
+        EXPECT_NEAR(adjoint(d), g.dual(3), Scalar(1e-5));
+
+        // The tape keeps its memory when cleared, so every evaluation after the first records without allocating.
+        if (k == 0)
+        {
+            capacity = tape.capacity();
+        }
+        EXPECT_EQ(tape.capacity(), capacity);
+    }
+
+    // Constants are not recorded, and a sweep for another output resets the adjoints.
+    tape.clear();
+    Reverse x = tape.variable(Scalar(2));
+    Reverse y = tape.variable(Scalar(3));
+    Reverse c = Reverse(Scalar(4)) * Reverse(Scalar(5));
+    EXPECT_EQ(tape.size(), size_t(2));
+    Reverse f = x * y + c;
+    Reverse g = x * x;
+    tape.gradient(f);
+    EXPECT_EQ(adjoint(x), Scalar(3));
+    EXPECT_EQ(adjoint(y), Scalar(2));
+    tape.gradient(g);
+    EXPECT_EQ(adjoint(x), Scalar(4));
+    EXPECT_EQ(adjoint(y), Scalar());
+}
@@ -44,3 +44,517 @@ TEST(Matrix, Matrix4x3)
     Vector3 rx4 = mul(q, xsi);
     testFuzzyEqual(Vector3(Zero()), rx4);
 }
+
+Matrix4x4 randomMatrix(Random& random)
+{
+    Matrix4x4 a;
+    for (int i = 0; i != 4; ++i)
+    {
+        for (int j = 0; j != 4; ++j)
+        {
+            a[i][j] = random.uniform() * Scalar(2) - Scalar(1);
+        }
+    }
+    // Diagonally dominant, so it is well-conditioned
+    return a + Matrix4x4(Scalar(3));
+}
+
+TEST(Matrix, Matrix4x4)
+{
+    Random random;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        Matrix4x4 a = randomMatrix(random);
+        Matrix4x4 b = randomMatrix(random);
+
+        // Explicit template arguments select the generic versions.
+        testFuzzyEqual(mt::mul<Scalar>(a, b), mul(a, b));
+        testFuzzyEqual(mt::transposeMul<Scalar>(a, b), transposeMul(a, b));
+        testFuzzyEqual(mt::mulTranspose<Scalar>(a, b), mulTranspose(a, b));
+        EXPECT_NEAR(mt::determinant<Scalar>(a), determinant(a), mt::abs(determinant(a)) * Scalar(1e-5));
+        testFuzzyEqual(mt::adjoint<Scalar>(a) / determinant(a), adjoint(a) / determinant(a));
+        testFuzzyEqual(mt::inverse<Scalar>(a), inverse(a));
+        testFuzzyEqual(Matrix4x4(Identity()), mul(a, inverse(a)));
+
+        Matrix4x4 xform(Matrix3x3(random.rotation()), random.uniformVector3() * Scalar(10));
+        xform[3] = Vector4(Scalar(1), Scalar(2), Scalar(3), Scalar(4));
+        testFuzzyEqual(mt::inverseOrthogonal<Scalar>(xform), inverseOrthogonal(xform));
+        testFuzzyEqual(Vector4(Identity()), inverseOrthogonal(xform)[3]);
+
+        Matrix4x4 affine = xform;
+        affine.setBasis(basis(a));
+        testFuzzyEqual(mt::inverseAffine<Scalar>(affine), inverseAffine(affine));
+        affine[3] = Vector4(Identity());
+        testFuzzyEqual(Matrix4x4(Identity()), mul(affine, inverseAffine(affine)));
+    }
+}
+
+TEST(Matrix, Matrix3x3)
+{
+    Random random;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        Matrix4x4 m = randomMatrix(random);
+        Matrix3x3 a = basis(m);
+        Matrix3x3 b = basis(randomMatrix(random));
+        Vector3 v = random.uniformVector3();
+
+        // Explicit template arguments select the generic versions.
+        testFuzzyEqual(mt::mul<Scalar, Scalar>(a, v), mul(a, v));
+        testFuzzyEqual(mt::mul<Scalar, Scalar>(v, a), mul(v, a));
+        testFuzzyEqual(mt::mul<Scalar, Scalar>(a, b), mul(a, b));
+        testFuzzyEqual(mt::transposeMul<Scalar, Scalar>(a, b), transposeMul(a, b));
+        testFuzzyEqual(mt::mulTranspose<Scalar, Scalar>(a, b), mulTranspose(a, b));
+        testFuzzyEqual(mt::transpose<Scalar>(a), transpose(a));
+        EXPECT_NEAR(mt::determinant<Scalar>(a), determinant(a), mt::abs(determinant(a)) * Scalar(1e-5));
+        testFuzzyEqual(mt::inverse<Scalar>(a), inverse(a));
+        testFuzzyEqual(Matrix3x3(Identity()), mul(a, inverse(a)));
+        testFuzzyEqual(mt::solve<Scalar>(a, v), solve(a, v));
+        testFuzzyEqual(mt::solveTranspose<Scalar>(a, v), solveTranspose(a, v));
+        testFuzzyEqual(mt::orthonormalize<Scalar>(a), orthonormalize(a));
+
+        Matrix3x3 spd = mulTranspose(a, a);
+        testFuzzyEqual(mt::cholesky<Scalar>(spd), cholesky(spd));
+        testFuzzyEqual(spd, mulTranspose(cholesky(spd), cholesky(spd)));
+
+        Matrix3x3 r(random.rotation());
+        testFuzzyEqual(mt::rotation<Scalar>(r), rotation(r));
+        testFuzzyEqual(r, Matrix3x3(rotation(r)));
+    }
+}
+
+TEST(Matrix, Matrix3x4)
+{
+    Random random;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        Matrix4x4 m = randomMatrix(random);
+        Matrix3x4 a(m[0], m[1], m[2]);
+        Matrix3x4 b(Matrix3x3(random.rotation()), random.uniformVector3() * Scalar(10));
+
+        testFuzzyEqual(mt::mul<Scalar>(a, b), mul(a, b));
+        testFuzzyEqual(mt::inverse<Scalar>(a), inverse(a));
+        testFuzzyEqual(Matrix3x4(Identity()), mul(a, inverse(a)));
+        testFuzzyEqual(mt::inverseOrthogonal<Scalar>(b), inverseOrthogonal(b));
+        testFuzzyEqual(Matrix3x4(Identity()), mul(b, inverseOrthogonal(b)));
+    }
+
+    const int parents[] = { -1, 0, 1, 1, -1, 4, 3 };
+    const size_t count = sizeof(parents) / sizeof(int);
+
+    Matrix3x4 locals[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        locals[i] = Matrix3x4(Matrix3x3(random.rotation()), random.uniformVector3());
+    }
+
+    Matrix3x4 world[count];
+    concatenateHierarchy(parents, locals, world, count);
+
+    Matrix3x4 expected[count];
+    mt::concatenateHierarchy<Scalar>(parents, locals, expected, count);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        testFuzzyEqual(expected[i], world[i]);
+    }
+    testFuzzyEqual(mt::mul<Scalar>(mt::mul<Scalar>(locals[0], locals[1]), mt::mul<Scalar>(locals[3], locals[6])), world[6]);
+}
+
+template <typename T>
+T* alignedPointer(T* p)
+{
+    return reinterpret_cast<T*>((reinterpret_cast<size_t>(p) + 15) & ~size_t(15));
+}
+
+TEST(Matrix, BulkTransforms)
+{
+    Random random;
+
+    Matrix4x4 m = randomMatrix(random);
+    Matrix3x4 a(m[0], m[1], m[2]);
+
+    const size_t n = 37;
+
+    Vector3 points[n];
+    Vector4 vectors[n];
+    Vector4 planes[n];
+    Scalar coords[4][n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        points[i] = random.uniformVector3(-1, 1);
+        vectors[i] = Vector4(points[i], random.uniform());
+        planes[i] = Vector4(random.direction(), random.uniform());
+        coords[0][i] = vectors[i].x;
+        coords[1][i] = vectors[i].y;
+        coords[2][i] = vectors[i].z;
+        coords[3][i] = vectors[i].w;
+    }
+
+    Vector3 expected3[n];
+    Vector4 expected4[n];
+    Vector4 out4[n];
+    Vector3 buffer3[n + 3];
+    Scalar buffer[4][n + 5];
+
+    // Offset 0 in the aligned buffers takes the non-temporal path, offset 1 falls back to regular stores. 
+    for (int offset = 0; offset != 2; ++offset)
+    {
+        for (int nonTemporal = 0; nonTemporal != 2; ++nonTemporal)
+        {
+            Vector3* out3 = alignedPointer(buffer3) + offset;
+            Scalar* out[4];
+            for (int j = 0; j != 4; ++j)
+            {
+                out[j] = alignedPointer(buffer[j]) + offset;
+            }
+
+            mt::transformPoints<Scalar>(a, points, expected3, n);
+            transformPoints(a, points, out3, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected3[i], out3[i]);
+                testFuzzyEqual(mul(a, Vector4(points[i], 1)), out3[i]);
+            }
+            transformPoints(a, coords[0], coords[1], coords[2], out[0], out[1], out[2], n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected3[i], Vector3(out[0][i], out[1][i], out[2][i]));
+            }
+
+            mt::transformVectors<Scalar>(a, points, expected3, n);
+            transformVectors(a, points, out3, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected3[i], out3[i]);
+                testFuzzyEqual(mul(basis(a), points[i]), out3[i]);
+            }
+            transformVectors(a, coords[0], coords[1], coords[2], out[0], out[1], out[2], n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected3[i], Vector3(out[0][i], out[1][i], out[2][i]));
+            }
+
+            mt::transformPlanes<Scalar>(a, planes, expected4, n);
+            transformPlanes(a, planes, out4, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], out4[i]);
+                // A transformed point lies on the transformed plane at the same distance.
+                EXPECT_NEAR(dot(planes[i], Vector4(points[i], 1)), dot(out4[i], Vector4(mul(a, Vector4(points[i], 1)), 1)), Scalar(1e-4));
+            }
+
+            mt::transformPoints<Scalar>(m, points, expected4, n);
+            transformPoints(m, points, out4, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], out4[i]);
+                testFuzzyEqual(mul(m, Vector4(points[i], 1)), out4[i]);
+            }
+            transformPoints(m, coords[0], coords[1], coords[2], out[0], out[1], out[2], out[3], n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], Vector4(out[0][i], out[1][i], out[2][i], out[3][i]));
+            }
+
+            mt::transformVectors<Scalar>(m, vectors, expected4, n);
+            transformVectors(m, vectors, out4, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], out4[i]);
+                testFuzzyEqual(mul(m, vectors[i]), out4[i]);
+            }
+            transformVectors(m, coords[0], coords[1], coords[2], coords[3], out[0], out[1], out[2], out[3], n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], Vector4(out[0][i], out[1][i], out[2][i], out[3][i]));
+            }
+
+            mt::transformPlanes<Scalar>(m, planes, expected4, n);
+            transformPlanes(m, planes, out4, n, nonTemporal != 0);
+            for (size_t i = 0; i != n; ++i)
+            {
+                testFuzzyEqual(expected4[i], out4[i]);
+            }
+        }
+    }
+}
+
+// The policy only affects the reciprocal of the determinant, so each row of the inverse is off by
+// the relative error of the policy's reciprocal, on top of the float rounding that the double
+// precision reference shows.
+template <typename Policy>
+void testInversePrecision(Random& random, Policy p, Scalar tolerance)
+{
+    typedef mt::Vector3<double> Vector3d;
+    typedef mt::Vector4<double> Vector4d;
+    typedef mt::Matrix3x3<double> Matrix3x3d;
+    typedef mt::Matrix3x4<double> Matrix3x4d;
+    typedef mt::Matrix4x4<double> Matrix4x4d;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        Matrix4x4 m = randomMatrix(random);
+        Matrix3x3 a = basis(m);
+        Matrix3x4 b(a, random.uniformVector3());
+        Quaternion q = random.rotation() * Scalar(2);
+
+        Matrix3x3d ad = inverse(Matrix3x3d(Vector3d(a[0]), Vector3d(a[1]), Vector3d(a[2])));
+        Matrix3x4d bd = inverse(Matrix3x4d(Vector4d(b[0]), Vector4d(b[1]), Vector4d(b[2])));
+        Matrix4x4d md = inverse(Matrix4x4d(Vector4d(m[0]), Vector4d(m[1]), Vector4d(m[2]), Vector4d(m[3])));
+        Vector4d qd = inverse(Vector4d(q));
+
+        for (int j = 0; j != 3; ++j)
+        {
+            EXPECT_LE(length(Vector3d(inverse(a, p)[j]) - ad[j]), tolerance * length(ad[j]));
+            EXPECT_LE(length(Vector4d(inverse(b, p)[j]) - bd[j]), tolerance * length(bd[j]));
+        }
+        for (int j = 0; j != 4; ++j)
+        {
+            EXPECT_LE(length(Vector4d(inverse(m, p)[j]) - md[j]), tolerance * length(md[j]));
+        }
+        EXPECT_LE(length(Vector4d(inverse(q, p)) - qd), tolerance * length(qd));
+    }
+}
+
+TEST(Matrix, Precision)
+{
+    Random random;
+    testInversePrecision(random, mt::Exact(), Scalar(1) / (1 << 21));
+    testInversePrecision(random, mt::FastRefined(), Scalar(1) / (1 << 19));
+    testInversePrecision(random, mt::Fast(), Scalar(1.5) / (1 << 12));
+}
+
+void testSVD(const Matrix3x3& a)
+{
+    Matrix3x3 u, v;
+    Vector3 sigma;
+    svd(a, u, sigma, v);
+
+    Scalar scale = std::max(abs(sigma.x), Scalar(1));
+    Scalar tolerance = Scalar(1e-5) * scale;
+    Matrix3x3 usv = mulTranspose(mul(u, diag(sigma)), v);
+    for (int i = 0; i != 3; ++i)
+    {
+        EXPECT_LE(length(usv[i] - a[i]), tolerance);
+    }
+
+    // u and v are rotations, and sigma is sorted by decreasing magnitude with its sign on the last element.
+    testFuzzyEqual(transposeMul(u, u), Matrix3x3(Identity()));
+    testFuzzyEqual(transposeMul(v, v), Matrix3x3(Identity()));
+    EXPECT_NEAR(determinant(u), Scalar(1), Scalar(1e-5));
+    EXPECT_NEAR(determinant(v), Scalar(1), Scalar(1e-5));
+    EXPECT_GE(sigma.x, sigma.y - tolerance);
+    EXPECT_GE(sigma.y, abs(sigma.z) - tolerance);
+    EXPECT_NEAR(sigma.x * sigma.y * sigma.z, determinant(a), Scalar(1e-4) * scale * scale * scale);
+
+    // r is the rotation nearest to a, and s is symmetric.
+    Matrix3x3 r, s;
+    polar(a, r, s);
+    testFuzzyEqual(transposeMul(r, r), Matrix3x3(Identity()));
+    testFuzzyEqual(s, transpose(s));
+    Matrix3x3 rs = mul(r, s);
+    for (int i = 0; i != 3; ++i)
+    {
+        EXPECT_LE(length(rs[i] - a[i]), tolerance);
+    }
+}
+
+TEST(Matrix, SVD)
+{
+    Random random;
+
+    for (int i = 0; i != 200; ++i)
+    {
+        Matrix3x3 a;
+        for (int j = 0; j != 3; ++j)
+        {
+            a[j] = random.uniformVector3(Scalar(-2), Scalar(2));
+        }
+        testSVD(a);
+
+        // Rotations, reflections, and degenerate matrices of rank 2, 1 and 0.
+        Matrix3x3 q(random.rotation());
+        testSVD(q);
+        testSVD(mul(q, Matrix3x3(Scalar(1), Scalar(0), Scalar(0), Scalar(0), Scalar(1), Scalar(0), Scalar(0), Scalar(0), Scalar(-1))));
+        testSVD(dyad(a[0], a[1]) + dyad(a[1], a[2]));
+        testSVD(dyad(a[0], a[1]));
+    }
+    testSVD(Matrix3x3(Zero()));
+    testSVD(Matrix3x3(Identity()));
+    testSVD(Matrix3x3(Scalar(2), Scalar(0), Scalar(0), Scalar(0), Scalar(2), Scalar(0), Scalar(0), Scalar(0), Scalar(1)));
+
+    // The rotation nearest to a rotated stretch is the rotation.
+    for (int i = 0; i != 100; ++i)
+    {
+        Matrix3x3 q(random.rotation());
+        Matrix3x3 r, s;
+        polar(mul(q, diag(random.uniformVector3(Scalar(0.5), Scalar(2)))), r, s);
+        testFuzzyEqual(r, q);
+    }
+
+    // The packet version agrees with the scalar one lane by lane. The singular vectors of the degenerate
+    // lane are not unique, so the lanes are compared by their products.
+    PacketMatrix3x3 pa;
+    Matrix3x3 a[4];
+    for (int k = 0; k != 4; ++k)
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            a[k][j] = random.uniformVector3(Scalar(-2), Scalar(2));
+        }
+    }
+    a[3] = dyad(a[3][0], a[3][1]);
+    for (int i = 0; i != 3; ++i)
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            for (int k = 0; k != 4; ++k)
+            {
+                pa[i][j][k] = a[k][i][j];
+            }
+        }
+    }
+    PacketMatrix3x3 pu, pv;
+    PacketVector3 psigma;
+    svd(pa, pu, psigma, pv);
+    for (int k = 0; k != 4; ++k)
+    {
+        Matrix3x3 u, v;
+        Vector3 sigma;
+        svd(a[k], u, sigma, v);
+        testFuzzyEqual(Vector3(psigma.x[k], psigma.y[k], psigma.z[k]), sigma);
+
+        Matrix3x3 lu, lv;
+        for (int i = 0; i != 3; ++i)
+        {
+            lu[i] = Vector3(pu[i].x[k], pu[i].y[k], pu[i].z[k]);
+            lv[i] = Vector3(pv[i].x[k], pv[i].y[k], pv[i].z[k]);
+        }
+        testFuzzyEqual(transposeMul(lu, lu), Matrix3x3(Identity()));
+        testFuzzyEqual(transposeMul(lv, lv), Matrix3x3(Identity()));
+        testFuzzyEqual(mulTranspose(mul(lu, diag(sigma)), lv), a[k]);
+    }
+}
+
+TEST(Matrix, BatchedSolve)
+{
+    Random random;
+
+    // Systems 0 mod 5 are not positive definite, 1 mod 5 are singular but semidefinite, 2 mod 5 are indefinite.
+    const size_t n = 37;
+    std::vector<Matrix3x3> a(n);
+    std::vector<Vector3> b(n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        Matrix3x3 m;
+        for (int j = 0; j != 3; ++j)
+        {
+            m[j] = random.uniformVector3(Scalar(-1), Scalar(1));
+        }
+        switch (i % 5)
+        {
+        case 0:
+            a[i] = -transposeMul(m, m);
+            break;
+        case 1:
+            a[i] = dyad(m[0], m[0]) + dyad(m[1], m[1]);
+            break;
+        case 2:
+            a[i] = Matrix3x3(Scalar(2), Scalar(1), Scalar(0), Scalar(1), Scalar(-3), Scalar(1), Scalar(0), Scalar(1), Scalar(4)) + Matrix3x3(m[2].x * Scalar(0.1));
+            break;
+        default:
+            a[i] = transposeMul(m, m) + Matrix3x3(Scalar(0.5));
+        }
+        // Consistent right-hand sides for the singular systems
+        b[i] = mul(a[i], random.uniformVector3(Scalar(-1), Scalar(1)));
+    }
+
+    std::vector<Scalar> streams[6 + 3 + 6 + 3 + 3 + 3];
+    for (int k = 0; k != 24; ++k)
+    {
+        streams[k].resize(n);
+    }
+    const int rows[6] = { 0, 1, 1, 2, 2, 2 };
+    const int cols[6] = { 0, 0, 1, 0, 1, 2 };
+    for (size_t i = 0; i != n; ++i)
+    {
+        for (int k = 0; k != 6; ++k)
+        {
+            streams[k][i] = a[i][rows[k]][cols[k]];
+        }
+        for (int k = 0; k != 3; ++k)
+        {
+            streams[6 + k][i] = b[i][k];
+        }
+    }
+    const Scalar* pa[6];
+    Scalar* pl[6];
+    const Scalar* pb[3];
+    Scalar* px[3];
+    Scalar* pd[3];
+    for (int k = 0; k != 6; ++k)
+    {
+        pa[k] = &streams[k][0];
+        pl[k] = &streams[9 + k][0];
+    }
+    for (int k = 0; k != 3; ++k)
+    {
+        pb[k] = &streams[6 + k][0];
+        px[k] = &streams[15 + k][0];
+        pd[k] = &streams[18 + k][0];
+    }
+
+    uint32_t flags[2];
+    mt::cholesky(pa, pl, flags, n);
+    mt::choleskySolve(pl, pb, px, n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        bool failed = ((flags[i / 32] >> (i % 32)) & 1) != 0;
+        Vector3 x(px[0][i], px[1][i], px[2][i]);
+        if (i % 5 == 3 || i % 5 == 4)
+        {
+            EXPECT_FALSE(failed);
+            testFuzzyEqual(mul(a[i], x), b[i]);
+            testFuzzyEqual(x, solve(a[i], b[i]));
+
+            Matrix3x3 l = cholesky(a[i]);
+            for (int k = 0; k != 6; ++k)
+            {
+                EXPECT_NEAR(pl[k][i], l[rows[k]][cols[k]], Scalar(1e-5));
+            }
+        }
+        else if (i % 5 != 1)
+        {
+            // A rank-2 lane may pass with a tiny last pivot, so only the definitely failing lanes are checked.
+            EXPECT_TRUE(failed);
+            EXPECT_EQ(x, Vector3(Zero()));
+        }
+    }
+
+    // LDL^T solves the positive definite and indefinite systems, and flags and solves the consistent singular ones.
+    mt::ldlt(pa, pl, pd, flags, n);
+    mt::ldltSolve(pl, pd, pb, px, n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        bool degenerate = ((flags[i / 32] >> (i % 32)) & 1) != 0;
+        Vector3 x(px[0][i], px[1][i], px[2][i]);
+        EXPECT_EQ(degenerate, i % 5 == 1);
+        EXPECT_LE(length(mul(a[i], x) - b[i]), Scalar(1e-4) * std::max(length(b[i]), Scalar(1)));
+    }
+
+    // The solution may overwrite the right-hand side.
+    for (int k = 0; k != 3; ++k)
+    {
+        streams[21 + k] = streams[6 + k];
+        px[k] = &streams[21 + k][0];
+    }
+    mt::ldltSolve(pl, pd, const_cast<const Scalar* const*>(px), px, n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        EXPECT_LE(length(mul(a[i], Vector3(px[0][i], px[1][i], px[2][i])) - b[i]), Scalar(1e-4) * std::max(length(b[i]), Scalar(1)));
+    }
+}
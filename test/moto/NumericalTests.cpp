@@ -8,10 +8,17 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "moto/Scalar.hpp"
 #include "moto/ErrorTracer.hpp"
 #include "moto/Vector3.hpp"
 #include "moto/Metric.hpp"
+#include "moto/Precision.hpp"
+#include "moto/Interval.hpp"
+#include "moto/Random.hpp"
+#include "moto/Philox.hpp"
+#include "moto/Sobol.hpp"
 
 typedef mt::ErrorTracer<float> Scalar;
 typedef mt::Vector3<Scalar> Vector3;
@@ -107,3 +114,374 @@ TEST(Numerical, OrderOfOperations)
     
     EXPECT_LT(r1, r2);
 }
+
+template <typename Policy>
+void testPrecision(Policy p, float tolerance)
+{
+    // Sweeps over several binades, including odd and even exponents for rsqrt.
+    for (float a = 1e-3f; a < 1e3f; a *= 1.0137f)
+    {
+        EXPECT_NEAR(1.0, double(mt::rcp(a, p)) * double(a), tolerance);
+        EXPECT_NEAR(1.0, double(mt::rsqrt(a, p)) * std::sqrt(double(a)), tolerance);
+        EXPECT_NEAR(1.0, double(mt::div(3.0f, a, p)) * double(a) / 3.0, tolerance);
+    }
+
+    mt::Vector3<float> v(3.0f, -4.0f, 12.0f);
+    EXPECT_NEAR(1.0f, length(normalize(v, p)), tolerance);
+    EXPECT_NEAR(1.0f, length(nlerp(v, mt::Vector3<float>(-2.0f, 6.0f, 3.0f), 0.3f, p)), tolerance);
+}
+
+TEST(Numerical, Precision)
+{
+    testPrecision(mt::Exact(), 1e-7f);
+    testPrecision(mt::FastRefined(), 1.0f / (1 << 20));
+    testPrecision(mt::Fast(), 1.5f / (1 << 12));
+
+    // Exact is the policy of the overloads without one.
+    mt::Vector3<float> v(1.0f, 2.0f, 3.0f);
+    EXPECT_EQ(normalize(v), normalize(v, mt::Exact()));
+    EXPECT_EQ(1.0f / 7.0f, mt::rcp(7.0f, mt::Exact()));
+}
+
+typedef mt::Interval<float> FloatInterval;
+typedef mt::Interval<double> DoubleInterval;
+
+FloatInterval randomInterval(mt::Random<float>& random)
+{
+    return mt::hull(random.uniform(-4.0f, 4.0f), random.uniform(-4.0f, 4.0f));
+}
+
+// The bounds enclose the exact result, which is the double interval since the products and sums of
+// the bounds are exact or correctly rounded in double precision.
+void testEnclosure(const DoubleInterval& exact, const FloatInterval& z, bool outward)
+{
+    if (outward)
+    {
+        EXPECT_LE(double(z.lower()), exact.lower());
+        EXPECT_GE(double(z.upper()), exact.upper());
+    }
+    EXPECT_NEAR(exact.lower(), double(z.lower()), 1e-6);
+    EXPECT_NEAR(exact.upper(), double(z.upper()), 1e-6);
+}
+
+void testIntervals(bool outward)
+{
+    mt::Random<float> random;
+    for (int i = 0; i != 1000; ++i)
+    {
+        FloatInterval a = randomInterval(random);
+        FloatInterval b = randomInterval(random);
+        float x = random.uniform(-4.0f, 4.0f);
+        DoubleInterval da(a);
+        DoubleInterval db(b);
+
+        testEnclosure(da + db, a + b, outward);
+        testEnclosure(da - db, a - b, outward);
+        testEnclosure(da * db, a * b, outward);
+        testEnclosure(da * double(x), a * x, outward);
+        testEnclosure(double(x) - da, x - a, outward);
+        testEnclosure(-da, -a, outward);
+        testEnclosure(hull(da, db), hull(a, b), outward);
+
+        EXPECT_EQ(overlap(da, db), overlap(a, b));
+        EXPECT_EQ(subset(da, db), subset(a, b));
+        EXPECT_EQ(in(double(x), da), in(x, a));
+        EXPECT_TRUE(subset(a, hull(a, b)));
+    }
+}
+
+TEST(Numerical, Interval)
+{
+    testIntervals(false);
+
+#if USE_SSE_INTERVAL
+    {
+        mt::ScopedRoundUp guard;
+        testIntervals(true);
+
+        // Both bounds of an inexact sum are rounded outward.
+        volatile float tenth = 0.1f;
+        FloatInterval z = FloatInterval(tenth) + FloatInterval(0.2f);
+        EXPECT_LT(z.lower(), z.upper());
+    }
+
+    // The packed layout is described as a four-element record.
+    EXPECT_EQ(size_t(16), sizeof(FloatInterval));
+    EXPECT_EQ(int(TT_FLOAT4), int(guts::TypeTraits<FloatInterval>::ID));
+#else
+    EXPECT_EQ(int(TT_FLOAT2), int(guts::TypeTraits<FloatInterval>::ID));
+#endif
+
+#if USE_SSE
+    // The guard restores the rounding mode.
+    EXPECT_EQ(_MM_ROUND_NEAREST, int(_MM_GET_ROUNDING_MODE()));
+#endif
+}
+
+TEST(Numerical, Philox)
+{
+    // Known-answer tests of Philox4x32-10 from Random123
+    {
+        const uint32_t counter[4] = { 0, 0, 0, 0 };
+        const uint32_t key[2] = { 0, 0 };
+        const uint32_t expected[4] = { 0x6627e8d5UL, 0xe169c58dUL, 0xbc57ac4cUL, 0x9b00dbd8UL };
+        uint32_t result[4];
+        mt::philox4x32(counter, key, result);
+        for (int w = 0; w != 4; ++w)
+        {
+            EXPECT_EQ(expected[w], result[w]);
+        }
+    }
+    {
+        const uint32_t counter[4] = { 0xffffffffUL, 0xffffffffUL, 0xffffffffUL, 0xffffffffUL };
+        const uint32_t key[2] = { 0xffffffffUL, 0xffffffffUL };
+        const uint32_t expected[4] = { 0x408f276dUL, 0x41c83b0eUL, 0xa20bc7c6UL, 0x6d5451fdUL };
+        uint32_t result[4];
+        mt::philox4x32(counter, key, result);
+        for (int w = 0; w != 4; ++w)
+        {
+            EXPECT_EQ(expected[w], result[w]);
+        }
+    }
+    {
+        const uint32_t counter[4] = { 0x243f6a88UL, 0x85a308d3UL, 0x13198a2eUL, 0x03707344UL };
+        const uint32_t key[2] = { 0xa4093822UL, 0x299f31d0UL };
+        const uint32_t expected[4] = { 0xd16cfe09UL, 0x94fdccebUL, 0x5001e420UL, 0x24126ea1UL };
+        uint32_t result[4];
+        mt::philox4x32(counter, key, result);
+        for (int w = 0; w != 4; ++w)
+        {
+            EXPECT_EQ(expected[w], result[w]);
+        }
+    }
+
+    // The lanes of next() are the blocks of consecutive counters, also across the 32-bit boundary.
+    {
+        const uint64_t seed = 0x299f31d0a4093822ULL;
+        const uint64_t stream = 7;
+        const uint64_t start = 0xfffffffeULL;
+        mt::Philox rng(seed, stream);
+        rng.setCounter(start);
+        uint32_t bits[16];
+        rng.next(bits);
+        EXPECT_EQ(start + 4, rng.counter());
+        const uint32_t key[2] = { uint32_t(seed), uint32_t(seed >> 32) };
+        for (int b = 0; b != 4; ++b)
+        {
+            const uint32_t counter[4] = { uint32_t(start + b), uint32_t((start + b) >> 32), uint32_t(stream), 0 };
+            uint32_t result[4];
+            mt::philox4x32(counter, key, result);
+            for (int w = 0; w != 4; ++w)
+            {
+                EXPECT_EQ(result[w], bits[4 * w + b]);
+            }
+        }
+    }
+
+    const size_t n = 1001;
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+
+    // Streams are reproducible, can be read from any position, and differ from each other.
+    {
+        mt::Philox rng1(42, 3);
+        mt::Philox rng2(42, 3);
+        mt::Philox rng3(42, 4);
+        rng1.uniform(&x[0], n);
+        rng2.setCounter(rng1.counter());
+        rng1.uniform(&x[0], n);
+        rng2.uniform(&y[0], n);
+        EXPECT_EQ(x, y);
+        rng3.setCounter(rng2.counter() - 4 * ((n + 15) / 16));
+        rng3.uniform(&y[0], n);
+        size_t equal = 0;
+        for (size_t i = 0; i != n; ++i)
+        {
+            equal += x[i] == y[i] ? 1 : 0;
+        }
+        EXPECT_LT(equal, size_t(4));
+    }
+
+    // Uniforms in [a, b) have the right mean and variance.
+    {
+        mt::Philox rng;
+        rng.uniform(&x[0], n, -2.0f, 3.0f);
+        double sum = 0;
+        double sum2 = 0;
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_LE(-2.0f, x[i]);
+            EXPECT_GT(3.0f, x[i]);
+            sum += x[i];
+            sum2 += double(x[i]) * x[i];
+        }
+        double mean = sum / n;
+        double variance = sum2 / n - mean * mean;
+        EXPECT_NEAR(0.5, mean, 0.15);
+        EXPECT_NEAR(25.0 / 12.0, variance, 0.2);
+    }
+
+    // Directions and rotations are unit vectors and average out to zero.
+    {
+        mt::Philox rng(1234, 1);
+        std::vector<float> v[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        float* const p[4] = { &v[0][0], &v[1][0], &v[2][0], &v[3][0] };
+
+        rng.direction(p, n);
+        double mean[4] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_NEAR(1.0f, v[0][i] * v[0][i] + v[1][i] * v[1][i] + v[2][i] * v[2][i], 1e-5f);
+            for (int k = 0; k != 3; ++k)
+            {
+                mean[k] += v[k][i] / n;
+            }
+        }
+        for (int k = 0; k != 3; ++k)
+        {
+            EXPECT_NEAR(0.0, mean[k], 0.1);
+        }
+
+        rng.rotation(p, n);
+        for (int k = 0; k != 4; ++k)
+        {
+            mean[k] = 0;
+        }
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_NEAR(1.0f, v[0][i] * v[0][i] + v[1][i] * v[1][i] + v[2][i] * v[2][i] + v[3][i] * v[3][i], 1e-5f);
+            for (int k = 0; k != 4; ++k)
+            {
+                mean[k] += v[k][i] / n;
+            }
+        }
+        for (int k = 0; k != 4; ++k)
+        {
+            EXPECT_NEAR(0.0, mean[k], 0.1);
+        }
+
+        rng.uniformVector3(p, n, -1.0f, 1.0f);
+        for (size_t i = 0; i != n; ++i)
+        {
+            for (int k = 0; k != 3; ++k)
+            {
+                EXPECT_LE(-1.0f, v[k][i]);
+                EXPECT_GT(1.0f, v[k][i]);
+            }
+        }
+    }
+}
+
+// Checks that the 2^m points of x and y have exactly one point in each box of area 2^-m.
+void testNet(const float* x, const float* y, int m)
+{
+    const size_t n = size_t(1) << m;
+    for (int p = 0; p <= m; ++p)
+    {
+        std::vector<int> count(n, 0);
+        for (size_t i = 0; i != n; ++i)
+        {
+            size_t a = size_t(x[i] * float(1 << p));
+            size_t b = size_t(y[i] * float(1 << (m - p)));
+            ++count[(a << (m - p)) | b];
+        }
+        for (size_t k = 0; k != n; ++k)
+        {
+            EXPECT_EQ(1, count[k]);
+        }
+    }
+}
+
+TEST(Numerical, Sobol)
+{
+    const int m = 10;
+    const size_t n = size_t(1) << m;
+    std::vector<float> v[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+    float* const p[4] = { &v[0][0], &v[1][0], &v[2][0], &v[3][0] };
+
+    // The first two dimensions are a (0, m, 2)-net, also after a digital shift, and also for the next
+    // block of 2^m points.
+    {
+        mt::Sobol sobol;
+        sobol.uniformVector2(p, n);
+        EXPECT_EQ(0.0f, v[0][0]);
+        EXPECT_EQ(0.0f, v[1][0]);
+        testNet(p[0], p[1], m);
+        sobol.uniformVector2(p, n);
+        testNet(p[0], p[1], m);
+
+        mt::Sobol scrambled(17);
+        scrambled.uniformVector2(p, n);
+        testNet(p[0], p[1], m);
+    }
+
+    // Points can be read from any index.
+    {
+        mt::Sobol sobol(5);
+        sobol.uniformVector3(p, 100);
+        sobol.uniformVector3(p, 1);
+        float x[3] = { v[0][0], v[1][0], v[2][0] };
+        sobol.setIndex(100);
+        sobol.uniformVector3(p, 1);
+        for (int d = 0; d != 3; ++d)
+        {
+            EXPECT_EQ(x[d], v[d][0]);
+        }
+        EXPECT_EQ(101u, sobol.index());
+    }
+
+    // The last index wraps around to the first point.
+    {
+        mt::Sobol sobol(5);
+        uint32_t first[mt::Sobol::DIMENSIONS];
+        sobol.next(first);
+        uint32_t x[mt::Sobol::DIMENSIONS];
+        sobol.setIndex(0xFFFFFFFFUL);
+        sobol.next(x);
+        sobol.next(x);
+        EXPECT_EQ(1u, sobol.index());
+        for (int d = 0; d != mt::Sobol::DIMENSIONS; ++d)
+        {
+            EXPECT_EQ(first[d], x[d]);
+        }
+    }
+
+    // Averages over low-discrepancy directions and rotations converge faster than over pseudo-random
+    // ones. For uniform unit vectors in R^k, the mean of each squared coordinate is 1/k.
+    {
+        mt::Sobol sobol;
+        mt::Philox philox;
+
+        sobol.direction(p, n);
+        double error = 0;
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_NEAR(1.0f, v[0][i] * v[0][i] + v[1][i] * v[1][i] + v[2][i] * v[2][i], 1e-5f);
+            error += (double(v[2][i]) * v[2][i] - 1.0 / 3.0) / n;
+        }
+        philox.direction(p, n);
+        double randomError = 0;
+        for (size_t i = 0; i != n; ++i)
+        {
+            randomError += (double(v[2][i]) * v[2][i] - 1.0 / 3.0) / n;
+        }
+        EXPECT_LT(mt::abs(error), 1e-4);
+        EXPECT_LT(mt::abs(error), mt::abs(randomError));
+
+        sobol.setIndex(0);
+        sobol.rotation(p, n);
+        double errors[4] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_NEAR(1.0f, v[0][i] * v[0][i] + v[1][i] * v[1][i] + v[2][i] * v[2][i] + v[3][i] * v[3][i], 1e-5f);
+            for (int k = 0; k != 4; ++k)
+            {
+                errors[k] += (double(v[k][i]) * v[k][i] - 0.25) / n;
+            }
+        }
+        for (int k = 0; k != 4; ++k)
+        {
+            EXPECT_LT(mt::abs(errors[k]), 1e-3);
+        }
+    }
+}
@@ -0,0 +1,345 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+
+#include "TestHelpers.hpp"
+
+template <typename Packet>
+void testPacket(Random& random)
+{
+    const int N = Packet::SIZE;
+
+    Scalar a[N];
+    Scalar b[N];
+    for (int i = 0; i != N; ++i)
+    {
+        a[i] = random.uniform() * Scalar(2) - Scalar(1);
+        b[i] = random.uniform() + Scalar(0.5);
+    }
+    a[1] = b[1];
+
+    Packet pa(a);
+    Packet pb(b);
+
+    Scalar c[N];
+    store(c, pa * pb + Scalar(1));
+
+    typename Packet::MaskType less = pa < pb;
+    typename Packet::MaskType equal = pa == pb;
+    Packet smaller = select(less, pa, pb);
+
+    for (int i = 0; i != N; ++i)
+    {
+        EXPECT_EQ(a[i] * b[i] + Scalar(1), c[i]);
+        EXPECT_EQ(a[i] + b[i], (pa + pb)[i]);
+        EXPECT_EQ(a[i] - b[i], (pa - pb)[i]);
+        EXPECT_EQ(a[i] / b[i], (pa / pb)[i]);
+        EXPECT_EQ(-a[i], (-pa)[i]);
+        EXPECT_EQ(Scalar(2) - a[i], (Scalar(2) - pa)[i]);
+        EXPECT_EQ(a[i] < b[i], less[i]);
+        EXPECT_EQ(a[i] == b[i], equal[i]);
+        EXPECT_EQ(a[i] < b[i] ? a[i] : b[i], smaller[i]);
+        EXPECT_EQ(mt::min(a[i], b[i]), min(pa, pb)[i]);
+        EXPECT_EQ(mt::max(a[i], b[i]), max(pa, pb)[i]);
+        EXPECT_EQ(mt::abs(a[i]), abs(pa)[i]);
+        EXPECT_EQ(mt::sqrt(b[i]), sqrt(pb)[i]);
+        EXPECT_FLOAT_EQ(mt::rsqrt(b[i]), rsqrt(pb)[i]);
+        EXPECT_EQ(a[i] < Scalar(0), isnegative(pa)[i]);
+    }
+
+    EXPECT_TRUE(all(ispositive(pb)));
+    EXPECT_TRUE(any(equal));
+    EXPECT_FALSE(none(equal));
+    EXPECT_TRUE(all(less | ~less));
+    EXPECT_TRUE(none(less & ~less));
+
+    // Masks rebuilt from their bits select the same lanes.
+    typename Packet::MaskType rebuilt(less.bits());
+    EXPECT_EQ(less.bits(), rebuilt.bits());
+    EXPECT_EQ(less.bits() ^ ((1u << N) - 1), (~less).bits());
+    for (int i = 0; i != N; ++i)
+    {
+        EXPECT_EQ(smaller[i], select(rebuilt, pa, pb)[i]);
+    }
+    EXPECT_NEAR(Scalar(N) * Scalar(3), hsum(Packet(Scalar(3))), Scalar(1e-6));
+}
+
+TEST(Packet, Lanes)
+{
+    Random random;
+
+    testPacket<Packet4>(random);
+    testPacket<Packet8>(random);
+    testPacket<mt::Packet<Scalar, 3> >(random);
+}
+
+TEST(Packet, Templates)
+{
+    Random random;
+
+    Vector3 a[4];
+    Vector3 b[4];
+    Matrix3x3 m[4];
+    Dual d[4];
+
+    Scalar lanes[12][4];
+    for (int i = 0; i != 4; ++i)
+    {
+        a[i] = random.uniformVector3();
+        b[i] = random.uniformVector3() + Vector3(Scalar(1), Scalar(1), Scalar(1));
+        m[i] = Matrix3x3(random.rotation());
+        d[i] = Dual(random.uniform() + Scalar(0.5), random.uniform());
+
+        for (int j = 0; j != 3; ++j)
+        {
+            lanes[j][i] = a[i][j];
+            lanes[3 + j][i] = b[i][j];
+            lanes[6 + j][i] = m[i][j][j];
+        }
+        lanes[9][i] = d[i].real();
+        lanes[10][i] = d[i].dual();
+    }
+
+    // Structure of arrays: one packet per component
+    PacketVector3 pa = PacketVector3(Packet4(lanes[0]), Packet4(lanes[1]), Packet4(lanes[2]));
+    PacketVector3 pb = PacketVector3(Packet4(lanes[3]), Packet4(lanes[4]), Packet4(lanes[5]));
+
+    PacketMatrix3x3 pm;
+    for (int j = 0; j != 3; ++j)
+    {
+        for (int k = 0; k != 3; ++k)
+        {
+            for (int i = 0; i != 4; ++i)
+            {
+                pm[j][k][i] = m[i][j][k];
+            }
+        }
+    }
+
+    PacketDual pd = PacketDual(Packet4(lanes[9]), Packet4(lanes[10]));
+
+    Packet4 dots = dot(pa, pb);
+    PacketVector3 crosses = cross(pa, pb);
+    PacketVector3 normals = normalize(pb);
+    PacketVector3 products = mul(pm, pa);
+    PacketMatrix3x3 squares = mul(pm, transpose(pm));
+    PacketDual roots = sqrt(pd * pd + Packet4(Scalar(1)));
+
+    for (int i = 0; i != 4; ++i)
+    {
+        EXPECT_NEAR(dot(a[i], b[i]), dots[i], Scalar(1e-5));
+
+        Vector3 c = cross(a[i], b[i]);
+        Vector3 n = normalize(b[i]);
+        Vector3 p = mul(m[i], a[i]);
+        Dual r = sqrt(d[i] * d[i] + Scalar(1));
+        for (int j = 0; j != 3; ++j)
+        {
+            EXPECT_NEAR(c[j], crosses[j][i], Scalar(1e-5));
+            EXPECT_NEAR(n[j], normals[j][i], Scalar(1e-5));
+            EXPECT_NEAR(p[j], products[j][i], Scalar(1e-5));
+            EXPECT_NEAR(Scalar(1), squares[j][j][i], Scalar(1e-5));
+        }
+        EXPECT_NEAR(r.real(), roots.real()[i], Scalar(1e-5));
+        EXPECT_NEAR(r.dual(), roots.dual()[i], Scalar(1e-5));
+    }
+
+    // Lanes of zero length are normalized lane by lane, and stay zero.
+    pb[0][2] = Scalar();
+    pb[1][2] = Scalar();
+    pb[2][2] = Scalar();
+    normals = normalize(pb);
+    PacketQuaternion quaternions = normalize(PacketQuaternion(pb[0], pb[1], pb[2], Packet4()));
+    for (int i = 0; i != 4; ++i)
+    {
+        Vector3 n = i == 2 ? Vector3(mt::Zero()) : normalize(b[i]);
+        for (int j = 0; j != 3; ++j)
+        {
+            EXPECT_NEAR(n[j], normals[j][i], Scalar(1e-5));
+            EXPECT_NEAR(n[j], quaternions[j][i], Scalar(1e-5));
+        }
+        EXPECT_EQ(Scalar(), quaternions.w[i]);
+    }
+}
+
+// Distance in units in the last place between two floats. NaNs are at distance zero from each other.
+int64_t ulpDistance(float a, float b)
+{
+    if (a != a || b != b)
+    {
+        return a != a && b != b ? 0 : INT32_MAX;
+    }
+    int64_t i = mt::bitcast<int32_t>(a);
+    int64_t j = mt::bitcast<int32_t>(b);
+    i = i < 0 ? int64_t(INT32_MIN) - i : i;
+    j = j < 0 ? int64_t(INT32_MIN) - j : j;
+    return i < j ? j - i : i - j;
+}
+
+// Maximum error of f over evenly spaced arguments in [lo, hi] with respect to the correctly rounded
+// result of g. Errors whose magnitude does not exceed tolerance are not counted.
+template <typename Packet>
+int64_t maxUlps(Packet (*f)(const Packet&), double (*g)(double), float lo, float hi, double tolerance)
+{
+    const int N = Packet::SIZE;
+    const int COUNT = 20000;
+
+    int64_t result = 0;
+    for (int k = 0; k < COUNT; k += N)
+    {
+        Packet x;
+        for (int i = 0; i != N; ++i)
+        {
+            x[i] = lo + (hi - lo) * float(k + i) / float(COUNT);
+        }
+        Packet y = f(x);
+        for (int i = 0; i != N; ++i)
+        {
+            double expected = g(x[i]);
+            if (tolerance < std::fabs(y[i] - expected))
+            {
+                result = std::max(result, ulpDistance(y[i], float(expected)));
+            }
+        }
+    }
+    return result;
+}
+
+template <typename Packet>
+void testTranscendentals()
+{
+    const int N = Packet::SIZE;
+
+    EXPECT_LE(maxUlps<Packet>(mt::sin, std::sin, -4.0f, 4.0f, 0.0), 2);
+    EXPECT_LE(maxUlps<Packet>(mt::cos, std::cos, -4.0f, 4.0f, 0.0), 2);
+    EXPECT_LE(maxUlps<Packet>(mt::sin, std::sin, -8192.0f, 8192.0f, 1e-7), 2);
+    EXPECT_LE(maxUlps<Packet>(mt::cos, std::cos, -8192.0f, 8192.0f, 1e-7), 2);
+    EXPECT_LE(maxUlps<Packet>(mt::asin, std::asin, -1.0f, 1.0f, 0.0), 2);
+    EXPECT_LE(maxUlps<Packet>(mt::acos, std::acos, -1.0f, 1.0f, 0.0), 1);
+    EXPECT_LE(maxUlps<Packet>(mt::atan, std::atan, -100.0f, 100.0f, 0.0), 3);
+    EXPECT_LE(maxUlps<Packet>(mt::exp, std::exp, -87.0f, 88.0f, 0.0), 1);
+    EXPECT_LE(maxUlps<Packet>(mt::log, std::log, 1e-6f, 4.0f, 0.0), 1);
+    EXPECT_LE(maxUlps<Packet>(mt::log, std::log, 1.0f, 3e38f, 0.0), 1);
+
+    // All four quadrants of atan2 and the axes
+    for (int k = 0; k < 360; k += N)
+    {
+        Packet y, x;
+        for (int i = 0; i != N; ++i)
+        {
+            double theta = (k + i) * 3.14159265358979324 / 180.0;
+            y[i] = float(3.0 * std::sin(theta));
+            x[i] = k + i == 90 || k + i == 270 ? 0.0f : float(3.0 * std::cos(theta));
+        }
+        Packet z = atan2(y, x);
+        for (int i = 0; i != N; ++i)
+        {
+            EXPECT_LE(ulpDistance(z[i], float(std::atan2(double(y[i]), double(x[i])))), 3);
+        }
+    }
+
+    Packet s, c;
+    sincos(Packet(0.5f), s, c);
+    EXPECT_EQ(sin(Packet(0.5f))[0], s[0]);
+    EXPECT_EQ(cos(Packet(0.5f))[0], c[0]);
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_EQ(-infinity, log(Packet(0.0f))[0]);
+    EXPECT_EQ(infinity, log(Packet(infinity))[0]);
+    EXPECT_TRUE(mt::isnan(log(Packet(-1.0f))[0]));
+    EXPECT_EQ(infinity, exp(Packet(100.0f))[0]);
+    EXPECT_EQ(0.0f, exp(Packet(-110.0f))[0]);
+    EXPECT_EQ(0.0f, atan2(Packet(0.0f), Packet(0.0f))[0]);
+    EXPECT_FLOAT_EQ(1.57079632679f, acos(Packet(0.0f))[0]);
+    EXPECT_FLOAT_EQ(3.14159265359f, acos(Packet(-1.0f))[0]);
+    EXPECT_EQ(0.0f, acos(Packet(1.0f + 1e-6f))[0]);
+    EXPECT_TRUE(mt::isnan(sin(Packet(nan))[0]));
+    EXPECT_TRUE(mt::isnan(exp(Packet(nan))[0]));
+    EXPECT_TRUE(mt::isnan(asin(Packet(nan))[0]));
+    EXPECT_TRUE(mt::isnan(atan2(Packet(nan), Packet(0.0f))[0]));
+}
+
+TEST(Packet, Transcendentals)
+{
+    testTranscendentals<mt::Packet<float, 4> >();
+    testTranscendentals<mt::Packet<float, 8> >();
+    testTranscendentals<mt::Packet<float, 3> >();
+
+    // Other lane types call the C library.
+    mt::Packet<double, 2> x(0.25);
+    EXPECT_EQ(std::atan2(0.25, 0.5), atan2(x, x + 0.25)[1]);
+    EXPECT_EQ(std::exp(0.25), exp(x)[0]);
+}
+
+TEST(Packet, TranscendentalBatches)
+{
+    const size_t n = 37;
+
+    float x[n];
+    float y[n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        x[i] = float(i) * 0.05f - 0.9f;
+        y[i] = float(i) * 0.25f + 0.5f;
+    }
+
+    float s[n], c[n], a[n], e[n], l[n], t[n];
+    mt::sincos(x, s, c, n);
+    mt::asin(x, a, n);
+    mt::exp(x, e, n);
+    mt::log(y, l, n);
+    mt::atan2(x, y, t, n);
+
+    for (size_t i = 0; i != n; ++i)
+    {
+        EXPECT_EQ(mt::sin(mt::FloatPacket(x[i]))[0], s[i]);
+        EXPECT_EQ(mt::cos(mt::FloatPacket(x[i]))[0], c[i]);
+        EXPECT_EQ(mt::asin(mt::FloatPacket(x[i]))[0], a[i]);
+        EXPECT_EQ(mt::exp(mt::FloatPacket(x[i]))[0], e[i]);
+        EXPECT_EQ(mt::log(mt::FloatPacket(y[i]))[0], l[i]);
+        EXPECT_EQ(mt::atan2(mt::FloatPacket(x[i]), mt::FloatPacket(y[i]))[0], t[i]);
+    }
+}
+
+template <typename Packet, typename Policy>
+void testPrecision(Policy p, Scalar tolerance)
+{
+    Packet a;
+    for (int i = 0; i != Packet::SIZE; ++i)
+    {
+        a[i] = Scalar(0.37) + Scalar(i) * Scalar(11.3);
+    }
+    Packet r = rcp(a, p);
+    Packet s = rsqrt(a, p);
+    Packet d = div(Packet(Scalar(3)), a, p);
+    for (int i = 0; i != Packet::SIZE; ++i)
+    {
+        EXPECT_NEAR(1.0, double(r[i]) * double(a[i]), tolerance);
+        EXPECT_NEAR(1.0, double(s[i]) * std::sqrt(double(a[i])), tolerance);
+        EXPECT_NEAR(1.0, double(d[i]) * double(a[i]) / 3.0, tolerance);
+    }
+
+    mt::Vector4<Packet> u(a, -a, Packet(Scalar(2)), Packet(Scalar(1)));
+    mt::Vector4<Packet> v = normalize(u, p);
+    Packet lengths = lengthSquared(v);
+    for (int i = 0; i != Packet::SIZE; ++i)
+    {
+        EXPECT_NEAR(Scalar(1), lengths[i], Scalar(2) * tolerance);
+    }
+}
+
+TEST(Packet, Precision)
+{
+    testPrecision<Packet4>(mt::Exact(), Scalar(1e-7));
+    testPrecision<Packet4>(mt::FastRefined(), Scalar(1) / (1 << 20));
+    testPrecision<Packet4>(mt::Fast(), Scalar(1.5) / (1 << 12));
+    testPrecision<Packet8>(mt::FastRefined(), Scalar(1) / (1 << 20));
+    testPrecision<Packet8>(mt::Fast(), Scalar(1.5) / (1 << 12));
+    testPrecision<mt::Packet<Scalar, 3> >(mt::Fast(), Scalar(1.5) / (1 << 12));
+}
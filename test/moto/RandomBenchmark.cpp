@@ -0,0 +1,104 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the throughput of the batched Philox fills against the per-sample mt::Random, in millions
+// of samples per second. Usage: bench_random [samples] [repeats]
+
+#include <moto/Random.hpp>
+#include <moto/Philox.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkHelpers.hpp"
+
+typedef float Scalar;
+typedef mt::Vector3<Scalar> Vector3;
+typedef mt::Vector4<Scalar> Vector4;
+
+void report(const char* name, double count, double time)
+{
+    printf("%-20s %10.2f M/s\n", name, time > 0.0 ? count / time : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? size_t(atol(argv[1])) : size_t(1) << 16;
+    int repeats = argc > 2 ? atoi(argv[2]) : 100;
+
+    std::vector<float> v[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+    float* const p[4] = { &v[0][0], &v[1][0], &v[2][0], &v[3][0] };
+    std::vector<Vector3> d(n);
+    std::vector<Vector4> q(n);
+
+    mt::Random<Scalar> random;
+    mt::Philox philox;
+    double count = double(n) * repeats * 1e-6;
+    Scalar sink = Scalar();
+
+    clock_t start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            v[0][i] = random.uniform();
+        }
+        sink += v[0][r % n];
+    }
+    report("uniform Random", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        philox.uniform(p[0], n);
+        sink += v[0][r % n];
+    }
+    report("uniform Philox", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            d[i] = random.direction();
+        }
+        sink += d[r % n].x;
+    }
+    report("direction Random", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        philox.direction(p, n);
+        sink += v[0][r % n];
+    }
+    report("direction Philox", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t i = 0; i != n; ++i)
+        {
+            q[i] = random.rotation();
+        }
+        sink += q[r % n].w;
+    }
+    report("rotation Random", count, seconds(start));
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        philox.rotation(p, n);
+        sink += v[3][r % n];
+    }
+    report("rotation Philox", count, seconds(start));
+
+    printf("(%g)\n", double(sink));
+
+    return 0;
+}
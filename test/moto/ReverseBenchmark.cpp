@@ -0,0 +1,114 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the time per gradient of an n-parameter chain energy, computed in one backward sweep over a
+// reused Tape and in n forward passes with Dual numbers. Usage: bench_reverse [repeats]
+
+#include <moto/Dual.hpp>
+#include <moto/Reverse.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkHelpers.hpp"
+
+typedef float Scalar;
+typedef mt::Dual<Scalar> Dual;
+typedef mt::Reverse<Scalar> Reverse;
+typedef mt::Tape<Scalar> Tape;
+
+// The bending and stretching energy of a planar chain with joint angles theta, in the style of an IK objective.
+template <typename T>
+T energy(const T* theta, int n)
+{
+    T x = T();
+    T y = T();
+    T angle = T();
+    T result = T();
+    for (int i = 0; i != n; ++i)
+    {
+        angle += theta[i];
+        x += cos(angle);
+        y += sin(angle);
+        result += theta[i] * theta[i] * T(0.01f);
+    }
+    T dx = x - T(Scalar(n) * 0.5f);
+    T dy = y - T(Scalar(n) * 0.25f);
+    return result + dx * dx + dy * dy;
+}
+
+int main(int argc, char** argv)
+{
+    int repeats = argc > 1 ? atoi(argv[1]) : 200;
+
+    printf("%6s %14s %14s %10s %12s\n", "n", "reverse (us)", "dual (us)", "speed-up", "rel. error");
+
+    Tape tape;
+    for (int n = 4; n <= 512; n *= 2)
+    {
+        std::vector<Scalar> theta(n);
+        for (int i = 0; i != n; ++i)
+        {
+            theta[i] = Scalar(0.1) * Scalar(i % 7) - Scalar(0.3);
+        }
+
+        std::vector<Reverse> x(n);
+        std::vector<Scalar> reverseGradient(n);
+        clock_t start = clock();
+        for (int r = 0; r != repeats; ++r)
+        {
+            tape.clear();
+            for (int i = 0; i != n; ++i)
+            {
+                x[i] = tape.variable(theta[i]);
+            }
+            tape.gradient(energy(&x[0], n));
+            for (int i = 0; i != n; ++i)
+            {
+                reverseGradient[i] = adjoint(x[i]);
+            }
+        }
+        double reverseTime = seconds(start) / repeats;
+
+        std::vector<Dual> z(n);
+        std::vector<Scalar> dualGradient(n);
+        start = clock();
+        for (int r = 0; r != repeats; ++r)
+        {
+            for (int i = 0; i != n; ++i)
+            {
+                z[i] = Dual(theta[i]);
+            }
+            for (int i = 0; i != n; ++i)
+            {
+                z[i] = Dual(theta[i], 1);
+                dualGradient[i] = dual(energy(&z[0], n));
+                z[i] = Dual(theta[i]);
+            }
+        }
+        double dualTime = seconds(start) / repeats;
+
+        // The largest difference relative to the largest partial derivative
+        Scalar error = Scalar();
+        Scalar scale = Scalar();
+        for (int i = 0; i != n; ++i)
+        {
+            Scalar e = std::fabs(reverseGradient[i] - dualGradient[i]);
+            Scalar g = std::fabs(dualGradient[i]);
+            error = e > error ? e : error;
+            scale = g > scale ? g : scale;
+        }
+        error = scale > Scalar() ? error / scale : error;
+
+        printf("%6d %14.2f %14.2f %10.1f %12g\n", n, reverseTime * 1e6, dualTime * 1e6,
+               reverseTime > 0.0 ? dualTime / reverseTime : 0.0, double(error));
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the accuracy of the 3x3 SVD per number of Jacobi sweeps, as the largest reconstruction and
+// orthogonality errors over random matrices, and the throughput of the scalar and packet versions in
+// millions of decompositions per second. Usage: bench_svd [matrices] [repeats]
+
+#include <moto/Matrix3x3.hpp>
+#include <moto/PacketMath.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include "BenchmarkHelpers.hpp"
+
+typedef float Scalar;
+typedef mt::Vector3<Scalar> Vector3;
+typedef mt::Matrix3x3<Scalar> Matrix3x3;
+typedef mt::FloatPacket Lanes;
+typedef mt::Matrix3x3<Lanes> LanesMatrix3x3;
+typedef mt::Vector3<Lanes> LanesVector3;
+
+const int N = Lanes::SIZE;
+
+Scalar uniform()
+{
+    return Scalar(rand()) / Scalar(RAND_MAX) * Scalar(2) - Scalar(1);
+}
+
+// The largest element of |a - b|
+Scalar maxError(const Matrix3x3& a, const Matrix3x3& b)
+{
+    Scalar result = Scalar();
+    for (int i = 0; i != 3; ++i)
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            result = mt::max(result, mt::abs(a[i][j] - b[i][j]));
+        }
+    }
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? size_t(atol(argv[1])) : size_t(1) << 16;
+    int repeats = argc > 2 ? atoi(argv[2]) : 20;
+    n = (n + N - 1) / N * N;
+
+    std::vector<Matrix3x3> a(n);
+    for (size_t k = 0; k != n; ++k)
+    {
+        for (int i = 0; i != 3; ++i)
+        {
+            a[k][i] = Vector3(uniform(), uniform(), uniform());
+        }
+    }
+
+    printf("%lu matrices with elements in [-1, 1], %d lanes\n", static_cast<unsigned long>(n), N);
+    printf("%6s %16s %16s\n", "sweeps", "|a - u s v^T|", "|u^T u - I|");
+    for (int sweeps = 1; sweeps <= 6; ++sweeps)
+    {
+        Scalar reconstruction = Scalar();
+        Scalar orthogonality = Scalar();
+        for (size_t k = 0; k != n; ++k)
+        {
+            Matrix3x3 u, v;
+            Vector3 sigma;
+            svd(a[k], u, sigma, v, sweeps);
+            reconstruction = mt::max(reconstruction, maxError(mulTranspose(mul(u, diag(sigma)), v), a[k]));
+            orthogonality = mt::max(orthogonality, maxError(transposeMul(u, u), Matrix3x3(mt::Identity())));
+            orthogonality = mt::max(orthogonality, maxError(transposeMul(v, v), Matrix3x3(mt::Identity())));
+        }
+        printf("%6d %16g %16g\n", sweeps, double(reconstruction), double(orthogonality));
+    }
+
+    // Packets may need a larger alignment than std::allocator provides.
+    LanesMatrix3x3* b = static_cast<LanesMatrix3x3*>(alignedAlloc(n / N * sizeof(LanesMatrix3x3)));
+    for (size_t k = 0; k != n; ++k)
+    {
+        for (int i = 0; i != 3; ++i)
+        {
+            for (int j = 0; j != 3; ++j)
+            {
+                b[k / N][i][j][int(k % N)] = a[k][i][j];
+            }
+        }
+    }
+
+    Scalar sink = Scalar();
+    clock_t start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t k = 0; k != n; ++k)
+        {
+            Matrix3x3 u, v;
+            Vector3 sigma;
+            svd(a[k], u, sigma, v);
+            sink += sigma.z;
+        }
+    }
+    double scalarTime = seconds(start);
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t k = 0; k != n / N; ++k)
+        {
+            LanesMatrix3x3 u, v;
+            LanesVector3 sigma;
+            svd(b[k], u, sigma, v);
+            sink += sigma.z[0];
+        }
+    }
+    double packetTime = seconds(start);
+
+    start = clock();
+    for (int r = 0; r != repeats; ++r)
+    {
+        for (size_t k = 0; k != n / N; ++k)
+        {
+            LanesMatrix3x3 q, s;
+            polar(b[k], q, s);
+            sink += s[2][2][0];
+        }
+    }
+    double polarTime = seconds(start);
+
+    double count = double(n) * repeats * 1e-6;
+    printf("%-16s %10.2f M/s\n", "svd scalar", scalarTime > 0.0 ? count / scalarTime : 0.0);
+    printf("%-16s %10.2f M/s\n", "svd packet", packetTime > 0.0 ? count / packetTime : 0.0);
+    printf("%-16s %10.2f M/s\n", "polar packet", polarTime > 0.0 ? count / polarTime : 0.0);
+    printf("(%g)\n", double(sink));
+
+    alignedFree(b);
+
+    return 0;
+}
@@ -24,6 +24,14 @@ void testFuzzyEqual(const Matrix3x3& lhs, const Matrix3x3& rhs)
     testFuzzyEqual(lhs[2], rhs[2]);
 }
 
+inline
+void testFuzzyEqual(const Matrix3x4& lhs, const Matrix3x4& rhs)
+{
+    testFuzzyEqual(lhs[0], rhs[0]);
+    testFuzzyEqual(lhs[1], rhs[1]);
+    testFuzzyEqual(lhs[2], rhs[2]);
+}
+
 inline
 void testFuzzyEqual(const Matrix4x4& lhs, const Matrix4x4& rhs)
 {
@@ -0,0 +1,144 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+// Reports the throughput of the bulk transforms in GB/s, counting the bytes read plus the bytes written,
+// next to that of memcpy over buffers of the same size. Usage: bench_transform [elements] [repeats]
+
+#include <moto/Matrix4x4.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+#include "BenchmarkHelpers.hpp"
+
+typedef float Scalar;
+typedef mt::Vector3<Scalar> Vector3;
+typedef mt::Vector4<Scalar> Vector4;
+typedef mt::Matrix3x4<Scalar> Matrix3x4;
+typedef mt::Matrix4x4<Scalar> Matrix4x4;
+
+struct Streams
+{
+    size_t n;
+    Matrix3x4 a;
+    Matrix4x4 m;
+    Vector3* points;
+    Vector3* out3;
+    Vector4* vectors;
+    Vector4* out4;
+    Scalar* x[4];
+    Scalar* out[4];
+};
+
+void points3x4(Streams& s, bool nonTemporal) { transformPoints(s.a, s.points, s.out3, s.n, nonTemporal); }
+void vectors3x4(Streams& s, bool nonTemporal) { transformVectors(s.a, s.points, s.out3, s.n, nonTemporal); }
+void planes3x4(Streams& s, bool nonTemporal) { transformPlanes(s.a, s.vectors, s.out4, s.n, nonTemporal); }
+void pointsSoA3x4(Streams& s, bool nonTemporal) { transformPoints(s.a, s.x[0], s.x[1], s.x[2], s.out[0], s.out[1], s.out[2], s.n, nonTemporal); }
+void points4x4(Streams& s, bool nonTemporal) { transformPoints(s.m, s.points, s.out4, s.n, nonTemporal); }
+void vectors4x4(Streams& s, bool nonTemporal) { transformVectors(s.m, s.vectors, s.out4, s.n, nonTemporal); }
+void planes4x4(Streams& s, bool nonTemporal) { transformPlanes(s.m, s.vectors, s.out4, s.n, nonTemporal); }
+void pointsSoA4x4(Streams& s, bool nonTemporal) { transformPoints(s.m, s.x[0], s.x[1], s.x[2], s.out[0], s.out[1], s.out[2], s.out[3], s.n, nonTemporal); }
+
+struct Kernel
+{
+    const char* name;
+    void (*run)(Streams&, bool);
+    size_t bytesIn;
+    size_t bytesOut;
+};
+
+const Kernel kernels[] =
+{
+    { "Matrix3x4 points", points3x4, sizeof(Vector3), sizeof(Vector3) },
+    { "Matrix3x4 vectors", vectors3x4, sizeof(Vector3), sizeof(Vector3) },
+    { "Matrix3x4 planes", planes3x4, sizeof(Vector4), sizeof(Vector4) },
+    { "Matrix3x4 points SoA", pointsSoA3x4, 3 * sizeof(Scalar), 3 * sizeof(Scalar) },
+    { "Matrix4x4 points", points4x4, sizeof(Vector3), sizeof(Vector4) },
+    { "Matrix4x4 vectors", vectors4x4, sizeof(Vector4), sizeof(Vector4) },
+    { "Matrix4x4 planes", planes4x4, sizeof(Vector4), sizeof(Vector4) },
+    { "Matrix4x4 points SoA", pointsSoA4x4, 3 * sizeof(Scalar), 4 * sizeof(Scalar) }
+};
+
+double gigabytesPerSecond(size_t bytes, int repeats, double t)
+{
+    return t > 0.0 ? double(bytes) * repeats / t * 1e-9 : 0.0;
+}
+
+int main(int argc, char** argv)
+{
+    Streams s;
+    s.n = argc > 1 ? size_t(atol(argv[1])) : size_t(1) << 22;
+    int repeats = argc > 2 ? atoi(argv[2]) : 20;
+
+    s.a = Matrix3x4(mt::Matrix3x3<Scalar>(Vector4(0.0f, 0.6f, 0.0f, 0.8f)), Vector3(1.0f, 2.0f, 3.0f));
+    s.m = Matrix4x4(s.a);
+    s.m[3] = Vector4(0.1f, 0.2f, 0.3f, 1.0f);
+
+    s.points = static_cast<Vector3*>(alignedAlloc(s.n * sizeof(Vector3)));
+    s.out3 = static_cast<Vector3*>(alignedAlloc(s.n * sizeof(Vector3)));
+    s.vectors = static_cast<Vector4*>(alignedAlloc(s.n * sizeof(Vector4)));
+    s.out4 = static_cast<Vector4*>(alignedAlloc(s.n * sizeof(Vector4)));
+    for (int j = 0; j != 4; ++j)
+    {
+        s.x[j] = static_cast<Scalar*>(alignedAlloc(s.n * sizeof(Scalar)));
+        s.out[j] = static_cast<Scalar*>(alignedAlloc(s.n * sizeof(Scalar)));
+    }
+
+    for (size_t i = 0; i != s.n; ++i)
+    {
+        Scalar t = Scalar(i % 1000) * 0.001f;
+        s.points[i] = Vector3(t, 1.0f - t, t * t);
+        s.vectors[i] = Vector4(s.points[i], 1.0f);
+        s.x[0][i] = s.points[i].x;
+        s.x[1][i] = s.points[i].y;
+        s.x[2][i] = s.points[i].z;
+        s.x[3][i] = 1.0f;
+    }
+    memset(static_cast<void*>(s.out4), 0, s.n * sizeof(Vector4));
+
+    size_t copyBytes = s.n * sizeof(Vector4);
+    clock_t start = clock();
+    for (int k = 0; k != repeats; ++k)
+    {
+        memcpy(static_cast<void*>(s.out4), static_cast<const void*>(s.vectors), copyBytes);
+    }
+    double memcpyRate = gigabytesPerSecond(2 * copyBytes, repeats, seconds(start));
+
+    printf("%lu elements, %d repeats\n", static_cast<unsigned long>(s.n), repeats);
+    printf("%-24s %10.2f GB/s\n", "memcpy", memcpyRate);
+
+    for (size_t k = 0; k != sizeof(kernels) / sizeof(Kernel); ++k)
+    {
+        for (int nonTemporal = 0; nonTemporal != 2; ++nonTemporal)
+        {
+            kernels[k].run(s, nonTemporal != 0);
+
+            start = clock();
+            for (int r = 0; r != repeats; ++r)
+            {
+                kernels[k].run(s, nonTemporal != 0);
+            }
+            double rate = gigabytesPerSecond(s.n * (kernels[k].bytesIn + kernels[k].bytesOut), repeats, seconds(start));
+
+            printf("%-24s %10.2f GB/s %6.1f%% of memcpy%s\n", kernels[k].name, rate,
+                   memcpyRate > 0.0 ? 100.0 * rate / memcpyRate : 0.0, nonTemporal ? ", non-temporal" : "");
+        }
+    }
+
+    alignedFree(s.points);
+    alignedFree(s.out3);
+    alignedFree(s.vectors);
+    alignedFree(s.out4);
+    for (int j = 0; j != 4; ++j)
+    {
+        alignedFree(s.x[j]);
+        alignedFree(s.out[j]);
+    }
+
+    return 0;
+}
@@ -30,3 +30,223 @@ TEST(Trigonometry, EulerAngles)
     }
 
 }
+
+TEST(Trigonometry, AxisAngle)
+{
+    Random random;
+
+    for (int k = 0; k != 1000; ++k)
+    {
+        Quaternion q = random.rotation();
+        if (mt::isnegative(q.w))
+        {
+            q = -q;
+        }
+        Vector3 axis;
+        Scalar theta;
+        toAxisAngle(axis, theta, q);
+        testFuzzyEqual(q, mt::fromAxisAngle(axis, theta));
+        testFuzzyEqual(q, mt::exp(mt::logUnit(q)));
+
+        Scalar phi;
+        mt::toEuler(theta, phi, axis);
+        testFuzzyEqual(axis, mt::euler(theta, phi));
+    }
+}
+
+TEST(Trigonometry, InterpolationBatches)
+{
+    Random random;
+
+    const size_t n = 37;
+
+    Scalar u1[4][n];
+    Scalar u2[4][n];
+    Scalar t[n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        Quaternion q1 = random.rotation();
+        Quaternion q2 = i % 3 == 0 ? normalize(q1 + Quaternion(random.uniformVector3() * Scalar(1e-5), Scalar())) : random.rotation();
+        for (int j = 0; j != 4; ++j)
+        {
+            u1[j][i] = q1[j];
+            u2[j][i] = q2[j];
+        }
+        t[i] = random.uniform();
+    }
+
+    const Scalar* in1[4] = { u1[0], u1[1], u1[2], u1[3] };
+    const Scalar* in2[4] = { u2[0], u2[1], u2[2], u2[3] };
+
+    Scalar s[4][n];
+    Scalar a[4][n];
+    Scalar l[4][n];
+    Scalar* outS[4] = { s[0], s[1], s[2], s[3] };
+    Scalar* outA[4] = { a[0], a[1], a[2], a[3] };
+    Scalar* outL[4] = { l[0], l[1], l[2], l[3] };
+
+    mt::slerpBatch(in1, in2, t, outS, n);
+    mt::slerpBatch(in1, in2, t, outA, n, true);
+    mt::nlerpBatch(in1, in2, t, outL, n);
+
+    for (size_t i = 0; i != n; ++i)
+    {
+        Quaternion q1(u1[0][i], u1[1][i], u1[2][i], u1[3][i]);
+        Quaternion q2(u2[0][i], u2[1][i], u2[2][i], u2[3][i]);
+        if (mt::isnegative(dot(q1, q2)))
+        {
+            q2 = -q2;
+        }
+
+        Quaternion exact(s[0][i], s[1][i], s[2][i], s[3][i]);
+        Quaternion approximate(a[0][i], a[1][i], a[2][i], a[3][i]);
+        Quaternion normalized(l[0][i], l[1][i], l[2][i], l[3][i]);
+
+        testFuzzyEqual(mt::slerp(q1, q2, t[i]), exact);
+        testFuzzyEqual(mt::slerp(q1, q1, t[i]), q1);
+        testFuzzyEqual(mt::nlerp(q1, q2, t[i]), normalized);
+        EXPECT_NEAR(Scalar(1), length(exact), Scalar(1e-5));
+        EXPECT_LE(length(exact - approximate) * Scalar(2), Scalar(8e-4));
+    }
+
+    // At the ends, the interpolations return the end points.
+    PacketQuaternion p1 = PacketQuaternion(Packet4(u1[0]), Packet4(u1[1]), Packet4(u1[2]), Packet4(u1[3]));
+    PacketQuaternion p2 = -p1;
+    for (int approximate = 0; approximate != 2; ++approximate)
+    {
+        PacketQuaternion p = slerpBatch(p1, p2, Packet4(Scalar(1)), approximate != 0);
+        for (int i = 0; i != 4; ++i)
+        {
+            testFuzzyEqual(Quaternion(p1.x[i], p1.y[i], p1.z[i], p1.w[i]), Quaternion(p.x[i], p.y[i], p.z[i], p.w[i]));
+        }
+    }
+}
+
+// The part of M v orthogonal to v, for M = sum(weights[k] u[k] u[k]^T), which vanishes for eigenvectors of M
+double eigenResidual(const Quaternion* u, const Scalar* weights, int m, const Quaternion& v)
+{
+    double mv[4] = { 0.0, 0.0, 0.0, 0.0 };
+    for (int k = 0; k != m; ++k)
+    {
+        double d = double(u[k].x) * v.x + double(u[k].y) * v.y + double(u[k].z) * v.z + double(u[k].w) * v.w;
+        for (int j = 0; j != 4; ++j)
+        {
+            mv[j] += weights[k] * d * u[k][j];
+        }
+    }
+    double lambda = mv[0] * v.x + mv[1] * v.y + mv[2] * v.z + mv[3] * v.w;
+    double r = 0.0;
+    for (int j = 0; j != 4; ++j)
+    {
+        double e = mv[j] - lambda * v[j];
+        r += e * e;
+    }
+    return std::sqrt(r);
+}
+
+TEST(Trigonometry, AverageBatches)
+{
+    Random random;
+
+    const int m = 5;
+    const size_t n = 37;
+
+    // Poses scattered around the first one, in either hemisphere
+    Scalar u[m][4][n];
+    Scalar weights[m];
+    for (size_t i = 0; i != n; ++i)
+    {
+        Quaternion q0 = random.rotation();
+        for (int k = 0; k != m; ++k)
+        {
+            Quaternion q = k == 0 ? q0 : mul(q0, mt::fromAxisAngle(random.direction(), random.uniform(Scalar(-0.5), Scalar(0.5))));
+            if (random.uniform() < Scalar(0.5))
+            {
+                q = -q;
+            }
+            for (int j = 0; j != 4; ++j)
+            {
+                u[k][j][i] = q[j];
+            }
+        }
+    }
+    for (int k = 0; k != m; ++k)
+    {
+        weights[k] = random.uniform() + Scalar(0.1);
+    }
+
+    const Scalar* in[m][4];
+    const Scalar* reversed[m][4];
+    for (int k = 0; k != m; ++k)
+    {
+        for (int j = 0; j != 4; ++j)
+        {
+            in[k][j] = u[k][j];
+            reversed[k][j] = u[k == 0 ? 0 : m - k][j];
+        }
+    }
+    Scalar reversedWeights[m];
+    for (int k = 0; k != m; ++k)
+    {
+        reversedWeights[k] = weights[k == 0 ? 0 : m - k];
+    }
+
+    Scalar a[4][n];
+    Scalar b[4][n];
+    Scalar r[4][n];
+    Scalar* outA[4] = { a[0], a[1], a[2], a[3] };
+    Scalar* outB[4] = { b[0], b[1], b[2], b[3] };
+    Scalar* outR[4] = { r[0], r[1], r[2], r[3] };
+
+    mt::averageBatch(in, weights, m, outA, n);
+    mt::averageBatch(reversed, reversedWeights, m, outB, n);
+    mt::averageBatch(in, weights, m, outR, n, 8);
+
+    for (size_t i = 0; i != n; ++i)
+    {
+        Quaternion q[m];
+        for (int k = 0; k != m; ++k)
+        {
+            q[k] = Quaternion(u[k][0][i], u[k][1][i], u[k][2][i], u[k][3][i]);
+        }
+        Quaternion average(a[0][i], a[1][i], a[2][i], a[3][i]);
+        Quaternion refined(r[0][i], r[1][i], r[2][i], r[3][i]);
+
+        // The inputs after the first can come in any order.
+        testFuzzyEqual(average, Quaternion(b[0][i], b[1][i], b[2][i], b[3][i]));
+        EXPECT_NEAR(Scalar(1), length(average), Scalar(1e-5));
+        EXPECT_NEAR(Scalar(1), length(refined), Scalar(1e-5));
+
+        // Refinement converges to the eigenvector, which lies close to the normalized sum.
+        EXPECT_LE(eigenResidual(q, weights, m, refined), 1e-5);
+        EXPECT_LE(eigenResidual(q, weights, m, refined), eigenResidual(q, weights, m, average) + 1e-6);
+        EXPECT_LE(length(refined - average), Scalar(0.01));
+    }
+
+    // For two quaternions, the average is nlerpBatch.
+    Scalar t[n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        t[i] = weights[1] / (weights[0] + weights[1]);
+    }
+    Scalar l[4][n];
+    Scalar* outL[4] = { l[0], l[1], l[2], l[3] };
+    mt::nlerpBatch(in[0], in[1], t, outL, n);
+    mt::averageBatch(in, weights, 2, outA, n);
+    for (size_t i = 0; i != n; ++i)
+    {
+        testFuzzyEqual(Quaternion(l[0][i], l[1][i], l[2][i], l[3][i]), Quaternion(a[0][i], a[1][i], a[2][i], a[3][i]));
+    }
+
+    // The packet form agrees with the array form, also with refinement.
+    PacketQuaternion p[m];
+    for (int k = 0; k != m; ++k)
+    {
+        p[k] = PacketQuaternion(Packet4(u[k][0]), Packet4(u[k][1]), Packet4(u[k][2]), Packet4(u[k][3]));
+    }
+    PacketQuaternion pr = mt::averageBatch(p, weights, m, 8);
+    for (int i = 0; i != 4; ++i)
+    {
+        testFuzzyEqual(Quaternion(r[0][i], r[1][i], r[2][i], r[3][i]), Quaternion(pr.x[i], pr.y[i], pr.z[i], pr.w[i]));
+    }
+}
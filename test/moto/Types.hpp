@@ -13,21 +13,32 @@
 #include "moto/Scalar.hpp"
 #include "moto/Vector3.hpp"
 #include "moto/Vector4.hpp"
+#include "moto/PaddedVector3.hpp"
 #include "moto/Matrix2x2.hpp"
 #include "moto/Matrix3x3.hpp"
+#include "moto/Matrix3x3Batch.hpp"
 #include "moto/Matrix4x4.hpp"
 #include "moto/Metric.hpp"
 #include "moto/Trigonometric.hpp"
 #include "moto/Random.hpp"
+#include "moto/Compression.hpp"
 
 #include "moto/Dual.hpp"
 #include "moto/DualVector3.hpp"
 #include "moto/DualVector4.hpp"
+#include "moto/DualVector4Batch.hpp"
 #include "moto/DualMatrix3x3.hpp"
+#include "moto/DualN.hpp"
+#include "moto/Reverse.hpp"
 
 #include "moto/Matrix3x4.hpp"
 #include "moto/Matrix4x3.hpp"
 
+#include "moto/BBox3.hpp"
+
+#include "moto/Packet.hpp"
+#include "moto/PacketMath.hpp"
+
 typedef float Scalar;  // We use "Scalar" as the abstract type for real values. Change "float" to "double" here for double precision.
 
 typedef mt::ScalarTraits<Scalar> ScalarTraits; // Rather then extending std::numeric_limits, we chose to define our won traits class for numerical types. This one includes "pi".
@@ -35,12 +46,14 @@ typedef mt::ScalarTraits<Scalar> ScalarTraits; // Rather then extending std::num
 // We instatiate a number of class templates for our Scalar type           
 typedef mt::Vector2<Scalar> Vector2;
 typedef mt::Vector3<Scalar> Vector3;
+typedef mt::Vector4<Scalar> Vector4;
 typedef mt::Matrix2x2<Scalar> Matrix2x2; // Matrix multiplication uses "mul" as well.
 typedef mt::Vector4<Scalar> Quaternion; // mt::Vector4 is our template for quaternions. The quaternion product is "mul"
 typedef mt::Matrix3x3<Scalar> Matrix3x3; // Matrix multiplication uses "mul" as well.
 typedef mt::Matrix4x4<Scalar> Matrix4x4;
 typedef mt::Matrix3x4<Scalar> Matrix3x4;
 typedef mt::Matrix4x3<Scalar> Matrix4x3;
+typedef mt::BBox3<Scalar> BBox3;
 
 // These class templates are instatiated for our dual numbers type.
 typedef mt::Dual<Scalar> Dual; 
@@ -49,6 +62,23 @@ typedef mt::Vector3<Dual> DualVector3;
 typedef mt::Vector4<Dual> DualQuaternion;
 typedef mt::Matrix3x3<Dual> DualMatrix3x3;
 
+// Packets hold a number of independent lanes, and can be used in place of Scalar.
+typedef mt::Packet<Scalar, 4> Packet4;
+typedef mt::Packet<Scalar, 8> Packet8;
+typedef mt::Vector3<Packet4> PacketVector3;
+typedef mt::Vector4<Packet4> PacketQuaternion;
+typedef mt::Matrix3x3<Packet4> PacketMatrix3x3;
+typedef mt::Dual<Packet4> PacketDual;
+
+// Dual numbers with a gradient of N infinitesimal parts, one per input.
+typedef mt::DualN<Scalar, 3> DualN3;
+typedef mt::DualN<Scalar, 4> DualN4;
+typedef mt::DualN<Scalar, 8> DualN8;
+
+// Reverse-mode numbers record their operations on a tape.
+typedef mt::Reverse<Scalar> Reverse;
+typedef mt::Tape<Scalar> Tape;
+
 typedef mt::Random<Scalar> Random;
 
 // These are types and templates that represent algebraic constants. We will use them in constructors of our vector and matrix types
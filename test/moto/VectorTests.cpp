@@ -0,0 +1,292 @@
+/*  MoTo - Motion Toolkit
+    Copyright (c) 2006-2019 Gino van den Bergen, DTECTA
+
+    Source published under the terms of the MIT License. 
+    For details please see COPYING file or visit 
+    http://opensource.org/licenses/MIT
+*/
+
+#include <cmath>
+#include <vector>
+
+#include "TestHelpers.hpp"
+
+TEST(Vector, PaddedVector3)
+{
+    typedef mt::Vector3<float> Packed;
+    typedef mt::PaddedVector3 Padded;
+
+    EXPECT_EQ(size_t(12), sizeof(Packed));
+#if USE_SSE
+    EXPECT_EQ(size_t(16), sizeof(Padded));
+#endif
+
+    mt::Random<float> random;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        Packed a = random.uniformVector3();
+        Packed b = random.uniformVector3();
+        Padded pa(a);
+        Padded pb(b);
+
+        EXPECT_NEAR(dot(a, b), dot(pa, pb), 1e-6f);
+        testFuzzyEqual(cross(a, b), Packed(cross(pa, pb)));
+        testFuzzyEqual(mt::normalize(a), Packed(normalize(pa)));
+        testFuzzyEqual(abs(a - b), Packed(abs(pa - pb)));
+        testFuzzyEqual(min(a, b), Packed(min(pa, pb)));
+        testFuzzyEqual(max(a, b), Packed(max(pa, pb)));
+        testFuzzyEqual((a + b) * 1.5f, Packed((pa + pb) * 3.0f / 2.0f));
+        testFuzzyEqual(a - b * 2.0f, Packed(pa - 2.0f * pb));
+
+        // Round trip through packed storage
+        float packed[6];
+        convert(packed, pa);
+        convert(packed + 3, pb);
+        EXPECT_EQ(a, Packed(packed));
+        EXPECT_EQ(b, Packed(Padded(packed + 3)));
+    }
+
+    testFuzzyEqual(Packed(mt::Zero()), Packed(normalize(Padded(mt::Zero()))));
+}
+
+BBox3 randomBox(Random& random)
+{
+    return hull(random.uniformVector3(-2.0f, 2.0f), random.uniformVector3(-2.0f, 2.0f));
+}
+
+mt::BBox3<double> widen(const BBox3& b)
+{
+    Vector3 l = lower(b);
+    Vector3 u = upper(b);
+    return mt::BBox3<double>(l.x, u.x, l.y, u.y, l.z, u.z);
+}
+
+TEST(Vector, BBox3)
+{
+    Random random;
+
+    // The double boxes use the generic interval versions.
+    for (int i = 0; i != 100; ++i)
+    {
+        BBox3 a = randomBox(random);
+        BBox3 b = randomBox(random);
+        Vector3 v = random.uniformVector3(-2.0f, 2.0f);
+
+        EXPECT_EQ(overlap(widen(a), widen(b)), overlap(a, b));
+        EXPECT_EQ(subset(widen(a), widen(b)), subset(a, b));
+        EXPECT_TRUE(subset(a, hull(a, b)));
+        EXPECT_TRUE(subset(b, hull(a, b)));
+        EXPECT_TRUE(in(v, hull(a, v)));
+        EXPECT_EQ(in(mt::Vector3<double>(v), widen(a)), in(v, a));
+        EXPECT_EQ(lower(clamp(widen(a), widen(b))), mt::Vector3<double>(lower(clamp(a, b))));
+        EXPECT_EQ(upper(clamp(widen(a), widen(b))), mt::Vector3<double>(upper(clamp(a, b))));
+        testFuzzyEqual(upper(a) - lower(a), width(a));
+        testFuzzyEqual((lower(a) + upper(a)) * Scalar(0.5), median(a));
+        EXPECT_EQ(lower(a)[1], a[1].lower());
+        EXPECT_EQ(upper(a)[2], a[2].upper());
+    }
+
+    // An array of boxes against one box, including a partial group of four and a partial mask word
+    const size_t n = 71;
+    Scalar lowers[3][n];
+    Scalar uppers[3][n];
+    for (size_t i = 0; i != n; ++i)
+    {
+        BBox3 c = hull(random.uniformVector3(-1.0f, 1.0f), random.uniformVector3(-1.0f, 1.0f));
+        Vector3 l = lower(c);
+        Vector3 u = upper(c);
+        for (int j = 0; j != 3; ++j)
+        {
+            lowers[j][i] = l[j];
+            uppers[j][i] = u[j];
+        }
+    }
+    const Scalar* const lower3[3] = { lowers[0], lowers[1], lowers[2] };
+    const Scalar* const upper3[3] = { uppers[0], uppers[1], uppers[2] };
+
+    BBox3 b(Scalar(0.2), Scalar(0.7), Scalar(-0.5), Scalar(0.9), Scalar(-1), Scalar(0.3));
+    uint32_t overlaps[3];
+    uint32_t subsets[3];
+    overlap(b, lower3, upper3, overlaps, n);
+    subset(lower3, upper3, subsets, n, b);
+
+    int count = 0;
+    for (size_t i = 0; i != n; ++i)
+    {
+        BBox3 c(lowers[0][i], uppers[0][i], lowers[1][i], uppers[1][i], lowers[2][i], uppers[2][i]);
+        EXPECT_EQ(overlap(b, c), bool(overlaps[i / 32] & (1u << (i % 32))));
+        EXPECT_EQ(subset(c, b), bool(subsets[i / 32] & (1u << (i % 32))));
+        count += overlap(b, c);
+    }
+    EXPECT_EQ(0u, overlaps[2] >> (n % 32));
+    EXPECT_EQ(0u, subsets[2] >> (n % 32));
+    EXPECT_LT(0, count);
+    EXPECT_GT(int(n), count);
+
+    mt::BitMask4 group = overlap(b, lower3, upper3, 4);
+    EXPECT_EQ((overlaps[0] >> 4) & 0xf, uint32_t(group));
+    EXPECT_EQ(none(group), !any(group));
+}
+
+// The angle in degrees of the rotation from q1 to q2, computed in double precision
+double rotationAngle(const Quaternion& q1, const Quaternion& q2)
+{
+    double x = double(q1.w) * q2.x - double(q1.x) * q2.w - double(q1.y) * q2.z + double(q1.z) * q2.y;
+    double y = double(q1.w) * q2.y + double(q1.x) * q2.z - double(q1.y) * q2.w - double(q1.z) * q2.x;
+    double z = double(q1.w) * q2.z - double(q1.x) * q2.y + double(q1.y) * q2.x - double(q1.z) * q2.w;
+    double w = double(q1.w) * q2.w + double(q1.x) * q2.x + double(q1.y) * q2.y + double(q1.z) * q2.z;
+    return 2.0 * std::atan2(std::sqrt(x * x + y * y + z * z), std::fabs(w)) * 180.0 / 3.14159265358979323846;
+}
+
+TEST(Vector, Compression)
+{
+    Random random;
+
+    // Smallest-three quaternions, within the documented angles, and the same for the single and
+    // batch forms. Axis-aligned rotations, where two components tie, decode exactly. The corner
+    // (1/2, 1/2, 1/2, 1/2), where all four tie, comes close to the bound.
+    {
+        const size_t n = 1001;
+        std::vector<float> v[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        float* const q[4] = { &v[0][0], &v[1][0], &v[2][0], &v[3][0] };
+        for (size_t i = 0; i != n; ++i)
+        {
+            Quaternion r = i < 4 ? Quaternion(float(i == 0), float(i == 1), float(i == 2), -float(i == 3)) :
+                           i == 4 ? Quaternion(0.5f, 0.5f, 0.5f, 0.5f) : random.rotation();
+            for (int k = 0; k != 4; ++k)
+            {
+                v[k][i] = r[k];
+            }
+        }
+
+        std::vector<uint32_t> code32(n);
+        std::vector<uint16_t> code48(3 * n);
+        mt::packQuaternion32(q, &code32[0], n);
+        mt::packQuaternion48(q, &code48[0], n);
+
+        std::vector<float> u[4] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        float* const p[4] = { &u[0][0], &u[1][0], &u[2][0], &u[3][0] };
+        mt::unpackQuaternion32(&code32[0], p, n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            Quaternion q0(v[0][i], v[1][i], v[2][i], v[3][i]);
+            Quaternion q1(u[0][i], u[1][i], u[2][i], u[3][i]);
+            EXPECT_EQ(code32[i], mt::packQuaternion32(q0));
+            EXPECT_EQ(q1, mt::unpackQuaternion32(code32[i]));
+            EXPECT_NEAR(1.0f, lengthSquared(q1), 1e-6f);
+            EXPECT_GE(0.275, rotationAngle(q0, q1));
+        }
+
+        mt::unpackQuaternion48(&code48[0], p, n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            Quaternion q0(v[0][i], v[1][i], v[2][i], v[3][i]);
+            Quaternion q1(u[0][i], u[1][i], u[2][i], u[3][i]);
+            uint16_t code[3];
+            mt::packQuaternion48(q0, code);
+            EXPECT_TRUE(code[0] == code48[3 * i] && code[1] == code48[3 * i + 1] && code[2] == code48[3 * i + 2]);
+            EXPECT_EQ(q1, mt::unpackQuaternion48(code));
+            EXPECT_GE(0.0086, rotationAngle(q0, q1));
+            if (i < 4)
+            {
+                EXPECT_EQ(0.0, rotationAngle(q0, q1));
+            }
+        }
+    }
+
+    // Quantized positions are within half a step of the original, for a range taken from the stream.
+    {
+        const size_t n = 100;
+        std::vector<float> v[3] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        float* const p[3] = { &v[0][0], &v[1][0], &v[2][0] };
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector3 x = random.uniformVector3(-100, 100);
+            for (int k = 0; k != 3; ++k)
+            {
+                v[k][i] = x[k];
+            }
+        }
+        mt::PositionQuantizer quantizer(p, n);
+        Vector3 error = quantizer.maxError();
+
+        std::vector<uint16_t> code(3 * n);
+        quantizer.pack(p, &code[0], n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            Vector3 x(v[0][i], v[1][i], v[2][i]);
+            uint16_t c[3];
+            quantizer.pack(x, c);
+            EXPECT_TRUE(c[0] == code[3 * i] && c[1] == code[3 * i + 1] && c[2] == code[3 * i + 2]);
+            Vector3 y = quantizer.unpack(c);
+            for (int k = 0; k != 3; ++k)
+            {
+                EXPECT_GE(error[k] * 1.01f, mt::abs(x[k] - y[k]));
+            }
+        }
+        Vector3 lower = quantizer.unpack(&code[0]);
+        std::vector<float> w[3] = { std::vector<float>(n), std::vector<float>(n), std::vector<float>(n) };
+        float* const q[3] = { &w[0][0], &w[1][0], &w[2][0] };
+        quantizer.unpack(&code[0], q, n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            EXPECT_EQ(quantizer.unpack(&code[3 * i]), Vector3(w[0][i], w[1][i], w[2][i]));
+        }
+        EXPECT_EQ(lower, Vector3(w[0][0], w[1][0], w[2][0]));
+    }
+
+    // Half floats round-trip exactly for all codes other than NaNs, and the batch forms agree with
+    // the single ones.
+    {
+        EXPECT_EQ(0x3c00, mt::packHalf(1.0f));
+        EXPECT_EQ(0xc000, mt::packHalf(-2.0f));
+        EXPECT_EQ(0x2e66, mt::packHalf(0.1f));
+        EXPECT_EQ(0x7bff, mt::packHalf(65504.0f));
+        EXPECT_EQ(0x7c00, mt::packHalf(65520.0f));
+        EXPECT_EQ(0x0001, mt::packHalf(5.9604645e-8f));
+        EXPECT_EQ(0x0000, mt::packHalf(2.9802322e-8f));
+        EXPECT_EQ(0x7e00, mt::packHalf(std::numeric_limits<float>::quiet_NaN()) & 0x7e00);
+        EXPECT_EQ(65504.0f, mt::unpackHalf(0x7bff));
+        EXPECT_EQ(-std::numeric_limits<float>::infinity(), mt::unpackHalf(0xfc00));
+
+        std::vector<uint16_t> h(0x10000);
+        for (size_t i = 0; i != h.size(); ++i)
+        {
+            h[i] = uint16_t(i);
+        }
+        std::vector<float> x(h.size());
+        mt::unpackHalf(&h[0], &x[0], h.size());
+        std::vector<uint16_t> g(h.size());
+        mt::packHalf(&x[0], &g[0], x.size());
+        for (size_t i = 0; i != h.size(); ++i)
+        {
+            EXPECT_EQ(mt::bitcast<uint32_t>(mt::unpackHalf(h[i])), mt::bitcast<uint32_t>(x[i]));
+            if (!mt::isnan(x[i]))
+            {
+                EXPECT_EQ(h[i], g[i]);
+            }
+        }
+
+        for (size_t i = 0; i != x.size(); ++i)
+        {
+            x[i] = random.uniform(-70000, 70000) * mt::ldexp(1.0f, int(i % 40) - 30);
+        }
+        mt::packHalf(&x[0], &g[0], x.size());
+        for (size_t i = 0; i != x.size(); ++i)
+        {
+            EXPECT_EQ(mt::packHalf(x[i]), g[i]);
+            if (mt::abs(x[i]) >= 6.1035156e-5f && mt::abs(x[i]) <= 65504.0f)
+            {
+                EXPECT_GE(mt::abs(x[i]) * 0.00048828125f, mt::abs(mt::unpackHalf(g[i]) - x[i]));
+            }
+        }
+
+        Vector3 a(1.5f, -0.25f, 1024.0f);
+        uint16_t c[3];
+        mt::packHalf(a, c);
+        Vector3 b;
+        mt::unpackHalf(c, b);
+        EXPECT_EQ(a, b);
+    }
+}